@@ -29,6 +29,9 @@
 /* Define to 1 if you have SDL. */
 #cmakedefine HAVE_SDL 1
 
+/* Define to 1 if you have the sendmmsg and recvmmsg functions. */
+#cmakedefine HAVE_SENDMMSG 1
+
 /* Define to 1 if you have the <share.h> header file. */
 #cmakedefine HAVE_SHARE_H 1
 
@@ -44,6 +47,9 @@
 /* Define to 1 if you have the <sys/inotify.h> header file. */
 #cmakedefine HAVE_SYS_INOTIFY_H 1
 
+/* Define to 1 if you have the <sys/mman.h> header file. */
+#cmakedefine HAVE_SYS_MMAN_H 1
+
 /* Define to 1 if you have the <sys/socket.h> header file. */
 #cmakedefine HAVE_SYS_SOCKET_H 1
 
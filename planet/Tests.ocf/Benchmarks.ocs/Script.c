@@ -67,7 +67,8 @@ global func StartBenchmarks()
 	->Queue(new Scenario_Coconuts{})
 	->Queue(new Scenario_Firestone{})
 	->Queue(new Scenario_Bombs{})
-	->Queue(new Scenario_MixedObjects{});
+	->Queue(new Scenario_MixedObjects{})
+	->Queue(new Scenario_PXS{});
 }
 
 static const BenchmarkScenario = new Global
@@ -161,6 +162,44 @@ static const Run_MixedObjects = new Run_LaunchObjects
 };
 
 
+static const Scenario_PXS = new BenchmarkScenario
+{
+	Description = "Cast loose material (PXS) over the whole landscape",
+	Run = Run_CastPXS,
+};
+
+static const Run_CastPXS = new BenchmarkRun
+{
+	Materials = ["Water", "Sand"],
+	Amount    = 100000, // This amount of PXS is cast in total
+	Duration  = 300,    // Frames until the run is over
+	FPSLimit  = 100000, // A single run only
+
+	OnStart = func (int nr)
+	{
+		this.start_frame = FrameCounter();
+		for (var i = 0; i < this.Amount; ++i)
+		{
+			var mat = Material(this.Materials[i % GetLength(this.Materials)]);
+			var x = Random(LandscapeWidth());
+			var y = Random(LandscapeHeight() / 2);
+			InsertMaterial(mat, x, y, RandomX(-20, 20), RandomX(-20, 0));
+		}
+		Log("Cast %d PXS, %d PXS active", this.Amount, GetPXSCount());
+	},
+
+	IsFinished = func ()
+	{
+		return FrameCounter() - this.start_frame >= this.Duration || !GetPXSCount();
+	},
+
+	OnFinished = func ()
+	{
+		Log("%d PXS still active", GetPXSCount());
+	},
+};
+
+
 /* --- Templates --- */
 
 static const Run_LaunchObjects = new BenchmarkRun
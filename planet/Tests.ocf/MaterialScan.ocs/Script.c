@@ -0,0 +1,35 @@
+/**
+	Material Scan
+	Freezes and melts a large lake to measure the landscape scan, which converts
+	materials by temperature. Set ScanSpeed in Scenario.txt to the number of
+	columns to scan per frame.
+*/
+
+static const SCAN_FRAMES = 200;
+
+static phase_start_time, phase_start_frame;
+
+func Initialize()
+{
+	SetGameSpeed(1000);
+	Log("Landscape %dx%d, water %d", LandscapeWidth(), LandscapeHeight(), GetMaterialCount(Material("Water"), true));
+	Schedule(nil, "StartPhase(-30)", 10);
+	Schedule(nil, "EndPhase(\"Freezing\")", 10 + SCAN_FRAMES);
+	Schedule(nil, "StartPhase(30)", 20 + SCAN_FRAMES);
+	Schedule(nil, "EndPhase(\"Melting\")", 20 + 2 * SCAN_FRAMES);
+	Schedule(nil, "GameOver()", 30 + 2 * SCAN_FRAMES);
+}
+
+global func StartPhase(int temperature)
+{
+	SetTemperature(temperature);
+	phase_start_time = GetTime();
+	phase_start_frame = FrameCounter();
+}
+
+global func EndPhase(string name)
+{
+	var frames = FrameCounter() - phase_start_frame;
+	var time = GetTime() - phase_start_time;
+	Log("%s: %d frames, %d ms, %d us/frame, water %d ice %d", name, frames, time, 1000 * time / frames, GetMaterialCount(Material("Water"), true), GetMaterialCount(Material("Ice"), true));
+}
@@ -68,7 +68,6 @@ class C4LangStringTable;
 class C4LChunk;
 class C4League;
 class C4LoaderScreen;
-class C4LSector;
 class C4LSectors;
 class C4MainMenu;
 class C4MapCreatorS2;
@@ -112,6 +111,7 @@ class C4PXSSystem;
 class C4RankSystem;
 class C4Record;
 class C4Rect;
+class C4ReplayStats;
 class C4RoundResult;
 class C4RoundResults;
 class C4Scenario;
@@ -25,6 +25,7 @@
 #include "c4group/C4Components.h"
 #include "lib/C4InputValidation.h"
 #include <zlib.h>
+#include <unordered_map>
 
 
 //------------------------------ File Sort Lists -------------------------------------------
@@ -547,6 +548,21 @@ void MemScramble(BYTE *buffer, int size)
 	}
 }
 
+bool C4Group_IsIndexedGroupFile(const char *filename)
+{
+	// Indexed group files are not compressed as a whole, so the header can be checked directly
+	CStdFile file;
+	C4GroupHeader header;
+	if (!file.Open(filename, false) || !file.Read(&header, sizeof(C4GroupHeader)))
+	{
+		return false;
+	}
+	MemScramble((BYTE*)&header, sizeof(C4GroupHeader));
+	return SEqual(header.Id, C4GroupFileID)
+	    && header.Ver1 == C4GroupFileVer1
+	    && header.Ver2 == C4GroupFileVer2Indexed;
+}
+
 //---------------------------------- C4Group ---------------------------------------------
 
 struct C4Group::P
@@ -576,8 +592,17 @@ struct C4Group::P
 	int EntryOffset = 0;
 	bool Modified = false;
 	C4GroupEntry *FirstEntry = nullptr;
+	C4GroupEntry *LastEntry = nullptr;
+	std::unordered_map<std::string, C4GroupEntry *> EntryIndex; // lower case names of all entries not deleted
 	BYTE *pInMemEntry = nullptr;
 	size_t iInMemEntrySize = 0; // for reading from entries prefetched into memory
+	// Indexed groups
+	C4GroupFormat Format = C4GF_Stream; // format of the opened file
+	C4GroupFormat SaveFormat = C4GF_Stream;
+	int IndexBase = 0; // position of this group in the outermost group file
+	StdCopyBuf IndexedEntry; // data of the last accessed entry
+	// Read-only file mappings backing views returned by LoadEntryView, by file path
+	std::unordered_map<std::string, std::shared_ptr<CStdFileMapping>> Mappings;
 #ifdef _DEBUG
 	StdStrBuf sPrevAccessedEntry;
 #endif
@@ -591,6 +616,13 @@ struct C4Group::P
 	std::string ErrorString;
 
 	bool NoSort = false; // If this flag is set, all entries will be marked NoSort in AddEntry
+
+	static std::string IndexKey(const char *entry_name)
+	{
+		std::string key(entry_name);
+		for (char &c : key) c = tolower(static_cast<unsigned char>(c));
+		return key;
+	}
 };
 
 C4GroupEntry::~C4GroupEntry()
@@ -773,6 +805,11 @@ bool C4Group::OpenRealGrpFile()
 	// Open StdFile
 	if (!p->StdFile.Open(GetName(), true))
 	{
+		// Indexed group files are not compressed as a whole
+		if (C4Group_IsIndexedGroupFile(GetName()) && p->StdFile.Open(GetName(), false))
+		{
+			return OpenIndexed();
+		}
 		return Error("OpenRealGrpFile: Cannot open standard file");
 	}
 
@@ -825,6 +862,142 @@ bool C4Group::OpenRealGrpFile()
 	return true;
 }
 
+bool C4Group::OpenIndexed()
+{
+	// Read header
+	if (!ReadIndexed(0, &Head, sizeof(C4GroupHeader)))
+	{
+		return Error("OpenIndexed: Error reading header");
+	}
+	MemScramble((BYTE*)&Head, sizeof(C4GroupHeader));
+
+	// Check Header
+	if (!SEqual(Head.Id, C4GroupFileID)
+	|| (Head.Ver1 != C4GroupFileVer1)
+	|| (Head.Ver2 != C4GroupFileVer2Indexed)
+	|| (Head.Entries < 0))
+	{
+		return Error("OpenIndexed: Invalid header");
+	}
+
+	// Read directory
+	int file_entries = Head.Entries;
+	Head.Entries = 0; // Reset, will be recounted by AddEntry
+	std::vector<C4GroupIndexEntry> directory(file_entries);
+	if (!ReadIndexed(sizeof(C4GroupHeader), directory.data(), file_entries * sizeof(C4GroupIndexEntry)))
+	{
+		return Error("OpenIndexed: Error reading directory");
+	}
+	int data_start = sizeof(C4GroupHeader) + file_entries * sizeof(C4GroupIndexEntry);
+	for (C4GroupIndexEntry &index_entry : directory)
+	{
+		C4GroupEntryCore &core = index_entry.Core;
+		if (core.Offset < data_start || core.Size < 0 || index_entry.StoredSize < 0
+		|| (!core.Packed && index_entry.StoredSize != core.Size))
+		{
+			return Error("OpenIndexed: Invalid directory entry");
+		}
+		core.FileName[sizeof(core.FileName) - 1] = '\0';
+		StdStrBuf entryname(core.FileName);
+		entryname.EnsureUnicode();
+		C4InVal::ValidateFilename(const_cast<char *>(entryname.getData()),entryname.getLength());
+		if (!AddEntry(C4GroupEntry::C4GRES_InGroup,
+		              !!core.ChildGroup,
+		              core.FileName,
+		              core.Size,
+		              entryname.getData(),
+		              nullptr,
+		              false,
+		              false,
+		              !!core.Executable))
+		{
+			return Error("OpenIndexed: Cannot add entry");
+		}
+		C4GroupEntry *entry = p->LastEntry;
+		entry->Offset = core.Offset;
+		entry->Packed = core.Packed;
+		entry->StoredSize = index_entry.StoredSize;
+		entry->StoredCRC = index_entry.CRC;
+	}
+
+	p->Format = p->SaveFormat = C4GF_Indexed;
+	return true;
+}
+
+bool C4Group::ReadIndexed(int offset, void *buffer, size_t size)
+{
+	if (!size)
+	{
+		return true;
+	}
+	// Child groups of indexed groups are read from the file of the outermost group
+	C4Group *root = this;
+	while (root->p->Mother && root->p->Mother->p->SourceType == P::ST_Packed)
+	{
+		root = root->p->Mother;
+	}
+	CStdFile &file = root->p->StdFile;
+	if (file.Seek(p->IndexBase + offset, SEEK_SET) != 0 || !file.Read(buffer, size))
+	{
+		return Error("ReadIndexed: Cannot read from group file");
+	}
+	return true;
+}
+
+bool C4Group::LoadIndexedEntry(C4GroupEntry *entry)
+{
+	StdBuf &data = p->IndexedEntry;
+	p->pInMemEntry = nullptr;
+	data.New(entry->Size);
+	if (entry->Packed)
+	{
+		StdBuf stored;
+		stored.New(entry->StoredSize);
+		if (!ReadIndexed(entry->Offset, stored.getMData(), stored.getSize()))
+		{
+			return false;
+		}
+		uLongf size = data.getSize();
+		if (uncompress(static_cast<Bytef *>(data.getMData()), &size, static_cast<const Bytef *>(stored.getData()), stored.getSize()) != Z_OK
+		|| size != data.getSize())
+		{
+			return Error("LoadIndexedEntry: Corrupt entry data");
+		}
+	}
+	else if (!ReadIndexed(entry->Offset, data.getMData(), data.getSize()))
+	{
+		return false;
+	}
+	if (crc32(0, static_cast<const Bytef *>(data.getData()), data.getSize()) != entry->StoredCRC)
+	{
+		return Error("LoadIndexedEntry: CRC mismatch");
+	}
+	// Serve reads from memory
+	p->pInMemEntry = static_cast<BYTE *>(data.getMData());
+	p->iInMemEntrySize = data.getSize();
+	return true;
+}
+
+bool C4Group::CopyIndexed(int offset, int size, CStdFile &target)
+{
+	BYTE buffer[16 * 1024];
+	while (size > 0)
+	{
+		int chunk = std::min<int>(size, sizeof(buffer));
+		if (!ReadIndexed(offset, buffer, chunk))
+		{
+			return false;
+		}
+		if (!target.Write(buffer, chunk))
+		{
+			return Error("CopyIndexed: Cannot write to target file");
+		}
+		offset += chunk;
+		size -= chunk;
+	}
+	return true;
+}
+
 bool C4Group::AddEntry(C4GroupEntry::EntryStatus status,
                        bool add_as_child,
                        const char *filename,
@@ -915,8 +1088,8 @@ bool C4Group::AddEntry(C4GroupEntry::EntryStatus status,
 	// Allocate memory for new entry
 	next = new C4GroupEntry;
 
-	// Find end of list
-	for (last = p->FirstEntry; last && last->Next; last = last->Next) {}
+	// End of list
+	last = p->LastEntry;
 
 	// Init entry core data
 	if (entry_name) SCopy(entry_name, next->FileName, _MAX_FNAME);
@@ -944,6 +1117,8 @@ bool C4Group::AddEntry(C4GroupEntry::EntryStatus status,
 	// Append entry to list
 	if (last) last->Next = next;
 	else p->FirstEntry = next;
+	p->LastEntry = next;
+	p->EntryIndex[P::IndexKey(next->FileName)] = next;
 
 	// Increase virtual file count of group
 	Head.Entries++;
@@ -957,6 +1132,12 @@ C4GroupEntry* C4Group::GetEntry(const char *entry_name)
 	{
 		return nullptr;
 	}
+	// Plain names are looked up in the index
+	if (!IsWildcardString(entry_name))
+	{
+		auto found = p->EntryIndex.find(P::IndexKey(entry_name));
+		return found != p->EntryIndex.end() ? found->second : nullptr;
+	}
 	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
 	{
 		if (entry->Status != C4GroupEntry::C4GRES_Deleted
@@ -1033,24 +1214,27 @@ bool C4Group::Save(bool reopen)
 	char temp_filename[_MAX_FNAME+1];
 	char group_filename[_MAX_FNAME+1];
 
-	// Create temporary core list with new actual offsets to be saved
+	// The group file is about to be replaced
+	p->Mappings.clear();
+
+	// Child groups must be stored in the format of this group
+	if (!ConvertChildEntries())
+	{
+		return false;
+	}
+	bool indexed = (p->SaveFormat == C4GF_Indexed);
+
 	int32_t contents_size = 0;
-	C4GroupEntryCore *save_core = new C4GroupEntryCore[Head.Entries];
-	int core_index = 0;
 	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
 	{
 		if (entry->Status != C4GroupEntry::C4GRES_Deleted)
 		{
-			save_core[core_index]=(C4GroupEntryCore)*entry;
-			// Make actual offset
-			save_core[core_index].Offset = contents_size;
 			contents_size += entry->Size;
-			core_index++;
 		}
 	}
 
 	// Hold contents in memory?
-	bool hold_in_memory = !reopen && p->Mother && contents_size < C4GroupSwapThreshold;
+	bool hold_in_memory = !indexed && !reopen && p->Mother && contents_size < C4GroupSwapThreshold;
 	if (!hold_in_memory)
 	{
 		// Create target temp file (in temp directory!)
@@ -1073,48 +1257,18 @@ bool C4Group::Save(bool reopen)
 		}
 	}
 
-	// Create the new (temp) group file
+	// Create the new (temp) group file (indexed groups are not compressed as a whole)
 	CStdFile temp_file;
-	if (!temp_file.Create(temp_filename, true, false, hold_in_memory))
+	if (!temp_file.Create(temp_filename, !indexed, false, hold_in_memory))
 	{
-		delete [] save_core;
 		return Error("Close: ...");
 	}
 
-	// Save header and core list
-	C4GroupHeader header_buffer = Head;
-	MemScramble((BYTE*)&header_buffer, sizeof(C4GroupHeader));
-	if (!temp_file.Write((BYTE*)&header_buffer, sizeof(C4GroupHeader))
-	 || !temp_file.Write((BYTE*)save_core, Head.Entries*sizeof(C4GroupEntryCore)))
+	// Save header, entry list and entries
+	if (!(indexed ? WriteIndexed(temp_file) : WriteStream(temp_file)))
 	{
 		temp_file.Close();
-		delete [] save_core;
-		return Error("Close: ...");
-	}
-	delete [] save_core;
-
-	// Save Entries to temp file
-	int total_size = 0;
-	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
-	{
-		total_size += entry->Size;
-	}
-	int size_done = 0;
-	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
-	{
-		if (AppendEntry2StdFile(entry, temp_file))
-		{
-			size_done += entry->Size;
-			if (total_size && p->ProcessCallback)
-			{
-				p->ProcessCallback(entry->FileName, 100 * size_done / total_size);
-			}
-		}
-		else
-		{
-			temp_file.Close();
-			return false;
-		}
+		return false;
 	}
 
 	// Write
@@ -1170,6 +1324,301 @@ bool C4Group::Save(bool reopen)
 	return true;
 }
 
+bool C4Group::WriteStream(CStdFile &target)
+{
+	// Create temporary core list with new actual offsets to be saved
+	int32_t contents_size = 0;
+	C4GroupEntryCore *save_core = new C4GroupEntryCore[Head.Entries];
+	int core_index = 0;
+	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
+	{
+		if (entry->Status != C4GroupEntry::C4GRES_Deleted)
+		{
+			save_core[core_index]=(C4GroupEntryCore)*entry;
+			// Make actual offset
+			save_core[core_index].Offset = contents_size;
+			save_core[core_index].Packed = false;
+			contents_size += entry->Size;
+			core_index++;
+		}
+	}
+
+	// Save header and core list
+	C4GroupHeader header_buffer = Head;
+	header_buffer.Ver2 = std::min(header_buffer.Ver2, C4GroupFileVer2);
+	MemScramble((BYTE*)&header_buffer, sizeof(C4GroupHeader));
+	if (!target.Write((BYTE*)&header_buffer, sizeof(C4GroupHeader))
+	 || !target.Write((BYTE*)save_core, Head.Entries*sizeof(C4GroupEntryCore)))
+	{
+		delete [] save_core;
+		return Error("Close: ...");
+	}
+	delete [] save_core;
+
+	// Save Entries to temp file
+	int total_size = 0;
+	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
+	{
+		total_size += entry->Size;
+	}
+	int size_done = 0;
+	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
+	{
+		if (!AppendEntry2StdFile(entry, target))
+		{
+			return false;
+		}
+		size_done += entry->Size;
+		if (total_size && p->ProcessCallback)
+		{
+			p->ProcessCallback(entry->FileName, 100 * size_done / total_size);
+		}
+	}
+	return true;
+}
+
+bool C4Group::WriteIndexed(CStdFile &target)
+{
+	// Save header and reserve space for the directory. It is written
+	// after the entries when stored sizes and offsets are known.
+	std::vector<C4GroupIndexEntry> directory(Head.Entries);
+	C4GroupHeader header_buffer = Head;
+	header_buffer.Ver1 = C4GroupFileVer1;
+	header_buffer.Ver2 = C4GroupFileVer2Indexed;
+	MemScramble((BYTE*)&header_buffer, sizeof(C4GroupHeader));
+	if (!target.Write((BYTE*)&header_buffer, sizeof(C4GroupHeader))
+	 || (!directory.empty() && !target.Write((BYTE*)directory.data(), directory.size() * sizeof(C4GroupIndexEntry))))
+	{
+		return Error("Close: ...");
+	}
+
+	// Save Entries to temp file
+	int total_size = 0;
+	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
+	{
+		total_size += entry->Size;
+	}
+	int size_done = 0;
+	int offset = sizeof(C4GroupHeader) + directory.size() * sizeof(C4GroupIndexEntry);
+	size_t index = 0;
+	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
+	{
+		if (entry->Status == C4GroupEntry::C4GRES_Deleted)
+		{
+			continue;
+		}
+		assert(index < directory.size());
+		C4GroupIndexEntry &index_entry = directory[index++];
+		if (!AppendEntry2Indexed(entry, target, index_entry))
+		{
+			return false;
+		}
+		index_entry.Core.Offset = offset;
+		offset += index_entry.StoredSize;
+		size_done += entry->Size;
+		if (total_size && p->ProcessCallback)
+		{
+			p->ProcessCallback(entry->FileName, 100 * size_done / total_size);
+		}
+	}
+
+	// Write directory
+	if (directory.empty())
+	{
+		return true;
+	}
+	if (target.Seek(sizeof(C4GroupHeader), SEEK_SET) != 0
+	 || !target.Write((BYTE*)directory.data(), directory.size() * sizeof(C4GroupIndexEntry)))
+	{
+		return Error("Close: Cannot write group directory");
+	}
+	return true;
+}
+
+bool C4Group::AppendEntry2Indexed(C4GroupEntry *entry, CStdFile &target, C4GroupIndexEntry &index_entry)
+{
+	index_entry.Core = (C4GroupEntryCore)*entry;
+
+	// Entries of indexed groups are copied as stored
+	if (entry->Status == C4GroupEntry::C4GRES_InGroup && p->Format == C4GF_Indexed)
+	{
+		index_entry.StoredSize = entry->StoredSize;
+		index_entry.CRC = entry->StoredCRC;
+		return CopyIndexed(entry->Offset, entry->StoredSize, target);
+	}
+
+	// Get entry data
+	StdBuf data;
+	switch (entry->Status)
+	{
+	case C4GroupEntry::C4GRES_InGroup:
+		if (!SetFilePtr2Entry(entry->FileName))
+		{
+			return Error("AE2I: Cannot set file pointer");
+		}
+		data.New(entry->Size);
+		if (entry->Size && !Read(data.getMData(), data.getSize()))
+		{
+			return Error("AE2I: Cannot read entry from group file");
+		}
+		break;
+	case C4GroupEntry::C4GRES_OnDisk:
+		if (DirectoryExists(entry->DiskPath))
+		{
+			return Error("AE2I: Cannot add directory to group file");
+		}
+		if (!data.LoadFromFile(entry->DiskPath))
+		{
+			return Error("AE2I: Cannot read on-disk file");
+		}
+		break;
+	case C4GroupEntry::C4GRES_InMemory:
+		if (!entry->MemoryBuffer)
+		{
+			return Error("AE2I: no buffer");
+		}
+		data.Ref(entry->MemoryBuffer, entry->Size);
+		break;
+	default:
+		return Error("AE2I: Unknown file status");
+	}
+	index_entry.Core.Size = data.getSize();
+	index_entry.CRC = crc32(0, static_cast<const Bytef *>(data.getData()), data.getSize());
+
+	// Compress files if that saves space. Child groups are always stored, so their entries can be seeked to.
+	StdBuf packed;
+	uLongf packed_size = compressBound(data.getSize());
+	packed.New(packed_size);
+	if (!entry->ChildGroup && data.getSize()
+	 && compress2(static_cast<Bytef *>(packed.getMData()), &packed_size, static_cast<const Bytef *>(data.getData()), data.getSize(), Z_BEST_SPEED) == Z_OK
+	 && packed_size < data.getSize())
+	{
+		index_entry.Core.Packed = true;
+		index_entry.StoredSize = packed_size;
+		if (!target.Write(packed.getData(), packed_size))
+		{
+			return Error("AE2I: Cannot write to target file");
+		}
+	}
+	else
+	{
+		index_entry.Core.Packed = false;
+		index_entry.StoredSize = data.getSize();
+		if (data.getSize() && !target.Write(data.getData(), data.getSize()))
+		{
+			return Error("AE2I: Cannot write to target file");
+		}
+	}
+
+	// Erase disk source if requested
+	if (entry->Status == C4GroupEntry::C4GRES_OnDisk && entry->DeleteOnDisk)
+	{
+		EraseItem(entry->DiskPath);
+	}
+	return true;
+}
+
+bool C4Group::IsIndexedChild(C4GroupEntry *entry)
+{
+	switch (entry->Status)
+	{
+	case C4GroupEntry::C4GRES_InGroup: return p->Format == C4GF_Indexed;
+	case C4GroupEntry::C4GRES_OnDisk: return C4Group_IsIndexedGroupFile(entry->DiskPath);
+	default: return false; // child groups held in memory are always stream groups
+	}
+}
+
+bool C4Group::ConvertChildEntries()
+{
+	for (C4GroupEntry *entry = p->FirstEntry; entry; entry = entry->Next)
+	{
+		if (!entry->ChildGroup || entry->Status == C4GroupEntry::C4GRES_Deleted)
+		{
+			continue;
+		}
+		if (IsIndexedChild(entry) == (p->SaveFormat == C4GF_Indexed))
+		{
+			continue;
+		}
+
+		// Put a copy of the child group into a temp file
+		char temp_filename[_MAX_PATH_LEN];
+		if (C4Group_TempPath[0])
+		{
+			SCopy(C4Group_TempPath, temp_filename, _MAX_PATH);
+			SAppend(entry->FileName, temp_filename, _MAX_PATH);
+		}
+		else
+		{
+			const C4Group *root = this;
+			while (root->p->Mother) root = root->p->Mother;
+			SCopy(root->GetName(), temp_filename, _MAX_PATH);
+		}
+		MakeTempFilename(temp_filename);
+		bool okay = false;
+		switch (entry->Status)
+		{
+		case C4GroupEntry::C4GRES_InGroup:
+			okay = ExtractEntry(entry->FileName, temp_filename);
+			break;
+		case C4GroupEntry::C4GRES_OnDisk:
+			okay = CopyItem(entry->DiskPath, temp_filename);
+			break;
+		case C4GroupEntry::C4GRES_InMemory:
+		{
+			CStdFile file;
+			okay = file.Create(temp_filename, true) && file.Write(entry->MemoryBuffer, entry->Size) && file.Close();
+			break;
+		}
+		default: break;
+		}
+		if (!okay)
+		{
+			EraseItem(temp_filename);
+			return Error("ConvertChildEntries: Cannot copy child group");
+		}
+
+		// Rewrite it in the new format
+		C4Group child;
+		if (!child.Open(temp_filename))
+		{
+			EraseItem(temp_filename);
+			return Error("ConvertChildEntries: Cannot open child group");
+		}
+		child.SetFormat(p->SaveFormat);
+		if (!entry->NoSort)
+		{
+			child.SortByList(C4Group_SortList, entry->FileName);
+		}
+		if (!child.Save(false))
+		{
+			EraseItem(temp_filename);
+			return Error(FormatString("ConvertChildEntries: %s", child.GetError()).getData());
+		}
+
+		// Add the converted child instead
+		if (entry->Status == C4GroupEntry::C4GRES_OnDisk && entry->DeleteOnDisk)
+		{
+			EraseItem(entry->DiskPath);
+		}
+		if (entry->HoldBuffer && entry->MemoryBuffer)
+		{
+			if (entry->BufferIsStdbuf)
+				StdBuf::DeletePointer(entry->MemoryBuffer);
+			else
+				delete [] entry->MemoryBuffer;
+		}
+		entry->MemoryBuffer = nullptr;
+		entry->HoldBuffer = false;
+		SCopy(temp_filename, entry->DiskPath, _MAX_PATH);
+		entry->Status = C4GroupEntry::C4GRES_OnDisk;
+		entry->DeleteOnDisk = true;
+		entry->NoSort = true;
+		entry->Size = (p->SaveFormat == C4GF_Indexed) ? FileSize(temp_filename) : UncompressedFileSize(temp_filename);
+	}
+	return true;
+}
+
 void C4Group::Clear()
 {
 	if (p)
@@ -1204,6 +1653,23 @@ bool C4Group::AppendEntry2StdFile(C4GroupEntry *entry, CStdFile &target)
 	{
 
 	case C4GroupEntry::C4GRES_InGroup: // Copy from group to std file
+		// Indexed group: copy child groups as stored, unpack files
+		if (p->Format == C4GF_Indexed)
+		{
+			if (entry->ChildGroup)
+			{
+				if (!CopyIndexed(entry->Offset, entry->Size, target))
+				{
+					return false;
+				}
+			}
+			else if (!LoadIndexedEntry(entry)
+			     || (entry->Size && !target.Write(p->IndexedEntry.getData(), entry->Size)))
+			{
+				return Error("AE2S: Cannot copy entry from indexed group file");
+			}
+			break;
+		}
 		if (!SetFilePtr(entry->Offset))
 			return Error("AE2S: Cannot set file pointer");
 		for (long current_size = entry->Size; current_size > 0; current_size--)
@@ -1259,7 +1725,7 @@ bool C4Group::AppendEntry2StdFile(C4GroupEntry *entry, CStdFile &target)
 		}
 
 		// Append disk source to target file
-		if (!source.Open(file_source, !!entry->ChildGroup))
+		if (!source.Open(file_source, entry->ChildGroup && !C4Group_IsIndexedGroupFile(file_source)))
 		{
 			return Error("AE2S: Cannot open on-disk file");
 		}
@@ -1442,6 +1908,12 @@ bool C4Group::Read(void *buffer, size_t size)
 	switch (p->SourceType)
 	{
 	case P::ST_Packed:
+		// Indexed group: entries are only read from memory
+		if (p->Format == C4GF_Indexed)
+		{
+			if (size) return Error("Read: No entry accessed");
+			break;
+		}
 		// Child group: read from mother group
 		if (p->Mother)
 		{
@@ -1597,7 +2069,7 @@ bool C4Group::AddEntryOnDisk(const char *filename,
 
 	// Determine size
 	bool fIsGroup = !!C4Group_IsGroup(filename);
-	int size = fIsGroup ? UncompressedFileSize(filename) : FileSize(filename);
+	int size = (fIsGroup && !C4Group_IsIndexedGroupFile(filename)) ? UncompressedFileSize(filename) : FileSize(filename);
 
 	// Determine executable bit (linux only)
 	bool is_executable = false;
@@ -1709,6 +2181,7 @@ bool C4Group::DeleteEntry(const char *filename, bool do_recycle)
 		// (moved buffers are deleted by ~C4GroupEntry)
 		// Delete status and update virtual file count
 		pEntry->Status = C4GroupEntry::C4GRES_Deleted;
+		p->EntryIndex.erase(P::IndexKey(pEntry->FileName));
 		Head.Entries--;
 		break;
 	case P::ST_Unpacked:
@@ -1755,7 +2228,9 @@ bool C4Group::Rename(const char *filename, const char *new_name)
 			return Error("Rename: File exists already");
 		}
 		// Rename
+		p->EntryIndex.erase(P::IndexKey(pEntry->FileName));
 		SCopy(new_name, pEntry->FileName, _MAX_FNAME);
+		p->EntryIndex[P::IndexKey(pEntry->FileName)] = pEntry;
 		p->Modified = true;
 		break;
 	case P::ST_Unpacked:
@@ -1909,7 +2384,7 @@ bool C4Group::ExtractEntry(const char *filename, const char *destination)
 		SCopy(target_file_name, temp_file_name, _MAX_FNAME);
 		MakeTempFilename(temp_file_name);
 		// Create temp target file
-		if (!temp_file.Create(temp_file_name, !!entry->ChildGroup, !!entry->Executable))
+		if (!temp_file.Create(temp_file_name, entry->ChildGroup && !IsIndexedChild(entry), !!entry->Executable))
 		{
 			return Error("Extract: Cannot create target file");
 		}
@@ -1996,6 +2471,21 @@ bool C4Group::OpenAsChild(C4Group *mother, const char *entry_name, bool is_exclu
 		return true;
 	}
 
+	// Indexed group file in folder: read from its own file
+	if (p->Mother->p->SourceType == P::ST_Unpacked && C4Group_IsIndexedGroupFile(path))
+	{
+		if (!p->StdFile.Open(path, false) || !OpenIndexed())
+		{
+			std::string error = p->ErrorString;
+			CloseExclusiveMother();
+			Clear();
+			return Error(error.empty() ? "OpenAsChild: Cannot open indexed group file" : error.c_str());
+		}
+		p->SourceType = P::ST_Packed;
+		ResetSearch();
+		return true;
+	}
+
 	// Get original entry name
 	C4GroupEntry *centry;
 	if ((centry = p->Mother->GetEntry(GetName())))
@@ -2003,6 +2493,43 @@ bool C4Group::OpenAsChild(C4Group *mother, const char *entry_name, bool is_exclu
 		p->FileName = centry->FileName;
 	}
 
+	// Child of indexed group: read directory from the stored child group
+	if (p->Mother->p->SourceType == P::ST_Packed && p->Mother->p->Format == C4GF_Indexed)
+	{
+		if (!centry || centry->Status != C4GroupEntry::C4GRES_InGroup)
+		{
+			if (!do_create)
+			{
+				CloseExclusiveMother();
+				Clear();
+				return Error("OpenAsChild: Entry not in mother group");
+			}
+			// Create - will be added to mother in Close()
+			p->SourceType = P::ST_Packed;
+			p->SaveFormat = p->Mother->p->SaveFormat;
+			p->Modified = true;
+			return true;
+		}
+		if (!centry->ChildGroup)
+		{
+			CloseExclusiveMother();
+			Clear();
+			return Error("OpenAsChild: Is not a child group");
+		}
+		p->IndexBase = p->Mother->p->IndexBase + centry->Offset;
+		if (!OpenIndexed())
+		{
+			std::string error = p->ErrorString;
+			CloseExclusiveMother();
+			Clear();
+			return Error(error.c_str());
+		}
+		p->SourceType = P::ST_Packed;
+		p->MotherOffset = centry->Offset;
+		ResetSearch();
+		return true;
+	}
+
 	// Access entry in mother group
 	size_t size;
 	if ((!p->Mother->AccessEntry(GetName(), &size, nullptr, true)))
@@ -2017,6 +2544,7 @@ bool C4Group::OpenAsChild(C4Group *mother, const char *entry_name, bool is_exclu
 		{
 			// Create - will be added to mother in Close()
 			p->SourceType = P::ST_Packed;
+			p->SaveFormat = p->Mother->p->SaveFormat;
 			p->Modified = true;
 			return true;
 		}
@@ -2193,6 +2721,11 @@ bool C4Group::SetFilePtr2Entry(const char *entry_name, bool needs_to_be_a_group)
 		{
 			return false;
 		}
+		// Indexed group: load the whole entry with a single seek
+		if (p->Format == C4GF_Indexed)
+		{
+			return LoadIndexedEntry(entry);
+		}
 		return SetFilePtr(entry->Offset);
 
 	case P::ST_Unpacked:
@@ -2427,6 +2960,91 @@ bool C4Group::LoadEntry(const char *entry_name, StdBuf * buffer)
 	return true;
 }
 
+bool C4Group::LoadEntryView(const char *entry_name, StdBuf * buffer)
+{
+	StdStrBuf fname;
+	size_t size;
+	if (!FindEntry(entry_name, &fname, &size))
+	{
+		return Error("LoadEntry: Not found");
+	}
+	C4GroupEntry *entry = GetEntry(fname.getData());
+	// Precached entries can be referenced directly
+	if (entry && entry->MemoryBuffer)
+	{
+		buffer->Ref(entry->MemoryBuffer, entry->Size);
+		return true;
+	}
+	// Large entries that are stored uncompressed on disk are mapped
+	if (size >= C4GroupMapThreshold)
+	{
+		if (const BYTE *data = MapEntry(fname.getData(), entry))
+		{
+			buffer->Ref(data, size);
+			return true;
+		}
+	}
+	return LoadEntry(fname.getData(), buffer);
+}
+
+const BYTE *C4Group::MapEntry(const char *entry_name, C4GroupEntry *entry)
+{
+	// Find the file the entry is stored in and its position there
+	C4Group *owner = this;
+	std::string path;
+	size_t offset = 0, size;
+	if (p->SourceType == P::ST_Unpacked)
+	{
+		path = GetName();
+		path += DirectorySeparator;
+		path += entry_name;
+		if (DirectoryExists(path.c_str()))
+		{
+			return nullptr;
+		}
+		size = FileSize(path.c_str());
+	}
+	else if (p->SourceType == P::ST_Packed && p->Format == C4GF_Indexed
+	     &&  entry && entry->Status == C4GroupEntry::C4GRES_InGroup && !entry->Packed && !entry->ChildGroup)
+	{
+		// Child groups share the mapping of the outermost group file
+		while (owner->p->Mother && owner->p->Mother->p->SourceType == P::ST_Packed)
+		{
+			owner = owner->p->Mother;
+		}
+		path = owner->p->StdFile.Name;
+		offset = p->IndexBase + entry->Offset;
+		size = entry->Size;
+	}
+	else
+	{
+		return nullptr;
+	}
+	// Reuse or create the mapping
+	std::shared_ptr<CStdFileMapping> &mapping = p->Mappings[path];
+	if (!mapping)
+	{
+		std::shared_ptr<CStdFileMapping> &shared = owner->p->Mappings[path];
+		if (!shared)
+		{
+			shared = std::make_shared<CStdFileMapping>();
+			shared->Open(path.c_str());
+		}
+		mapping = shared;
+	}
+	if (!mapping->IsOpen() || offset + size > mapping->getSize())
+	{
+		return nullptr;
+	}
+	const BYTE *data = mapping->getData() + offset;
+	if (entry && p->Format == C4GF_Indexed && crc32(0, data, size) != entry->StoredCRC)
+	{
+		Error("LoadEntry: CRC mismatch");
+		return nullptr;
+	}
+	return data;
+}
+
 bool C4Group::LoadEntryString(const char *entry_name, StdStrBuf *buffer)
 {
 	size_t size;
@@ -2530,6 +3148,9 @@ bool C4Group::Sort(const char *list)
 	}
 	while (bubble);
 
+	// Update end of list
+	for (p->LastEntry = p->FirstEntry; p->LastEntry && p->LastEntry->Next; p->LastEntry = p->LastEntry->Next) {}
+
 	return true;
 }
 
@@ -2551,6 +3172,23 @@ bool C4Group::HasPackedMother() const
 
 bool C4Group::SetNoSort(bool no_sorting) { p->NoSort = no_sorting; return true; }
 
+bool C4Group::SetFormat(C4GroupFormat format)
+{
+	// Folders are not affected
+	if (p->SourceType != P::ST_Packed)
+	{
+		return false;
+	}
+	if (p->SaveFormat != format)
+	{
+		p->SaveFormat = format;
+		p->Modified = true;
+	}
+	return true;
+}
+
+C4GroupFormat C4Group::GetFormat() const { return p->SaveFormat; }
+
 bool C4Group::CloseExclusiveMother()
 {
 	if (p->Mother && p->ExclusiveChild)
@@ -2842,7 +3480,7 @@ int C4Group::PreCacheEntries(const char *search_pattern, bool cache_previous)
 		}
 		// if desired, cache all entries up to that one to allow rewind in unpacked memory
 		// (only makes sense for groups)
-		if (cache_previous && p->SourceType == P::ST_Packed)
+		if (cache_previous && p->SourceType == P::ST_Packed && p->Format == C4GF_Stream)
 		{
 			for (C4GroupEntry * e_pre = p->FirstEntry; e_pre != entry; e_pre = e_pre->Next)
 			{
@@ -26,8 +26,7 @@
 #include "c4group/CStdFile.h"
 
 // C4Group-Rewind-warning:
-// The current C4Group-implementation cannot handle random file access very well,
-// because all files are written within a single zlib-stream.
+// Stream groups (the classic format) are written within a single zlib-stream.
 // For every out-of-order-file accessed a group-rewind must be performed, and every
 // single file up to the accessed file unpacked. As a workaround, all C4Groups are
 // packed in a file order matching the reading order of the engine.
@@ -41,8 +40,10 @@
 // sort order lists in C4Components.h accordingly, and enforce a reading order for that
 // component.
 //
-// Maybe some day, someone will write a C4Group-implementation that is probably capable of
-// random access...
+// Indexed groups (C4GroupFileVer2Indexed) are not compressed as a whole. They store a
+// directory with offset, size and CRC of every entry right behind the header, and each
+// entry is compressed on its own. Child groups are stored uncompressed and indexed as
+// well, so any entry can be read with a single seek and never needs a rewind.
 #ifdef _DEBUG
 extern int iC4GroupRewindFilePtrNoWarn;
 #define C4GRP_DISABLE_REWINDWARN ++iC4GroupRewindFilePtrNoWarn;
@@ -54,10 +55,18 @@ extern int iC4GroupRewindFilePtrNoWarn;
 
 const int C4GroupFileVer1 = 1;
 const int C4GroupFileVer2 = 2;
+const int C4GroupFileVer2Indexed = 3;
+
+enum C4GroupFormat
+{
+	C4GF_Stream,  // single zlib stream; entries must be read in order
+	C4GF_Indexed  // central directory and separately compressed entries
+};
 
 const int C4GroupMaxError = 100;
 
 const int32_t C4GroupSwapThreshold = 10 * 1024 * 1024;
+const int32_t C4GroupMapThreshold = 64 * 1024; // minimum entry size for LoadEntryView to map instead of copy
 
 #define C4GroupFileID "RedWolf Design GrpFolder"
 
@@ -67,6 +76,7 @@ const char* C4Group_GetTempPath();
 void C4Group_SetSortList(const char **sort_list);
 void C4Group_SetProcessCallback(bool (*callback)(const char *, int));
 bool C4Group_IsGroup(const char *filename);
+bool C4Group_IsIndexedGroupFile(const char *filename);
 bool C4Group_CopyItem(const char *source, const char *target, bool no_sorting = false, bool reset_attributes = false);
 bool C4Group_MoveItem(const char *source, const char *target, bool no_sorting = false);
 bool C4Group_DeleteItem(const char *item_name, bool do_recycle = false);
@@ -104,6 +114,15 @@ struct C4GroupEntryCore
 	BYTE Buffer[26] = { 0 };
 };
 
+// Directory entry of indexed groups. Core.Packed marks zlib compressed entries.
+struct C4GroupIndexEntry
+{
+	C4GroupEntryCore Core;
+	int32_t StoredSize = 0; // size in the group file
+	uint32_t CRC = 0; // of the uncompressed data
+	int32_t Reserved[2] = { 0 };
+};
+
 #pragma pack (pop)
 
 class C4GroupEntry: public C4GroupEntryCore
@@ -126,6 +145,8 @@ public:
 	bool HoldBuffer = false;
 	bool BufferIsStdbuf = false;
 	bool NoSort = false;
+	int32_t StoredSize = 0; // indexed groups only
+	uint32_t StoredCRC = 0;
 	BYTE *MemoryBuffer = nullptr;
 	C4GroupEntry *Next = nullptr;
 public:
@@ -182,6 +203,9 @@ public:
 				   int zeros_to_append = 0);
 	bool LoadEntry(const char *entry_name, StdBuf * buffer);
 	bool LoadEntry(const StdStrBuf & name, StdBuf * buffer) { return LoadEntry(name.getData(), buffer); }
+	// Like LoadEntry, but may return a read-only buffer referencing memory owned by the group
+	// (a file mapping or a precached entry). The data stays valid until the group is closed or saved.
+	bool LoadEntryView(const char *entry_name, StdBuf * buffer);
 	bool LoadEntryString(const char *entry_name, StdStrBuf * buffer);
 	bool LoadEntryString(const StdStrBuf & name, StdStrBuf * buffer) { return LoadEntryString(name.getData(), buffer); }
 	bool FindEntry(const char *wildcard,
@@ -230,6 +254,8 @@ public:
 	bool IsPacked() const;
 	bool HasPackedMother() const;
 	bool SetNoSort(bool no_sorting);
+	bool SetFormat(C4GroupFormat format); // format used when the group is saved next
+	C4GroupFormat GetFormat() const;
 	int PreCacheEntries(const char *search_pattern, bool cache_previous = false); // pre-load entries to memory. return number of loaded entries.
 
 	const C4GroupHeader &GetHeader() const;
@@ -242,6 +268,11 @@ private:
 	bool Error(const char *status_message);
 	bool OpenReal(const char *group_name);
 	bool OpenRealGrpFile();
+	bool OpenIndexed();
+	bool ReadIndexed(int offset, void *buffer, size_t size);
+	bool LoadIndexedEntry(C4GroupEntry *entry);
+	const BYTE *MapEntry(const char *entry_name, C4GroupEntry *entry);
+	bool CopyIndexed(int offset, int size, CStdFile &target);
 	bool SetFilePtr(int offset);
 	bool RewindFilePtr();
 	bool AdvanceFilePtr(int offset);
@@ -258,6 +289,11 @@ private:
 	bool AddEntryOnDisk(const char *filename, const char *entry_name = nullptr, bool move = false);
 	bool SetFilePtr2Entry(const char *entry_name, bool needs_to_be_a_group = false);
 	bool AppendEntry2StdFile(C4GroupEntry *entry, CStdFile &target);
+	bool AppendEntry2Indexed(C4GroupEntry *entry, CStdFile &target, C4GroupIndexEntry &index_entry);
+	bool IsIndexedChild(C4GroupEntry *entry);
+	bool ConvertChildEntries();
+	bool WriteStream(CStdFile &target);
+	bool WriteIndexed(CStdFile &target);
 	C4GroupEntry *SearchNextEntry(const char *entry_name);
 	C4GroupEntry *GetNextFolderEntry();
 	uint32_t CalcCRC32(C4GroupEntry *entry);
@@ -48,7 +48,7 @@ void DisplayGroup(C4Group &grp, const char *filter = nullptr)
 {
 	const C4GroupHeader &head = grp.GetHeader();
 	
-	printf("Version: %d.%d  ", head.Ver1, head.Ver2);
+	printf("Version: %d.%d (%s)  ", head.Ver1, head.Ver2, grp.GetFormat() == C4GF_Indexed ? "indexed" : "stream");
 
 	uint32_t crc = 0;
 	bool crc_valid = GetFileCRC(grp.GetFullName().getData(), &crc);
@@ -108,6 +108,11 @@ void PrintGroupInternals(C4Group &grp, int indent_level = 0)
 		printf("%*s  ChildGroup: %d\n", indent, "", p->ChildGroup);
 		printf("%*s  Size: %d\n", indent, "", p->Size);
 		printf("%*s  Offset: %d\n", indent, "", p->Offset);
+		if (head.Ver2 == C4GroupFileVer2Indexed)
+		{
+			printf("%*s  StoredSize: %d\n", indent, "", p->StoredSize);
+			printf("%*s  CRC: %X\n", indent, "", p->StoredCRC);
+		}
 		printf("%*s  Executable: %d\n", indent, "", p->Executable);
 		if (p->ChildGroup != 0)
 		{
@@ -330,6 +335,44 @@ bool ProcessGroup(const char *FilenamePar)
 					case 'z':
 						PrintGroupInternals(hGroup);
 						break;
+						// Convert
+					case 'c':
+						if ((iArg + 1 >= argc) || (argv[iArg + 1][0] == '-'))
+						{
+							fprintf(stderr, "Missing argument for convert command\n");
+						}
+						else
+						{
+							C4GroupFormat format;
+							if (SEqualNoCase(argv[iArg + 1], "indexed"))
+								format = C4GF_Indexed;
+							else if (SEqualNoCase(argv[iArg + 1], "stream"))
+								format = C4GF_Stream;
+							else
+							{
+								fprintf(stderr, "Unknown group format: %s\n", argv[iArg + 1]);
+								iArg++;
+								break;
+							}
+							LogF("Converting to %s group...", argv[iArg + 1]);
+							// Rewrite on close
+							if (!hGroup.SetFormat(format))
+							{
+								fprintf(stderr, "Convert failed: not a packed group\n");
+							}
+							// Close
+							else if (!hGroup.Close())
+							{
+								fprintf(stderr, "Closing failed: %s\n", hGroup.GetError());
+							}
+							// Reopen
+							else if (!hGroup.Open(szFilename))
+							{
+								fprintf(stderr, "Reopen failed: %s\n", hGroup.GetError());
+							}
+							iArg++;
+						}
+						break;
 						// Undefined
 					default:
 						fprintf(stderr, "Unknown command: %s\n", argv[iArg]);
@@ -551,6 +594,7 @@ int main(int argc, char *argv[])
 		printf("          -y [ppid] Apply update (waiting for ppid to terminate first)\n");
 		printf("          -g [source] [target] [title] Make update\n");
 		printf("          -s Sort\n");
+		printf("          -c [indexed|stream] Convert packed group format\n");
 		printf("\n");
 		printf("Options:  -v Verbose -r Recursive\n");
 		printf("          -i Register shell -u Unregister shell\n");
@@ -559,6 +603,7 @@ int main(int argc, char *argv[])
 		printf("\n");
 		printf("Examples: c4group pack.ocg -x\n");
 		printf("          c4group update.ocu -g ver1.ocf ver2.ocf New_Version\n");
+		printf("          c4group Objects.ocd -c indexed\n");
 		printf("          c4group -i\n");
 	}
 
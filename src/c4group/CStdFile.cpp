@@ -28,6 +28,9 @@
 #include "zlib/gzio.h"
 
 #include <sys/stat.h>
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
 
 CStdFile::CStdFile()
 {
@@ -309,6 +312,16 @@ int CStdFile::Seek(long int offset, int whence)
 {
 	// seek in file by offset and stdio-style SEEK_* constants. Only implemented for uncompressed files.
 	assert(!hgzFile);
+	// write out or drop the buffer, so it matches the new position
+	if (ModeWrite)
+	{
+		if (!Flush()) return -1;
+	}
+	else
+	{
+		if (whence == SEEK_CUR) offset -= BufferLoad - BufferPtr;
+		BufferLoad = BufferPtr = 0;
+	}
 	return fseek(hFile, offset, whence);
 }
 
@@ -316,7 +329,10 @@ long int CStdFile::Tell()
 {
 	// get current file pos. Only implemented for uncompressed files.
 	assert(!hgzFile);
-	return ftell(hFile);
+	long int pos = ftell(hFile);
+	if (pos < 0) return pos;
+	// account for buffered data
+	return ModeWrite ? pos + BufferLoad : pos - (BufferLoad - BufferPtr);
 }
 
 int UncompressedFileSize(const char *szFilename)
@@ -344,6 +360,52 @@ int UncompressedFileSize(const char *szFilename)
 	return rval;
 }
 
+bool CStdFileMapping::Open(const char *szFileName)
+{
+	Close();
+#if defined(_WIN32)
+	HANDLE hFile = CreateFileW(GetWideChar(szFileName), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE) return false;
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(hFile, &size) || !size.QuadPart || size.QuadPart > INT32_MAX) { CloseHandle(hFile); return false; }
+	HANDLE hMapping = CreateFileMappingW(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(hFile);
+	if (!hMapping) return false;
+	// The view keeps the mapping alive
+	void *pView = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hMapping);
+	if (!pView) return false;
+	pData = static_cast<const BYTE *>(pView);
+	iSize = size_t(size.QuadPart);
+	return true;
+#elif defined(HAVE_SYS_MMAN_H)
+	int fd = open(szFileName, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) return false;
+	struct stat st;
+	if (fstat(fd, &st) || !S_ISREG(st.st_mode) || !st.st_size || st.st_size > INT32_MAX) { close(fd); return false; }
+	// The mapping stays valid after the descriptor is closed
+	void *pView = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (pView == MAP_FAILED) return false;
+	pData = static_cast<const BYTE *>(pView);
+	iSize = size_t(st.st_size);
+	return true;
+#else
+	return false;
+#endif
+}
+
+void CStdFileMapping::Close()
+{
+	if (!pData) return;
+#if defined(_WIN32)
+	UnmapViewOfFile(pData);
+#elif defined(HAVE_SYS_MMAN_H)
+	munmap(const_cast<BYTE *>(pData), iSize);
+#endif
+	pData = nullptr; iSize = 0;
+}
+
 size_t CStdFile::AccessedEntrySize() const
 {
 	if (hFile)
@@ -75,6 +75,25 @@ protected:
 	bool SaveBuffer();
 };
 
+// Read-only memory mapping of a whole file
+class CStdFileMapping
+{
+public:
+	CStdFileMapping() = default;
+	~CStdFileMapping() { Close(); }
+	CStdFileMapping(const CStdFileMapping &) = delete;
+	CStdFileMapping &operator=(const CStdFileMapping &) = delete;
+protected:
+	const BYTE *pData = nullptr;
+	size_t iSize = 0;
+public:
+	bool Open(const char *szFileName); // fails for empty files and on platforms without mmap
+	void Close();
+	bool IsOpen() const { return pData != nullptr; }
+	const BYTE *getData() const { return pData; }
+	size_t getSize() const { return iSize; }
+};
+
 int UncompressedFileSize(const char *szFileName);
 bool GetFileCRC(const char *szFilename, uint32_t *pCRC32);
 bool GetFileSHA1(const char *szFilename, BYTE *pSHA1);
@@ -65,6 +65,7 @@ void C4ConfigGeneral::CompileFunc(StdCompiler *compiler)
 	compiler->Value(mkNamingAdapt(s(MissionAccess),    "MissionAccess",      "", false, true));
 	compiler->Value(mkNamingAdapt(FPS,                 "FPS",                0              ));
 	compiler->Value(mkNamingAdapt(DefRec,              "DefRec",             0              ));
+	compiler->Value(mkNamingAdapt(RecordKeyframes,     "RecordKeyframes",    0              ));
 	compiler->Value(mkNamingAdapt(ScreenshotFolder,    "ScreenshotFolder",   "Screenshots",  false, true));
 	compiler->Value(mkNamingAdapt(ModsFolder,          "ModsFolder",         "mods",  false, true));
 	compiler->Value(mkNamingAdapt(ScrollSmooth,        "ScrollSmooth",       4              ));
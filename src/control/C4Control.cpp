@@ -749,11 +749,13 @@ void C4ControlSyncCheck::Set()
 	ControlTick = ::Control.ControlTick;
 	RandomCount = ::RandomCount;
 	AllCrewPosX = GetAllCrewPosX();
-	PXSCount = ::PXS.Count;
+	PXSCount = ::PXS.GetCount();
 	MassMoverIndex = ::MassMover.CreatePtr;
 	ObjectCount = ::Objects.ObjectCount();
 	ObjectEnumerationIndex = C4PropListNumbered::GetEnumerationIndex();
 	SectShapeSum = ::Objects.Sectors.getShapeSum();
+	LandscapeHash = ::Landscape.GetHash();
+	::Landscape.TakeChangedTileHashes(LandscapeTiles);
 }
 
 int32_t C4ControlSyncCheck::GetAllCrewPosX()
@@ -765,6 +767,19 @@ int32_t C4ControlSyncCheck::GetAllCrewPosX()
 	return cpx;
 }
 
+int32_t C4ControlSyncCheck::FindLandscapeDifference(const std::vector<C4LandscapeTileHash> &a, const std::vector<C4LandscapeTileHash> &b)
+{
+	// First tile listed on both sides with different hashes. Tiles listed on one
+	// side only might have been changed on the other before it joined.
+	auto i = a.begin(), j = b.begin();
+	while (i != a.end() && j != b.end())
+		if (i->Index < j->Index) ++i;
+		else if (j->Index < i->Index) ++j;
+		else if (i->Hash != j->Hash) return i->Index;
+		else { ++i; ++j; }
+	return -1;
+}
+
 void C4ControlSyncCheck::Execute() const
 {
 	// control host?
@@ -787,15 +802,27 @@ void C4ControlSyncCheck::Execute() const
 	     || MassMoverIndex         != pSyncCheck->MassMoverIndex
 	     || ObjectCount            != pSyncCheck->ObjectCount
 	     || ObjectEnumerationIndex != pSyncCheck->ObjectEnumerationIndex
-	     || SectShapeSum           != pSyncCheck->SectShapeSum)
+	     || SectShapeSum           != pSyncCheck->SectShapeSum
+	     || LandscapeHash          != pSyncCheck->LandscapeHash)
 	{
 		const char *szThis = "Client", *szOther = ::Control.isReplay() ? "Rec ":"Host";
 		if (iByClient != ::Control.ClientID())
 			{ const char *szTemp = szThis; szThis = szOther; szOther = szTemp; }
 		// Message
 		LogFatal("Network: Synchronization loss!");
-		LogFatal(FormatString("Network: %s Frm %i Ctrl %i Rnc %i Cpx %i PXS %i MMi %i Obc %i Oei %i Sct %i", szThis, Frame,ControlTick,RandomCount,AllCrewPosX,PXSCount,MassMoverIndex,ObjectCount,ObjectEnumerationIndex, SectShapeSum).getData());
-		LogFatal(FormatString("Network: %s Frm %i Ctrl %i Rnc %i Cpx %i PXS %i MMi %i Obc %i Oei %i Sct %i", szOther, SyncCheck.Frame,SyncCheck.ControlTick,SyncCheck.RandomCount,SyncCheck.AllCrewPosX,SyncCheck.PXSCount,SyncCheck.MassMoverIndex,SyncCheck.ObjectCount,SyncCheck.ObjectEnumerationIndex, SyncCheck.SectShapeSum).getData());
+		LogFatal(FormatString("Network: %s Frm %i Ctrl %i Rnc %i Cpx %i PXS %i MMi %i Obc %i Oei %i Sct %i Lsh %u", szThis, Frame,ControlTick,RandomCount,AllCrewPosX,PXSCount,MassMoverIndex,ObjectCount,ObjectEnumerationIndex, SectShapeSum, LandscapeHash).getData());
+		LogFatal(FormatString("Network: %s Frm %i Ctrl %i Rnc %i Cpx %i PXS %i MMi %i Obc %i Oei %i Sct %i Lsh %u", szOther, SyncCheck.Frame,SyncCheck.ControlTick,SyncCheck.RandomCount,SyncCheck.AllCrewPosX,SyncCheck.PXSCount,SyncCheck.MassMoverIndex,SyncCheck.ObjectCount,SyncCheck.ObjectEnumerationIndex, SyncCheck.SectShapeSum, SyncCheck.LandscapeHash).getData());
+		if (LandscapeHash != SyncCheck.LandscapeHash)
+		{
+			int32_t tile = FindLandscapeDifference(LandscapeTiles, SyncCheck.LandscapeTiles);
+			if (tile >= 0)
+			{
+				C4Rect rect = ::Landscape.GetHashTile(tile);
+				LogFatal(FormatString("Network: Landscape differs in tile %i (%i/%i, %ix%i)", tile, rect.x, rect.y, rect.Wdt, rect.Hgt).getData());
+			}
+			else
+				LogFatal("Network: Landscape differs outside the tiles changed since the last sync check");
+		}
 		StartSoundEffect("UI::SyncError");
 #ifdef _DEBUG
 		// Debug safe
@@ -827,6 +854,8 @@ void C4ControlSyncCheck::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(ObjectCount), "ObjectCount", 0));
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(ObjectEnumerationIndex), "ObjectEnumerationIndex", 0));
 	pComp->Value(mkNamingAdapt(mkIntPackAdapt(SectShapeSum), "SectShapeSum", 0));
+	pComp->Value(mkNamingAdapt(LandscapeHash, "LandscapeHash", 0u));
+	pComp->Value(mkNamingAdapt(mkSTLContainerAdapt(LandscapeTiles), "LandscapeTiles", std::vector<C4LandscapeTileHash>()));
 	C4ControlPacket::CompileFunc(pComp);
 }
 
@@ -22,6 +22,7 @@
 
 #include "control/C4PlayerInfo.h"
 #include "gui/C4KeyboardInput.h"
+#include "landscape/C4Landscape.h"
 #include "network/C4PacketBase.h"
 #include "network/C4Client.h"
 #include "object/C4Id.h"
@@ -328,13 +329,16 @@ protected:
 	int32_t ObjectCount;
 	int32_t ObjectEnumerationIndex;
 	int32_t SectShapeSum;
+	uint32_t LandscapeHash;
+	std::vector<C4LandscapeTileHash> LandscapeTiles; // tiles changed since the previous sync check
 public:
 	void Set();
 	int32_t getFrame() const { return Frame; }
 	bool Sync() const override { return false; }
 	DECLARE_C4CONTROL_VIRTUALS
-protected:
 	static int32_t GetAllCrewPosX();
+protected:
+	static int32_t FindLandscapeDifference(const std::vector<C4LandscapeTileHash> &a, const std::vector<C4LandscapeTileHash> &b);
 };
 
 class C4ControlSynchronize : public C4ControlPacket // sync
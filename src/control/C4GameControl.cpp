@@ -130,6 +130,9 @@ void C4GameControl::OnGameSynchronizing()
 		fRecordNeeded = false;
 		StartRecord(false, false);
 	}
+	// any synchronized state can serve as a keyframe
+	else if (pRecord && Config.General.RecordKeyframes > 0)
+		pRecord->SaveKeyframe();
 }
 
 bool C4GameControl::StartRecord(bool fInitial, bool fStreaming)
@@ -280,6 +283,10 @@ void C4GameControl::Execute()
 	if (!isReplay() && Game.FrameCounter % ControlRate)
 		return;
 
+	// Record: synchronize to save a keyframe
+	if (pRecord && fHost && !isReplay() && pRecord->KeyframeDue(Game.FrameCounter))
+		DoInput(CID_Synchronize, new C4ControlSynchronize(false, true), CDT_Sync);
+
 	// Get control
 	C4Control Control;
 	if (eMode == CM_Local)
@@ -1470,6 +1470,9 @@ bool C4PlayerInfoList::RecreatePlayerFiles()
 						// replay of resumed savegame: RecreatePlayers saves used player files into the record group in this manner
 						sFilenameInRecord.Format("Recreate-%d.ocp", pInfo->GetID());
 						szCurrPlrFile = sFilenameInRecord.getData();
+						// record keyframes hold the player files saved with them
+						if (!Game.ScenarioFile.FindEntry(szCurrPlrFile) && pInfo->GetFilename() && *pInfo->GetFilename())
+							szCurrPlrFile = pInfo->GetFilename();
 					}
 					else
 						szCurrPlrFile = pInfo->GetFilename();
@@ -18,10 +18,13 @@
 #include "C4Include.h"
 #include "control/C4Record.h"
 
+#include "config/C4Reloc.h"
 #include "control/C4GameControl.h"
 #include "control/C4GameSave.h"
 #include "control/C4PlayerInfo.h"
+#include "control/C4ReplayStats.h"
 #include "editor/C4Console.h"
+#include "game/C4Application.h"
 #include "player/C4Player.h"
 
 #define IMMEDIATEREC
@@ -97,6 +100,41 @@ void C4RecordChunk::CompileFunc(StdCompiler *pComp)
 	}
 }
 
+void C4RecordBlockWriter::Init()
+{
+	Data.Clear(); Output.Clear();
+	iFrame = iLastFrame = 0;
+	C4RecordBlockFileHead Head = { C4RecordBlockFileId, C4RecordBlockFileVer };
+	Output.Append(&Head, sizeof(Head));
+}
+
+void C4RecordBlockWriter::Add(const C4RecordChunkHead &Head, const StdBuf &sBuf)
+{
+	if (!Data.getSize()) iFrame = iLastFrame;
+	iLastFrame += Head.iFrm;
+	Data.Append(&Head, sizeof(Head));
+	Data.Append(sBuf.getData(), sBuf.getSize());
+	if (iLastFrame - iFrame >= C4RecordBlockFrames || Data.getSize() >= C4RecordBlockSize)
+		Flush();
+}
+
+bool C4RecordBlockWriter::Flush()
+{
+	if (!Data.getSize()) return true;
+	uLongf iSize = compressBound(Data.getSize());
+	StdBuf Packed; Packed.New(sizeof(C4RecordBlockHead) + iSize);
+	if (compress2(getMBufPtr<Bytef>(Packed, sizeof(C4RecordBlockHead)), &iSize, getBufPtr<Bytef>(Data), Data.getSize(), Z_BEST_COMPRESSION) != Z_OK)
+		return false;
+	C4RecordBlockHead *pHead = getMBufPtr<C4RecordBlockHead>(Packed);
+	pHead->Frame = iFrame;
+	pHead->LastFrame = iLastFrame;
+	pHead->Size = iSize;
+	pHead->RawSize = Data.getSize();
+	Output.Append(Packed.getData(), sizeof(C4RecordBlockHead) + iSize);
+	Data.Clear();
+	return true;
+}
+
 C4Record::C4Record() = default;
 
 C4Record::~C4Record() = default;
@@ -146,9 +184,16 @@ bool C4Record::Start(bool fInitial)
 		return false;
 
 	// open control record file
+	// debug records stay plain, so nothing is lost when the engine crashes
+	fBlocks = !Config.General.DebugRec;
 	char szCtrlRecFilename[_MAX_PATH_LEN + _MAX_FNAME];
-	sprintf(szCtrlRecFilename, "%s" DirSep C4CFN_CtrlRec, sFilename.getData());
+	sprintf(szCtrlRecFilename, "%s" DirSep "%s", sFilename.getData(), fBlocks ? C4CFN_CtrlRecBlocks : C4CFN_CtrlRec);
 	if (!CtrlRec.Create(szCtrlRecFilename)) return false;
+	if (fBlocks)
+	{
+		Blocks.Init();
+		if (!WriteBlocks()) return false;
+	}
 
 	// open log file in record
 	char szLogRecFilename[_MAX_PATH_LEN + _MAX_FNAME];
@@ -163,6 +208,8 @@ bool C4Record::Start(bool fInitial)
 	fStreaming = false;
 	fRecording = true;
 	iLastFrame = 0;
+	iLastKeyframe = Game.FrameCounter;
+	iNextKeyframe = 0;
 	return true;
 }
 
@@ -187,7 +234,14 @@ bool C4Record::Stop(StdStrBuf *pRecordName, BYTE *pRecordSHA1)
 	C4RecordChunkHead Head;
 	Head.iFrm = 37;
 	Head.Type = RCT_End;
-	CtrlRec.Write(&Head, sizeof(Head));
+	if (fBlocks)
+	{
+		Blocks.Add(Head, StdBuf());
+		Blocks.Flush();
+		WriteBlocks();
+	}
+	else
+		CtrlRec.Write(&Head, sizeof(Head));
 	CtrlRec.Close();
 
 	LogRec.Close();
@@ -244,18 +298,38 @@ bool C4Record::Rec(int iFrame, const StdBuf &sBuf, C4RecordChunkType eType)
 	// create head
 	C4RecordChunkHead Head = { iFrameDiff, uint8_t(eType) };
 	// pack
-	CtrlRec.Write(&Head, sizeof(Head));
-	CtrlRec.Write(sBuf.getData(), sBuf.getSize());
+	if (fBlocks)
+	{
+		Blocks.Add(Head, sBuf);
+		WriteBlocks();
+	}
+	else
+	{
+		CtrlRec.Write(&Head, sizeof(Head));
+		CtrlRec.Write(sBuf.getData(), sBuf.getSize());
 #ifdef IMMEDIATEREC
-	// immediate rec: always flush
-	CtrlRec.Flush();
+		// immediate rec: always flush
+		CtrlRec.Flush();
 #endif
+	}
 	// Stream
 	if (fStreaming)
 		Stream(Head, sBuf);
 	return true;
 }
 
+bool C4Record::WriteBlocks()
+{
+	StdBuf &Output = Blocks.GetOutput();
+	if (!Output.getSize()) return true;
+	bool fSuccess = CtrlRec.Write(Output.getData(), Output.getSize());
+#ifdef IMMEDIATEREC
+	CtrlRec.Flush();
+#endif
+	Output.Clear();
+	return fSuccess;
+}
+
 void C4Record::Stream(const C4RecordChunkHead &Head, const StdBuf &sBuf)
 {
 	if (!fStreaming) return;
@@ -308,6 +382,34 @@ bool C4Record::AddFile(const char *szLocalFilename, const char *szAddAs, bool fD
 	return true;
 }
 
+bool C4Record::KeyframeDue(int32_t iFrame)
+{
+	// in network games, the synchronization is executed a few control ticks later
+	if (!fRecording || Config.General.RecordKeyframes <= 0) return false;
+	if (iFrame < iLastKeyframe + Config.General.RecordKeyframes || iFrame < iNextKeyframe) return false;
+	iNextKeyframe = iFrame + Config.General.RecordKeyframes;
+	return true;
+}
+
+bool C4Record::SaveKeyframe()
+{
+	if (!fRecording) return false;
+	// one keyframe per frame; the record start is a keyframe itself
+	if (Game.FrameCounter <= iLastKeyframe) return true;
+	iLastKeyframe = Game.FrameCounter;
+	// save the synchronized game into the record folder, to be opened like a runtime record
+	StdStrBuf sKeyframe; sKeyframe.Format("%s" DirSep C4CFN_RecKeyframe, sFilename.getData(), (int) Game.FrameCounter);
+	C4GameSaveRecord saveRec(false, Index, Game.Parameters.isLeague());
+	if (!saveRec.Save(sKeyframe.getData()))
+	{
+		LogF("Record: Could not save keyframe at frame %d", (int) Game.FrameCounter);
+		return false;
+	}
+	saveRec.Close();
+	LogSilentF("Record: Keyframe at frame %d", (int) Game.FrameCounter);
+	return true;
+}
+
 bool C4Record::StartStreaming(bool fInitial)
 {
 	if (!fRecording) return false;
@@ -391,6 +493,18 @@ bool C4Playback::Open(C4Group &rGrp)
 	// Also can't do this when stripping is desired
 	fLoadSequential = !rGrp.IsPacked() && !Game.RecordDumpFile.getLength() && !fStrip;
 
+	// keyframes of a record are played with the control of the record they are in
+	StdStrBuf BlockRecord;
+	if (rGrp.FindEntry(C4CFN_CtrlRecBlocks))
+		BlockRecord.Copy(rGrp.GetFullName());
+	else if (WildcardMatch(C4CFN_RecKeyframes, GetFilename(rGrp.GetName())))
+	{
+		BlockRecord.Copy(rGrp.GetFullName());
+		TruncatePath(BlockRecord.getMData());
+		BlockRecord.SetLength(SLen(BlockRecord.getData()));
+		iKeyframe = GetTrailingNumber(GetFilenameOnly(rGrp.GetName()));
+	}
+
 	// get text record file
 	StdStrBuf TextBuf;
 	if (rGrp.LoadEntryString(C4CFN_CtrlRecText, &TextBuf))
@@ -398,6 +512,19 @@ bool C4Playback::Open(C4Group &rGrp)
 		if (!ReadText(TextBuf))
 			return false;
 	}
+	else if (BlockRecord.getLength())
+	{
+		if (!OpenBlocks(BlockRecord.getData()))
+			return false;
+		// a dump needs all data
+		if (Game.RecordDumpFile.getLength())
+			while (ReadBlock()) {}
+		else if (!NextBlock())
+		{
+			LogFatal("Record: Binary read error.");
+			return false;
+		}
+	}
 	else
 	{
 		// get record file
@@ -475,6 +602,7 @@ bool C4Playback::Open(C4Group &rGrp)
 	// reset status
 	currChunk = chunks.begin();
 	Finished = false;
+	iSeekFrame = Game.RecordSeekFrame;
 	// external debugrec file
 	if (Config.General.DebugRecExternalFile[0] && Config.General.DebugRec)
 	{
@@ -501,10 +629,10 @@ bool C4Playback::Open(C4Group &rGrp)
 	return true;
 }
 
-bool C4Playback::ReadBinary(const StdBuf &Buf)
+bool C4Playback::ReadBinary(const StdBuf &Buf, uint32_t iBaseFrame)
 {
 	// sequential reading: Take over rest from last buffer
-	const StdBuf *pUseBuf; uint32_t iFrame = 0;
+	const StdBuf *pUseBuf; uint32_t iFrame = iBaseFrame;
 	if (fLoadSequential)
 	{
 		sequentialBuffer.Append(Buf);
@@ -606,17 +734,92 @@ bool C4Playback::ReadText(const StdStrBuf &Buf)
 	return CompileFromBuf_LogWarn<StdCompilerINIRead>(mkNamingAdapt(mkSTLContainerAdapt(chunks), "Rec"), Buf, C4CFN_CtrlRecText);
 }
 
+bool C4Playback::OpenBlocks(const char *szRecord)
+{
+	// walk the block heads to index the record
+	size_t iSize;
+	if (!BlockGrp.Open(szRecord) || !BlockGrp.AccessEntry(C4CFN_CtrlRecBlocks, &iSize))
+	{
+		LogF("Record: Could not open %s in %s", C4CFN_CtrlRecBlocks, szRecord);
+		return false;
+	}
+	C4RecordBlockFileHead FileHead;
+	if (!BlockGrp.Read(&FileHead, sizeof(FileHead)) || FileHead.Id != C4RecordBlockFileId || FileHead.Ver != C4RecordBlockFileVer)
+	{
+		Log("Record: Invalid block record head.");
+		return false;
+	}
+	BlockIndex.clear();
+	size_t iOffset = sizeof(FileHead);
+	C4RecordBlockHead Head;
+	while (iOffset + sizeof(Head) <= iSize && BlockGrp.Read(&Head, sizeof(Head)))
+	{
+		if (iOffset + sizeof(Head) + Head.Size > iSize) break;
+		BlockIndex.push_back({ Head.Frame, Head.LastFrame, iOffset });
+		iOffset += sizeof(Head) + Head.Size;
+		if (!BlockGrp.Advance(Head.Size)) break;
+	}
+	// start at the first block containing chunks of the keyframe
+	iNextBlock = 0;
+	while (iNextBlock < BlockIndex.size() && int32_t(BlockIndex[iNextBlock].LastFrame) < iKeyframe)
+		++iNextBlock;
+	if (iNextBlock == BlockIndex.size()) return false;
+	if (!BlockGrp.AccessEntry(C4CFN_CtrlRecBlocks) || !BlockGrp.Advance(BlockIndex[iNextBlock].Offset))
+		return false;
+	fLoadBlocks = true;
+	return true;
+}
+
+bool C4Playback::ReadBlock()
+{
+	if (!fLoadBlocks || iNextBlock >= BlockIndex.size()) return false;
+	++iNextBlock;
+	C4RecordBlockHead Head;
+	StdBuf Packed, Raw;
+	if (!BlockGrp.Read(&Head, sizeof(Head))) return false;
+	Packed.New(Head.Size); Raw.New(Head.RawSize);
+	uLongf iRawSize = Head.RawSize;
+	if (!BlockGrp.Read(Packed.getMData(), Head.Size) ||
+	    uncompress(getMBufPtr<Bytef>(Raw), &iRawSize, getBufPtr<Bytef>(Packed), Head.Size) != Z_OK ||
+	    iRawSize != Head.RawSize)
+	{
+		LogF("Record: Corrupt block at frame %u", Head.Frame);
+		return false;
+	}
+	if (!ReadBinary(Raw, Head.Frame)) return false;
+	// the keyframe already contains everything done before it
+	while (!chunks.empty() && chunks.front().Frame < iKeyframe)
+	{
+		chunks.front().Delete();
+		chunks.pop_front();
+	}
+	return true;
+}
+
 void C4Playback::NextChunk()
 {
 	assert(currChunk != chunks.end());
 	++currChunk;
 	if (currChunk != chunks.end()) return;
 	// end of all chunks if not loading sequential here
-	if (!fLoadSequential) return;
+	if (!fLoadSequential && !fLoadBlocks) return;
 	// otherwise, get next few chunks
 	for (auto & chunk : chunks) chunk.Delete();
 	chunks.clear(); currChunk = chunks.end();
-	NextSequentialChunk();
+	if (fLoadBlocks)
+		NextBlock();
+	else
+		NextSequentialChunk();
+}
+
+bool C4Playback::NextBlock()
+{
+	// only one block is kept in memory
+	while (chunks.empty())
+		if (!ReadBlock())
+			return false;
+	currChunk = chunks.begin();
+	return true;
 }
 
 bool C4Playback::NextSequentialChunk()
@@ -655,6 +858,27 @@ StdStrBuf C4Playback::ReWriteText()
 	return Output;
 }
 
+namespace
+{
+	// Data following the head of a chunk; throws StdCompiler::Exception
+	StdBuf PackChunkData(const C4RecordChunk &Chunk)
+	{
+		switch (Chunk.Type)
+		{
+		case RCT_Ctrl:
+			return DecompileToBuf<StdCompilerBinWrite>(*Chunk.pCtrl);
+		case RCT_CtrlPkt:
+			return DecompileToBuf<StdCompilerBinWrite>(*Chunk.pPkt);
+		case RCT_End:
+			return StdBuf();
+		default: // debugrec
+			if (Chunk.pDbg)
+				return DecompileToBuf<StdCompilerBinWrite>(*Chunk.pDbg);
+			return StdBuf();
+		}
+	}
+}
+
 StdBuf C4Playback::ReWriteBinary()
 {
 	const int OUTPUT_GROW = 16 * 1024;
@@ -670,22 +894,8 @@ StdBuf C4Playback::ReWriteBinary()
 		StdBuf Chunk;
 		try
 		{
-			switch (i->Type)
-			{
-			case RCT_Ctrl:
-				Chunk = DecompileToBuf<StdCompilerBinWrite>(*i->pCtrl);
-				break;
-			case RCT_CtrlPkt:
-				Chunk = DecompileToBuf<StdCompilerBinWrite>(*i->pPkt);
-				break;
-			case RCT_End:
-				fFinished = true;
-				break;
-			default: // debugrec
-				if (i->pDbg)
-					Chunk = DecompileToBuf<StdCompilerBinWrite>(*i->pDbg);
-				break;
-			}
+			Chunk = PackChunkData(*i);
+			fFinished = i->Type == RCT_End;
 		}
 		catch (StdCompiler::Exception *pEx)
 		{
@@ -710,6 +920,37 @@ StdBuf C4Playback::ReWriteBinary()
 	return Output;
 }
 
+bool C4Playback::ReWriteBlocks(StdBuf *pOutput)
+{
+	C4RecordBlockWriter Writer;
+	Writer.Init();
+	int32_t iFrame = 0;
+	for (const C4RecordChunk &Chunk : chunks)
+	{
+		if (Chunk.Frame - iFrame < 0 || Chunk.Frame - iFrame > 0xff)
+		{
+			LogF("Record: Invalid frame difference between chunks at frame %d", (int) Chunk.Frame);
+			return false;
+		}
+		try
+		{
+			C4RecordChunkHead Head = { uint8_t(Chunk.Frame - iFrame), Chunk.Type };
+			Writer.Add(Head, PackChunkData(Chunk));
+		}
+		catch (StdCompiler::Exception *pEx)
+		{
+			LogF("Record: Binary unpack error: %s", pEx->Msg.getData());
+			delete pEx;
+			return false;
+		}
+		iFrame = Chunk.Frame;
+		if (Chunk.Type == RCT_End) break;
+	}
+	if (!Writer.Flush()) return false;
+	pOutput->Take(std::move(Writer.GetOutput()));
+	return true;
+}
+
 void C4Playback::Strip()
 {
 	// Strip what?
@@ -839,9 +1080,20 @@ void C4Playback::Strip()
 
 bool C4Playback::ExecuteControl(C4Control *pCtrl, int iFrame)
 {
-	// still playbacking?
-	if (currChunk == chunks.end()) return false;
-	if (Finished) { Finish(); return false; }
+	// fast-forward to the frame to seek to
+	if (iSeekFrame)
+	{
+		if (iFrame >= iSeekFrame)
+		{
+			LogF("Record: Reached frame %d", iFrame);
+			iSeekFrame = 0;
+		}
+		// batch replays keep running at full speed
+		Game.FullSpeed = iSeekFrame || Game.pReplayStats;
+		Game.FrameSkip = Game.FullSpeed ? 500 : 1;
+	}
+	// still playbacking? The end chunk is the last one in the record.
+	if (Finished || currChunk == chunks.end()) { Finish(); return false; }
 	if (Config.General.DebugRec)
 	{
 		if (DebugRec.firstPkt())
@@ -892,6 +1144,12 @@ bool C4Playback::ExecuteControl(C4Control *pCtrl, int iFrame)
 void C4Playback::Finish()
 {
 	Clear();
+	// batch replays are done
+	if (Game.pReplayStats)
+	{
+		Game.pReplayStats->Finish();
+		Application.Quit();
+	}
 	// finished playback: end game
 	if (Console.Active)
 	{
@@ -914,6 +1172,18 @@ void C4Playback::Clear()
 	playbackFile.Close();
 	sequentialBuffer.Clear();
 	fLoadSequential = false;
+	BlockGrp.Close();
+	BlockIndex.clear();
+	fLoadBlocks = false;
+	iNextBlock = 0;
+	iKeyframe = 0;
+	// record ended before the frame to seek to
+	if (iSeekFrame)
+	{
+		Game.FullSpeed = !!Game.pReplayStats;
+		Game.FrameSkip = Game.FullSpeed ? 500 : 1;
+		iSeekFrame = 0;
+	}
 	if (Config.General.DebugRec)
 	{
 		C4IDPacket *pkt;
@@ -1215,8 +1485,9 @@ bool C4Playback::StreamToRecord(const char *szStream, StdStrBuf *pRecordFile)
 			chunkIter++;
 
 	// Write record data
-	StdBuf RecordData = Playback.ReWriteBinary();
-	if (!Grp.Add(C4CFN_CtrlRec, RecordData, false, true))
+	StdBuf RecordData;
+	if (!Playback.ReWriteBlocks(&RecordData) ||
+	    !Grp.Add(C4CFN_CtrlRecBlocks, RecordData, false, true))
 		return false;
 
 	// Done
@@ -1225,3 +1496,59 @@ bool C4Playback::StreamToRecord(const char *szStream, StdStrBuf *pRecordFile)
 	pRecordFile->Copy(szRecord);
 	return true;
 }
+
+bool C4Playback::ConvertRecord(const char *szRecord)
+{
+	C4Group Grp;
+	if (!Grp.Open(szRecord))
+	{
+		LogF("Record: Could not open %s: %s", szRecord, Grp.GetError());
+		return false;
+	}
+	if (Grp.FindEntry(C4CFN_CtrlRecBlocks))
+	{
+		LogF("Record: %s is a block record already.", szRecord);
+		return true;
+	}
+	// read all control
+	C4Playback Playback;
+	StdStrBuf TextBuf; StdBuf BinaryBuf;
+	if (Grp.LoadEntryString(C4CFN_CtrlRecText, &TextBuf))
+	{
+		if (!Playback.ReadText(TextBuf)) return false;
+	}
+	else if (!Grp.LoadEntry(C4CFN_CtrlRec, &BinaryBuf) || !Playback.ReadBinary(BinaryBuf))
+	{
+		LogF("Record: No control data found in %s!", szRecord);
+		return false;
+	}
+	// replace it by blocks
+	StdBuf RecordData;
+	if (!Playback.ReWriteBlocks(&RecordData) ||
+	    !Grp.Add(C4CFN_CtrlRecBlocks, RecordData, false, true) ||
+	    !Grp.Delete(C4CFN_CtrlRec "|" C4CFN_CtrlRecText) ||
+	    !Grp.Close())
+	{
+		LogF("Record: Could not convert %s: %s", szRecord, Grp.GetError());
+		return false;
+	}
+	LogF("Record: Converted %s (%lu chunks).", szRecord, static_cast<unsigned long>(Playback.chunks.size()));
+	return true;
+}
+
+bool C4Playback::FindKeyframe(const char *szRecord, int32_t iFrame, StdStrBuf *pKeyframe)
+{
+	C4Group Grp;
+	if (!Reloc.Open(Grp, szRecord)) return false;
+	StdStrBuf Entry; int32_t iBest = -1;
+	for (bool fFound = Grp.FindEntry(C4CFN_RecKeyframes, &Entry); fFound; fFound = Grp.FindNextEntry(C4CFN_RecKeyframes, &Entry))
+	{
+		int32_t iKeyframe = GetTrailingNumber(GetFilenameOnly(Entry.getData()));
+		if (iKeyframe <= iFrame && iKeyframe > iBest)
+		{
+			iBest = iKeyframe;
+			pKeyframe->Format("%s" DirSep "%s", Grp.GetFullName().getData(), Entry.getData());
+		}
+	}
+	return iBest >= 0;
+}
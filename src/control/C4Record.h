@@ -100,6 +100,22 @@ struct C4RecordChunkHead // record file chunk head
 	uint8_t Type; // chunk type
 };
 
+// Block records (C4CFN_CtrlRecBlocks) hold the same chunks as plain ones,
+// zlib compressed in blocks of a few hundred frames each.
+struct C4RecordBlockFileHead
+{
+	uint32_t Id; // C4RecordBlockFileId
+	uint32_t Ver; // C4RecordBlockFileVer
+};
+
+struct C4RecordBlockHead // followed by Size bytes of compressed chunks
+{
+	uint32_t Frame; // frame the frame difference of the first chunk refers to
+	uint32_t LastFrame; // frame of the last chunk
+	uint32_t Size; // compressed size
+	uint32_t RawSize; // uncompressed size
+};
+
 struct C4RecordChunk
 {
 	int32_t Frame;
@@ -224,6 +240,26 @@ struct C4RCOCF
 
 #pragma pack()
 
+const uint32_t C4RecordBlockFileId = 0x4252434f, // "OCRB"
+               C4RecordBlockFileVer = 1;
+const uint32_t C4RecordBlockFrames = 360, // frames after which a block is finished
+               C4RecordBlockSize = 64 * 1024; // uncompressed size after which a block is finished
+
+// Collects chunks into the compressed blocks of a block record
+class C4RecordBlockWriter
+{
+private:
+	StdBuf Data; // uncompressed chunks of the current block
+	StdBuf Output; // file head and finished blocks not taken yet
+	uint32_t iFrame{0}; // frame the current block starts from
+	uint32_t iLastFrame{0}; // frame of the last chunk added
+public:
+	void Init(); // start a new file
+	void Add(const C4RecordChunkHead &Head, const StdBuf &sBuf); // add a chunk; finishes the block if it is full
+	bool Flush(); // finish the current block
+	StdBuf &GetOutput() { return Output; }
+};
+
 // debug record packet
 class C4PktDebugRec : public C4PktBuf
 {
@@ -252,6 +288,10 @@ private:
 	bool fStreaming{false}; // perdiodically sent new control to server
 	unsigned int iStreamingPos; // Position of current buffer in stream
 	StdBuf StreamingData; // accumulated control data since last stream sync
+	bool fBlocks{false}; // write a block record instead of a plain one
+	C4RecordBlockWriter Blocks; // pending blocks if fBlocks is set
+	int32_t iLastKeyframe; // frame of the last keyframe saved or of the record start
+	int32_t iNextKeyframe; // frame before which no further keyframe is requested
 public:
 	C4Record(); // constructor; creates control file etc
 	C4Record(const char *szPlaybackFile, const char *szRecordFile, const char *szTempRecFile); // start recording from replay into record
@@ -271,6 +311,9 @@ public:
 
 	bool AddFile(const char *szLocalFilename, const char *szAddAs, bool fDelete = false);
 
+	bool KeyframeDue(int32_t iFrame); // whether the game should synchronize for a keyframe now; once per keyframe
+	bool SaveKeyframe(); // save the synchronized game state into the record
+
 	bool StartStreaming(bool fInitial);
 	void ClearStreamingBuf(unsigned int iAmount);
 	void StopStreaming();
@@ -280,6 +323,7 @@ public:
 private:
 	void Stream(const C4RecordChunkHead &Head, const StdBuf &sBuf);
 	bool StreamFile(const char *szFilename, const char *szAddAs);
+	bool WriteBlocks(); // write finished blocks to the control file
 };
 
 class C4Playback // demo playback
@@ -293,6 +337,17 @@ private:
 	bool fLoadSequential{false};  // used for debugrecs: Sequential reading of files
 	StdBuf sequentialBuffer; // buffer to manage sequential reads
 	uint32_t iLastSequentialFrame; // frame number of last chunk read
+	struct BlockIndexEntry
+	{
+		uint32_t Frame, LastFrame; // frame range of the block
+		size_t Offset; // position of the block head in the file
+	};
+	bool fLoadBlocks{false}; // reading a block record one block at a time
+	C4Group BlockGrp; // record group the blocks are read from
+	std::vector<BlockIndexEntry> BlockIndex; // all blocks of the record
+	size_t iNextBlock{0}; // index of the next block to read
+	int32_t iKeyframe{0}; // frame playback started from; earlier chunks are skipped
+	int32_t iSeekFrame{0}; // fast-forward until this frame
 	void Finish(); // end playback
 	C4PacketList DebugRec;
 public:
@@ -300,12 +355,16 @@ public:
 	~C4Playback(); // destructor; deinit playback
 
 	bool Open(C4Group &rGrp);
-	bool ReadBinary(const StdBuf &Buf);
+	bool ReadBinary(const StdBuf &Buf, uint32_t iBaseFrame = 0);
 	bool ReadText(const StdStrBuf &Buf);
+	bool OpenBlocks(const char *szRecord); // index the blocks of a record and find the first one to play
+	bool ReadBlock(); // append the chunks of the next block
 	void NextChunk(); // point to next prepared chunk in mem or read it
 	bool NextSequentialChunk(); // read from seq file until a new chunk has been filled
+	bool NextBlock(); // read blocks until a new chunk has been filled
 	StdStrBuf ReWriteText();
 	StdBuf ReWriteBinary();
+	bool ReWriteBlocks(StdBuf *pOutput);
 	void Strip();
 	bool ExecuteControl(C4Control *pCtrl, int iFrame); // assign control
 	bool IsFinished() { return Finished; }
@@ -313,6 +372,8 @@ public:
 	void Check(C4RecordChunkType eType, const uint8_t *pData, int iSize); // compare with debugrec
 	void DebugRecError(const char *szError);
 	static bool StreamToRecord(const char *szStream, StdStrBuf *pRecord);
+	static bool ConvertRecord(const char *szRecord); // replace the plain control record by a block record
+	static bool FindKeyframe(const char *szRecord, int32_t iFrame, StdStrBuf *pKeyframe); // last keyframe up to iFrame
 };
 
 #endif
@@ -0,0 +1,119 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// per-frame statistics of batch replays
+
+#include "C4Include.h"
+#include "control/C4ReplayStats.h"
+
+#include "control/C4Control.h"
+#include "game/C4Game.h"
+#include "landscape/C4Landscape.h"
+#include "landscape/C4MassMover.h"
+#include "landscape/C4PXS.h"
+#include "lib/C4Random.h"
+#include "object/C4GameObjects.h"
+#include "script/C4AulExec.h"
+
+bool C4ReplayStats::Init(const char *szFilename, int32_t iInterval)
+{
+	Clear();
+	if (!File.Create(szFilename))
+	{
+		LogF("Replay stats: Cannot create %s", szFilename);
+		return false;
+	}
+	fJSON = SEqualNoCase(GetExtension(szFilename), "json");
+	this->iInterval = std::max<int32_t>(iInterval, 1);
+	// time the engine from now on
+	C4Stat::Enabled = true;
+	for (C4Stat *pStat = C4Stat::getMainStat()->GetFirst(); pStat; pStat = pStat->GetNext())
+		Stats.push_back({ pStat, pStat->GetCount(), pStat->GetTimeSum() });
+	iScriptCalls = AulExec.GetScriptCallCount();
+	iEngineCalls = AulExec.GetEngineCallCount();
+	tLast = std::chrono::steady_clock::now();
+	if (!fJSON) WriteHeader();
+	LogF("Replay stats: Writing to %s every %d frames", szFilename, (int) this->iInterval);
+	return true;
+}
+
+void C4ReplayStats::Clear()
+{
+	if (File.IsOpen()) File.Close();
+	Stats.clear();
+	iLastFrame = -1;
+}
+
+void C4ReplayStats::ExecuteFrame()
+{
+	if (File.IsOpen() && !(Game.FrameCounter % iInterval))
+		WriteFrame();
+}
+
+void C4ReplayStats::Finish()
+{
+	if (!File.IsOpen()) return;
+	if (iLastFrame != Game.FrameCounter) WriteFrame();
+	LogF("Replay stats: Record ended at frame %d", (int) Game.FrameCounter);
+	Clear();
+}
+
+void C4ReplayStats::WriteHeader()
+{
+	// stats registered later (e.g. drawing) are left out of the columns
+	StdStrBuf sLine("frame,time_ms");
+	for (StatValue &stat : Stats)
+		sLine.AppendFormat(R"(,"%s n","%s us")", stat.pStat->GetName(), stat.pStat->GetName());
+	sLine.Append(",objects,pxs,massmover,script_calls,engine_calls,random_count,crew_pos_x,object_enumeration,sect_shape_sum,landscape_hash\n");
+	File.Write(sLine.getData(), sLine.getLength());
+}
+
+void C4ReplayStats::WriteFrame()
+{
+	iLastFrame = Game.FrameCounter;
+	auto tNow = std::chrono::steady_clock::now();
+	double dTime = std::chrono::duration<double, std::milli>(tNow - tLast).count();
+	tLast = tNow;
+	StdStrBuf sLine;
+	if (fJSON)
+		sLine.Format(R"({"frame":%d,"time_ms":%.3f,"stats":{)", (int) Game.FrameCounter, dTime);
+	else
+		sLine.Format("%d,%.3f", (int) Game.FrameCounter, dTime);
+	// timings since the last output
+	bool fFirst = true;
+	for (StatValue &stat : Stats)
+	{
+		unsigned int iCount = stat.pStat->GetCount() - stat.iCount;
+		unsigned long long iTime = stat.pStat->GetTimeSum() - stat.iTime;
+		if (fJSON)
+			sLine.AppendFormat(R"(%s"%s":{"n":%u,"us":%llu})", fFirst ? "" : ",", stat.pStat->GetName(), iCount, iTime);
+		else
+			sLine.AppendFormat(",%u,%llu", iCount, iTime);
+		stat.iCount = stat.pStat->GetCount();
+		stat.iTime = stat.pStat->GetTimeSum();
+		fFirst = false;
+	}
+	unsigned long long iScriptCallDiff = AulExec.GetScriptCallCount() - iScriptCalls;
+	unsigned long long iEngineCallDiff = AulExec.GetEngineCallCount() - iEngineCalls;
+	iScriptCalls = AulExec.GetScriptCallCount();
+	iEngineCalls = AulExec.GetEngineCallCount();
+	// the values of a sync check, without taking the changed landscape tiles
+	const char *szFormat = fJSON ?
+		R"(},"objects":%d,"pxs":%d,"massmover":%d,"script_calls":%llu,"engine_calls":%llu,"random_count":%d,"crew_pos_x":%d,"object_enumeration":%d,"sect_shape_sum":%d,"landscape_hash":%u})" "\n" :
+		",%d,%d,%d,%llu,%llu,%d,%d,%d,%d,%u\n";
+	sLine.AppendFormat(szFormat, (int) ::Objects.ObjectCount(), (int) ::PXS.GetCount(), (int) ::MassMover.CreatePtr,
+		iScriptCallDiff, iEngineCallDiff, (int) ::RandomCount, (int) C4ControlSyncCheck::GetAllCrewPosX(),
+		(int) C4PropListNumbered::GetEnumerationIndex(), ::Objects.Sectors.getShapeSum(), (unsigned int) ::Landscape.GetHash());
+	File.Write(sLine.getData(), sLine.getLength());
+}
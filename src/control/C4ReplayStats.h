@@ -0,0 +1,61 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+// per-frame statistics of batch replays
+
+#ifndef INC_C4ReplayStats
+#define INC_C4ReplayStats
+
+#include "c4group/CStdFile.h"
+#include "lib/C4Stat.h"
+
+#include <chrono>
+
+// Replays a record as fast as possible and writes engine timings, object
+// counts, script calls and sync values every few frames. Output is CSV, or
+// one JSON object per line if the file name ends with .json.
+class C4ReplayStats
+{
+public:
+	C4ReplayStats() = default;
+	~C4ReplayStats() { Clear(); }
+
+	bool Init(const char *szFilename, int32_t iInterval);
+	void Clear();
+
+	void ExecuteFrame(); // called after each game frame
+	void Finish(); // called at the end of the record
+
+private:
+	// values at the last output, to write differences
+	struct StatValue
+	{
+		C4Stat *pStat;
+		unsigned int iCount;
+		uint64_t iTime;
+	};
+
+	CStdFile File;
+	bool fJSON{false};
+	int32_t iInterval{100};
+	int32_t iLastFrame{-1};
+	std::vector<StatValue> Stats;
+	uint64_t iScriptCalls{0}, iEngineCalls{0};
+	std::chrono::steady_clock::time_point tLast;
+
+	void WriteHeader();
+	void WriteFrame();
+};
+
+#endif // INC_C4ReplayStats
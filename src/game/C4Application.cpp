@@ -22,6 +22,7 @@
 #include "game/C4Application.h"
 
 #include "C4Version.h"
+#include "control/C4Record.h"
 #include "editor/C4Console.h"
 #include "game/C4FullScreen.h"
 #include "game/C4GraphicsSystem.h"
@@ -36,6 +37,7 @@
 #endif
 #include "gui/C4Startup.h"
 #include "landscape/C4Particles.h"
+#include "network/C4GameControlNetwork.h"
 #include "network/C4Network2.h"
 #include "network/C4Network2IRC.h"
 #include "platform/C4GamePadCon.h"
@@ -214,6 +216,7 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			{"editor", no_argument, &isEditor, 1},
 			{"fullscreen", no_argument, &isEditor, 0},
 			{"debugwait", no_argument, &Game.DebugWait, 1},
+			{"startup-timing", no_argument, &Game.StartupTiming, 1},
 			{"update", no_argument, &CheckForUpdates, 1},
 			{"noruntimejoin", no_argument, &Config.Network.NoRuntimeJoin, 1},
 			{"runtimejoin", no_argument, &Config.Network.NoRuntimeJoin, 0},
@@ -234,6 +237,12 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 			{"startup", required_argument, nullptr, 's'},
 			{"stream", required_argument, nullptr, 'e'},
 			{"recdump", required_argument, nullptr, 'R'},
+			{"recconvert", required_argument, nullptr, 'C'},
+			{"seek", required_argument, nullptr, 'F'},
+			{"keyframes", required_argument, nullptr, 'k'},
+			{"replaystats", required_argument, nullptr, 'x'},
+			{"statsinterval", required_argument, nullptr, 'i'},
+			{"controlbench", required_argument, nullptr, 'B'},
 			{"comment", required_argument, nullptr, 'm'},
 			{"pass", required_argument, nullptr, 'p'},
 			{"udpport", required_argument, nullptr, 'u'},
@@ -338,6 +347,22 @@ void C4Application::ParseCommandLine(int argc, char * argv[])
 		case 'R': Game.RecordDumpFile.Copy(optarg); break;
 		// record stream
 		case 'e': Game.RecordStream.Copy(optarg); break;
+		// convert an old record to a block record
+		case 'C':
+			C4Playback::ConvertRecord(optarg);
+			Quit();
+			break;
+		// replay seeking and keyframes
+		case 'F': Game.RecordSeekFrame = atoi(optarg); break;
+		case 'k': Config.General.RecordKeyframes = std::max(atoi(optarg), 0); break;
+		// batch replay with statistics
+		case 'x': Game.RecordStatsFile.Copy(optarg); break;
+		case 'i': Game.RecordStatsInterval = std::max(atoi(optarg), 1); break;
+		// network control format benchmark
+		case 'B':
+			C4PacketControlPacked::Benchmark(atoi(optarg));
+			Quit();
+			break;
 		// startup start screen
 		case 's': C4Startup::SetStartScreen(optarg); break;
 		// additional read-only data path
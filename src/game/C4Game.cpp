@@ -28,6 +28,7 @@
 #include "control/C4PlayerControl.h"
 #include "control/C4PlayerInfo.h"
 #include "control/C4Record.h"
+#include "control/C4ReplayStats.h"
 #include "control/C4RoundResults.h"
 #include "editor/C4Console.h"
 #include "game/C4Application.h"
@@ -78,6 +79,7 @@
 #include "script/C4AulExec.h"
 #include "script/C4Effect.h"
 
+#include <chrono>
 #include <unordered_map>
 
 class C4GameSec1Timer : public C4ApplicationSec1Timer
@@ -195,6 +197,11 @@ bool C4Game::OpenScenario()
 		LogFatal(LoadResStr("IDS_PRC_NOC4S"));
 		return false;
 	}
+
+	// Seeking in a record: start from its last keyframe before the target frame
+	StdStrBuf Keyframe;
+	if (RecordSeekFrame > 0 && C4Playback::FindKeyframe(ScenarioFilename, RecordSeekFrame, &Keyframe))
+		SCopy(Keyframe.getData(), ScenarioFilename, _MAX_PATH);
 	LogF(LoadResStr("IDS_PRC_LOADC4S"),ScenarioFilename);
 
 	// get parent folder, if it's ocf
@@ -628,6 +635,19 @@ bool C4Game::Init()
 	// start statistics (always for now. Make this a config?)
 	pNetworkStatistics = std::make_unique<C4Network2Stats>();
 
+	// batch replay: run as fast as possible and write statistics
+	if (RecordStatsFile.getLength() && Control.isReplay())
+	{
+		pReplayStats = std::make_unique<C4ReplayStats>();
+		if (!pReplayStats->Init(RecordStatsFile.getData(), RecordStatsInterval))
+			pReplayStats.reset();
+		else
+		{
+			FullSpeed = true;
+			FrameSkip = 500;
+		}
+	}
+
 	// clear loader screen
 	if (GraphicsSystem.pLoaderScreen)
 	{
@@ -694,6 +714,7 @@ void C4Game::Clear()
 
 	// stop statistics
 	pNetworkStatistics.reset();
+	pReplayStats.reset();
 	C4AulProfiler::Abort();
 
 	// next mission (shoud have been transferred to C4Application now if next mission was desired)
@@ -724,6 +745,9 @@ void C4Game::Clear()
 	GameText.Clear();
 	RecordDumpFile.Clear();
 	RecordStream.Clear();
+	RecordSeekFrame = 0;
+	RecordStatsFile.Clear();
+	RecordStatsInterval = 100;
 
 #ifdef WITH_QT_EDITOR
 	// clear console pointers held into script engine
@@ -913,6 +937,9 @@ bool C4Game::Execute() // Returns true if the game is over
 
 	// Game
 
+	// FindObject results are cached for one frame at most
+	Objects.SearchCache.Clear();
+
 	EXEC_S(     ExecObjects();                    , ExecObjectsStat )
 	EXEC_S_DR(  C4Effect::Execute(&ScriptEngine.pGlobalEffects);
 	            C4Effect::Execute(&GameScript.pScenarioEffects);
@@ -930,6 +957,11 @@ bool C4Game::Execute() // Returns true if the game is over
 
 	Control.DoSyncCheck();
 
+	if (pReplayStats)
+	{
+		pReplayStats->ExecuteFrame();
+	}
+
 	// Evaluation; Game over dlg
 	if (GameOver)
 	{
@@ -1429,23 +1461,21 @@ C4Object* C4Game::FindConstuctionSiteBlock(int32_t x, int32_t y, int32_t wdt, in
 	search_area.Hgt = hgt;
 
 	C4LArea Area(&::Objects.Sectors, x, y, wdt, hgt);
-	C4LSector *sector;
+	C4LSectors::Buffer objects(::Objects.Sectors);
+	Area.GetObjectShapes(objects.Objects, true);
 
-	for (C4ObjectList *objects = Area.FirstObjectShapes(&sector); sector; objects = Area.NextObjectShapes(objects, &sector))
+	for (C4Object *obj : objects.Objects)
 	{
-		for (C4Object *obj : *objects)
+		if (obj->Status && !obj->Contained)
 		{
-			if (obj->Status && !obj->Contained)
+			if (obj->OCF & OCF_Exclusive)
 			{
-				if (obj->OCF & OCF_Exclusive)
+				C4Rect blocking_area = obj->Shape;
+				blocking_area.x += obj->GetX();
+				blocking_area.y += obj->GetY();
+				if (search_area.Overlap(blocking_area))
 				{
-					C4Rect blocking_area = obj->Shape;
-					blocking_area.x += obj->GetX();
-					blocking_area.y += obj->GetY();
-					if (search_area.Overlap(blocking_area))
-					{
-						return obj;
-					}
+					return obj;
 				}
 			}
 		}
@@ -1857,6 +1887,7 @@ void C4Game::Default()
 	DebugPassword.Clear();
 	DebugHost.Clear();
 	DebugWait = false;
+	StartupTiming = false;
 	assert(!ScriptGuiRoot);
 	ScriptGuiRoot.reset();
 }
@@ -3035,13 +3066,16 @@ bool C4Game::InitScriptEngine()
 bool C4Game::LinkScriptEngine()
 {
 	// Link script engine (resolve includes/appends, generate code)
+	auto link_start = std::chrono::steady_clock::now();
 	ScriptEngine.Link(&::Definitions);
+	float link_time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - link_start).count();
 
 	// display errors
 	LogF("C4AulScriptEngine linked - %d line%s, %d warning%s, %d error%s",
 		ScriptEngine.lineCnt, (ScriptEngine.lineCnt != 1 ? "s" : ""),
 		ScriptEngine.warnCnt, (ScriptEngine.warnCnt != 1 ? "s" : ""),
 		ScriptEngine.errCnt, (ScriptEngine.errCnt != 1 ? "s" : ""));
+	if (StartupTiming) ::Definitions.LogLoadTiming(link_time);
 
 	// update material pointers
 	::MaterialMap.UpdateScriptPointers();
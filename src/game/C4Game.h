@@ -93,6 +93,7 @@ public:
 	C4PlayerControlAssignmentSets PlayerControlUserAssignmentSets, PlayerControlDefaultAssignmentSets;
 	C4Scoreboard        Scoreboard;
 	std::unique_ptr<C4Network2Stats> pNetworkStatistics; // may be nullptr if no statistics are recorded
+	std::unique_ptr<C4ReplayStats> pReplayStats; // only for batch replays with --replaystats
 	C4KeyboardInput &KeyboardInput;
 	std::unique_ptr<C4FileMonitor> pFileMonitor;
 	std::unique_ptr<C4GameSec1Timer> pSec1Timer;
@@ -124,6 +125,9 @@ public:
 	bool Record;
 	StdStrBuf RecordDumpFile;
 	StdStrBuf RecordStream;
+	int32_t RecordSeekFrame{0}; // replays fast-forward to this frame from the last keyframe before it
+	StdStrBuf RecordStatsFile; // replays run at full speed and write statistics into this file
+	int32_t RecordStatsInterval{100};
 	StdStrBuf TempScenarioFile;
 	bool fPreinited{false}; // set after PreInit has been called; unset by Clear and Default
 	int32_t FrameCounter;
@@ -147,6 +151,7 @@ public:
 	StdCopyStrBuf NextMission, NextMissionText, NextMissionDesc;
 	// debug settings
 	uint16_t DebugPort; StdStrBuf DebugPassword, DebugHost; int DebugWait;
+	int StartupTiming; // log a breakdown of definition loading and script linking times
 
 	// Init and execution
 	void Clear();
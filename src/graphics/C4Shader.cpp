@@ -766,7 +766,7 @@ std::unique_ptr<C4ScriptUniform::Popper> C4ScriptUniform::Push(C4PropList* propl
 	uniformStack.emplace();
 	auto& uniforms = uniformStack.top();
 	Uniform u;
-	for (const C4Property* prop : *ulist.getPropList())
+	for (C4PropList::Iterator::Entry prop : *ulist.getPropList())
 	{
 		if (!prop->Key) continue;
 		switch (prop->Value.GetType())
@@ -46,6 +46,8 @@ class CStdGLCtx;
 extern CStdGL *pGL;
 #endif
 
+class CPNGFile;
+
 const int C4SF_Tileable = 1;
 const int C4SF_MipMap   = 2;
 const int C4SF_Unlocked = 4;
@@ -123,10 +125,21 @@ public:
 	bool SavePNG(C4Group &hGroup, const char *szFilename, bool fSaveAlpha=true, bool fSaveOverlayOnly=false);
 	bool SavePNG(const char *szFilename, bool fSaveAlpha, bool fSaveOverlayOnly, bool use_background_thread);
 	bool Read(CStdStream &hGroup, const char * extension, int iFlags);
+	bool Read(const BYTE *pData, size_t iSize, const char * extension, int iFlags); // png and jpeg only
+	bool ReadEntry(C4Group &hGroup, const char *szFilename, int iFlags); // decodes from a mapped view of the entry if possible
 	bool ReadPNG(CStdStream &hGroup, int iFlags);
+	bool ReadPNG(const BYTE *pData, size_t iSize, int iFlags);
 	bool ReadJPEG(CStdStream &hGroup, int iFlags);
+	bool ReadJPEG(const BYTE *pData, size_t iSize, int iFlags);
+	bool ReadPNG(CPNGFile &png, int iFlags); // create from decoded image
 	bool ReadBMP(CStdStream &hGroup, int iFlags);
 
+	// PNG files decoded ahead of time, e.g. by definition loader threads. ReadEntry takes
+	// them from here instead of loading and decoding the file again. Main thread only.
+	static void AddDecodedPNG(const char *szPath, std::unique_ptr<CPNGFile> png);
+	static std::unique_ptr<CPNGFile> TakeDecodedPNG(C4Group &hGroup, const char *szFilename);
+	static void ClearDecodedPNGs();
+
 	bool AttachPalette();
 	bool GetSurfaceSize(int &irX, int &irY); // get surface size
 	void SetClr(DWORD toClr) { ClrByOwnerClr=toClr; }
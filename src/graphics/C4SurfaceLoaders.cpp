@@ -25,6 +25,8 @@
 #include "graphics/StdPNG.h"
 #include "lib/StdColors.h"
 
+#include <unordered_map>
+
 bool C4Surface::LoadAny(C4Group &hGroup, const char *szName, bool fOwnPal, bool fNoErrIfNotFound, int iFlags)
 {
 	// Entry name
@@ -116,14 +118,14 @@ bool C4Surface::Load(C4Group &hGroup, const char *szFilename, bool, bool fNoErrI
 			}
 		}
 	}
-	// Access entry
-	if (!hGroup.AccessEntry(szFilename))
+	// Find entry
+	if (!hGroup.FindEntry(szFilename))
 	{
 		// file not found
 		if (!fNoErrIfNotFound) LogF("%s: %s%c%s", LoadResStr("IDS_PRC_FILENOTFOUND"), hGroup.GetFullName().getData(), (char) DirectorySeparator, szFilename);
 		return false;
 	}
-	bool fSuccess = Read(hGroup, GetExtension(szFilename), iFlags);
+	bool fSuccess = ReadEntry(hGroup, szFilename, iFlags);
 	// loading error? log!
 	if (!fSuccess)
 		LogF("%s: %s%c%s", LoadResStr("IDS_ERR_NOFILE"), hGroup.GetFullName().getData(), (char) DirectorySeparator, szFilename);
@@ -147,20 +149,84 @@ bool C4Surface::Read(CStdStream &hGroup, const char * extension, int iFlags)
 		return false;
 }
 
+bool C4Surface::Read(const BYTE *pData, size_t iSize, const char * extension, int iFlags)
+{
+	if (SEqualNoCase(extension, "png"))
+		return ReadPNG(pData, iSize, iFlags);
+	else if (SEqualNoCase(extension, "jpeg")
+	         || SEqualNoCase(extension, "jpg"))
+		return ReadJPEG(pData, iSize, iFlags);
+	else
+		return false;
+}
+
+namespace
+{
+	std::unordered_map<std::string, std::unique_ptr<CPNGFile>> DecodedPNGs;
+
+	std::string DecodedPNGKey(const char *szPath)
+	{
+		std::string key(szPath);
+		for (char &c : key)
+			c = (c == AltDirectorySeparator) ? DirectorySeparator : tolower(static_cast<unsigned char>(c));
+		return key;
+	}
+}
+
+void C4Surface::AddDecodedPNG(const char *szPath, std::unique_ptr<CPNGFile> png)
+{
+	DecodedPNGs[DecodedPNGKey(szPath)] = std::move(png);
+}
+
+std::unique_ptr<CPNGFile> C4Surface::TakeDecodedPNG(C4Group &hGroup, const char *szFilename)
+{
+	if (DecodedPNGs.empty()) return nullptr;
+	auto it = DecodedPNGs.find(DecodedPNGKey(FormatString("%s%c%s", hGroup.GetFullName().getData(), DirectorySeparator, szFilename).getData()));
+	if (it == DecodedPNGs.end()) return nullptr;
+	std::unique_ptr<CPNGFile> png = std::move(it->second);
+	DecodedPNGs.erase(it);
+	return png;
+}
+
+void C4Surface::ClearDecodedPNGs()
+{
+	DecodedPNGs.clear();
+}
+
+bool C4Surface::ReadEntry(C4Group &hGroup, const char *szFilename, int iFlags)
+{
+	const char *extension = GetExtension(szFilename);
+	// decoded ahead of time?
+	if (std::unique_ptr<CPNGFile> png = TakeDecodedPNG(hGroup, szFilename))
+		return ReadPNG(*png, iFlags);
+	// bitmaps are read as a stream
+	if (SEqualNoCase(extension, "bmp"))
+		return hGroup.AccessEntry(szFilename) && ReadBMP(hGroup, iFlags);
+	// decode everything else straight from the group's memory if possible
+	StdBuf Data;
+	if (!hGroup.LoadEntryView(szFilename, &Data)) return false;
+	return Read(static_cast<const BYTE *>(Data.getData()), Data.getSize(), extension, iFlags);
+}
+
 bool C4Surface::ReadPNG(CStdStream &hGroup, int iFlags)
 {
-	// create mem block
-	int iSize=hGroup.AccessedEntrySize();
-	BYTE *pData=new BYTE[iSize];
 	// load file into mem
-	hGroup.Read((void *) pData, iSize);
+	StdBuf Data;
+	Data.New(hGroup.AccessedEntrySize());
+	if (!hGroup.Read(Data.getMData(), Data.getSize())) return false;
+	return ReadPNG(static_cast<const BYTE *>(Data.getData()), Data.getSize(), iFlags);
+}
+
+bool C4Surface::ReadPNG(const BYTE *pData, size_t iSize, int iFlags)
+{
 	// load as png file
 	CPNGFile png;
-	bool fSuccess=png.Load(pData, iSize);
-	// free data
-	delete [] pData;
-	// abort if loading wasn't successful
-	if (!fSuccess) return false;
+	if (!png.Load(pData, iSize)) return false;
+	return ReadPNG(png, iFlags);
+}
+
+bool C4Surface::ReadPNG(CPNGFile &png, int iFlags)
+{
 	// create surface(s) - do not create an 8bit-buffer!
 	if (!Create(png.iWdt, png.iHgt, iFlags)) return false;
 	// lock for writing data
@@ -207,7 +273,7 @@ bool C4Surface::ReadPNG(CStdStream &hGroup, int iFlags)
 	texture->Unlock();
 	Unlock();
 	// return if successful
-	return fSuccess;
+	return true;
 }
 
 bool C4Surface::SavePNG(C4Group &hGroup, const char *szFilename, bool fSaveAlpha, bool fSaveOverlayOnly)
@@ -283,11 +349,15 @@ static void skip_input_data (j_decompress_ptr cinfo, long num_bytes)
 
 bool C4Surface::ReadJPEG(CStdStream &hGroup, int iFlags)
 {
-	// create mem block
-	size_t size=hGroup.AccessedEntrySize();
-	unsigned char *pData=new unsigned char[size];
 	// load file into mem
-	hGroup.Read(pData, size);
+	StdBuf Data;
+	Data.New(hGroup.AccessedEntrySize());
+	if (!hGroup.Read(Data.getMData(), Data.getSize())) return false;
+	return ReadJPEG(static_cast<const BYTE *>(Data.getData()), Data.getSize(), iFlags);
+}
+
+bool C4Surface::ReadJPEG(const BYTE *pData, size_t size, int iFlags)
+{
 	// stuff for libjpeg
 	struct jpeg_decompress_struct cinfo;
 	struct my_error_mgr jerr;
@@ -302,7 +372,6 @@ bool C4Surface::ReadJPEG(CStdStream &hGroup, int iFlags)
 	{
 		// some fatal error
 		jpeg_destroy_decompress(&cinfo);
-		delete [] pData;
 		return false;
 	}
 	jpeg_create_decompress(&cinfo);
@@ -351,8 +420,6 @@ bool C4Surface::ReadJPEG(CStdStream &hGroup, int iFlags)
 	// clean up
 	jpeg_finish_decompress(&cinfo);
 	jpeg_destroy_decompress(&cinfo);
-	// free data
-	delete [] pData;
 	// return if successful
 	return true;
 }
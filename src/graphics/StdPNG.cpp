@@ -29,7 +29,8 @@ void PNGAPI CPNGFile::CPNGReadFn(png_structp png_ptr, png_bytep data, size_t len
 
 void CPNGFile::Read(unsigned char *pData, int iLength)
 {
-	// fixme: overflow check schould be done here
+	// the file may be a read-only view, so never read past its end
+	if (iLength > iFileSize - (pFilePtr - pFile)) png_error(png_ptr, "Unexpected end of file");
 	// simply copy into buffer
 	memcpy(pData, pFilePtr, iLength);
 	// advance file ptr
@@ -41,7 +42,7 @@ bool CPNGFile::DoLoad()
 	// reset file ptr
 	pFilePtr=pFile;
 	// check file
-	if (png_sig_cmp((unsigned char *) pFilePtr, 0, 8)) return false;
+	if (iFileSize < 8 || png_sig_cmp(pFilePtr, 0, 8)) return false;
 	// setup png for reading
 	fWriteMode=false;
 	png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
@@ -152,7 +153,7 @@ void CPNGFile::Clear()
 	if (fp) { fclose(fp); fp=nullptr; }
 }
 
-bool CPNGFile::Load(unsigned char *pFile, int iSize)
+bool CPNGFile::Load(const unsigned char *pFile, int iSize)
 {
 	// clear any previously loaded file
 	Clear();
@@ -46,6 +46,7 @@
 #include "object/C4Def.h"
 #include "object/C4FindObject.h"
 #include "object/C4GameObjects.h"
+#include "platform/C4ThreadPool.h"
 
 #include <array>
 
@@ -73,6 +74,9 @@ struct C4Landscape::P
 
 	bool NoScan = false; // ExecuteScan() disabled
 	int32_t ScanX = 0, ScanSpeed = 2; // SyncClearance-NoSave //
+	std::array<uint8_t, C4MaxMaterial> ScanConversions{}; // NoSave // directions DoScan converts each material in, as bits 1 << dir
+	std::vector<std::vector<int32_t>> ScanEvents; // NoSave // rows of the material boundaries DoScan might convert at, per column of this frame
+	std::vector<std::pair<int32_t, int32_t>> ScanDirty; // NoSave // rows per column of this frame that might have changed since finding its events
 	C4Real Gravity = DefaultGravAccel;
 	uint32_t Modulation = 0;    // landscape blit modulation; 0 means normal
 	int32_t MapSeed = 0; // random seed for MapToLandscape
@@ -82,10 +86,26 @@ struct C4Landscape::P
 	std::unique_ptr<BYTE[]> pInitial; // Initial landscape after creation - used for diff
 	std::unique_ptr<BYTE[]> pInitialBkg; // Initial bkg landscape after creation - used for diff
 	std::unique_ptr<C4FoW> pFoW;
+	// Tile hashes and change flags
+	enum { TileChangedSinceSync = 1, TileChangedSinceInitial = 2 };
+	int32_t HashTilesX = 0, HashTilesY = 0;
+	std::vector<uint32_t> TileHashes; // NoSave //
+	std::vector<uint8_t> TileChanges; // NoSave //
+	std::vector<int32_t> SyncChangedTiles; // NoSave // tiles flagged TileChangedSinceSync
+	uint32_t Hash = 0; // NoSave // all tile hashes combined
 
 	void ClearMatCount();
 
+	void InitTileHashes(const C4Landscape *d);
+	void UpdateTileHashes(const C4Landscape *d, const C4Rect &BoundingBox);
+	void UpdatePixHash(int32_t x, int32_t y, BYTE oldFgPix, BYTE oldBgPix, BYTE fgPix, BYTE bgPix);
+	void MarkTileChanged(int32_t tile);
+	int32_t GetHashTileCount() const { return HashTilesX * HashTilesY; }
+	bool IsTileChangedSinceInitial(int32_t tile) const { return TileChanges.empty() || (TileChanges[tile] & TileChangedSinceInitial); }
+
 	void ExecuteScan(C4Landscape *);
+	void FindScanEvents(const C4Landscape *, int32_t x, std::vector<int32_t> &events) const;
+	void CommitScanEvents(C4Landscape *, int32_t first_x, int32_t columns, int32_t index);
 	int32_t DoScan(C4Landscape *, int32_t x, int32_t y, int32_t mat, int32_t dir);
 	uint32_t ChunkyRandom(uint32_t &iOffset, uint32_t iRange) const; // return static random value, according to offset and MapSeed
 	void DrawChunk(C4Landscape *, int32_t tx, int32_t ty, int32_t wdt, int32_t hgt, uint8_t mcol, uint8_t mcolBkg, C4MaterialCoreShape Shape, uint32_t cro);
@@ -217,6 +237,18 @@ void C4Landscape::Execute()
 }
 
 
+namespace
+{
+	// Columns per task when looking for scan events on worker threads
+	const int32_t ScanStripeWidth = 32;
+	// Below this many columns per frame, the scan runs on the main thread only
+	const int32_t ParallelScanMinColumns = 2 * ScanStripeWidth;
+	// How far from its column a conversion may change the landscape: DoScan only sets
+	// pixels in its own column, but CheckInstability clears single pixels around them
+	// up to ten steps further.
+	const int32_t ScanChangeRange = 12;
+}
+
 void C4Landscape::P::ExecuteScan(C4Landscape *d)
 {
 	int32_t cy, mat;
@@ -239,9 +271,38 @@ void C4Landscape::P::ExecuteScan(C4Landscape *d)
 	if (DEBUGREC_MATSCAN && Config.General.DebugRec)
 		AddDbgRec(RCT_MatScan, &ScanX, sizeof(ScanX));
 
-	for (int32_t cnt = 0; cnt < ScanSpeed; cnt++)
+	const int32_t columns = std::min(ScanSpeed, Width);
+	C4ThreadPool &pool = C4ThreadPool::Default();
+	if (columns >= ParallelScanMinColumns && pool.GetThreadCount())
 	{
+		// Find the material boundaries that might get converted in stripes of columns
+		// on worker threads, which only read the landscape. Then convert in the same
+		// order as the scan below, so the result is the same on any number of threads.
+		for (mat = 0; mat < ::MaterialMap.Num; mat++)
+		{
+			const C4Material &material = ::MaterialMap.Map[mat];
+			ScanConversions[mat] = 0;
+			if (material.BelowTempConvertTo && iTemperature < material.BelowTempConvert)
+				ScanConversions[mat] |= 1 << material.BelowTempConvertDir;
+			if (material.AboveTempConvertTo && iTemperature > material.AboveTempConvert)
+				ScanConversions[mat] |= 1 << material.AboveTempConvertDir;
+		}
+		if (ScanEvents.size() < size_t(columns)) ScanEvents.resize(columns);
+		ScanDirty.assign(columns, std::make_pair(INT32_MAX / 2, INT32_MIN / 2));
+		const int32_t first_x = ScanX;
+		pool.ParallelFor((columns + ScanStripeWidth - 1) / ScanStripeWidth, [this, d, columns, first_x](size_t stripe)
+		{
+			for (int32_t i = stripe * ScanStripeWidth; i < std::min<int32_t>(columns, (stripe + 1) * ScanStripeWidth); ++i)
+				FindScanEvents(d, (first_x + i) % Width, ScanEvents[i]);
+		});
+		for (int32_t i = 0; i < columns; ++i)
+			CommitScanEvents(d, first_x, columns, i);
+		ScanX = (first_x + columns) % Width;
+		return;
+	}
 
+	for (int32_t cnt = 0; cnt < columns; cnt++)
+	{
 		// Scan landscape column: sectors down
 		int32_t last_mat = -1;
 		for (cy = 0; cy < Height; cy++)
@@ -259,17 +320,96 @@ void C4Landscape::P::ExecuteScan(C4Landscape *d)
 			}
 			last_mat = mat;
 		}
-
 		// Scan advance & rewind
 		ScanX++;
 		if (ScanX >= Width)
 			ScanX = 0;
-
 	}
+}
 
+void C4Landscape::P::FindScanEvents(const C4Landscape *d, int32_t x, std::vector<int32_t> &events) const
+{
+	// Where the scan would call DoScan with something to convert, as long as the column stays the same
+	events.clear();
+	int32_t last_mat = -1;
+	for (int32_t cy = 0; cy < Height; cy++)
+	{
+		int32_t mat = d->_GetMat(x, cy);
+		if (last_mat != mat)
+		{
+			if ((last_mat != -1 && (ScanConversions[last_mat] & 2)) || (mat != -1 && (ScanConversions[mat] & 1)))
+				events.push_back(cy);
+			last_mat = mat;
+		}
+	}
 }
 
-#define PRETTY_TEMP_CONV
+void C4Landscape::P::CommitScanEvents(C4Landscape *d, int32_t first_x, int32_t columns, int32_t index)
+{
+	// Scan the column like ExecuteScan, but jump from one event to the next where
+	// the column hasn't changed since the events were found. DoScan changes nothing
+	// unless it converts a pixel, so there's nothing to do in between.
+	const int32_t x = (first_x + index) % Width;
+	const std::vector<int32_t> &events = ScanEvents[index];
+	std::pair<int32_t, int32_t> &dirty = ScanDirty[index];
+	auto mark_dirty = [this, first_x, columns, index, x](int32_t y0, int32_t y1)
+	{
+		for (int32_t cx = std::max(x - ScanChangeRange, 0); cx <= std::min(x + ScanChangeRange, Width - 1); ++cx)
+		{
+			// Columns scanned before this one are done already
+			int32_t i = (cx - first_x + Width) % Width;
+			if (i < index || i >= columns) continue;
+			ScanDirty[i].first = std::min(ScanDirty[i].first, y0 - ScanChangeRange);
+			ScanDirty[i].second = std::max(ScanDirty[i].second, y1 + ScanChangeRange);
+		}
+	};
+	size_t next_event = 0;
+	bool walking = false;
+	int32_t cy = 0, last_mat = -1;
+	while (cy < Height)
+	{
+		if (!walking)
+		{
+			while (next_event < events.size() && events[next_event] < cy) ++next_event;
+			int32_t next_y = next_event < events.size() ? events[next_event] : Height, skip_to;
+			if (dirty.first <= std::min(next_y, Height - 1) && dirty.second >= cy - 1)
+			{
+				// Changed rows before the next event: go through them pixel by pixel
+				walking = true;
+				skip_to = std::max(cy, dirty.first);
+			}
+			else if (next_y < Height)
+				skip_to = next_y;
+			else
+				break;
+			// Nothing in between was converted, so the skipped pixels are as found
+			if (skip_to != cy)
+			{
+				cy = skip_to;
+				last_mat = d->_GetMat(x, cy - 1);
+			}
+		}
+		int32_t mat = d->_GetMat(x, cy);
+		if (last_mat != mat)
+		{
+			int32_t converted;
+			if (last_mat != -1)
+				if ((converted = DoScan(d, x, cy - 1, last_mat, 1)))
+					mark_dirty(cy - converted, cy - 1);
+			if (mat != -1)
+				if ((converted = DoScan(d, x, cy, mat, 0)))
+				{
+					mark_dirty(cy, cy + converted - 1);
+					cy += converted;
+				}
+		}
+		last_mat = mat;
+		cy++;
+		// Past all changes, the events are right again
+		if (walking && cy - 1 > dirty.second && cy < Height && last_mat == d->_GetMat(x, cy - 1))
+			walking = false;
+	}
+}
 
 int32_t C4Landscape::P::DoScan(C4Landscape *d, int32_t cx, int32_t cy, int32_t mat, int32_t dir)
 {
@@ -862,6 +1002,7 @@ bool C4Landscape::_SetPix2(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 			}
 		}
 	}
+	p->UpdatePixHash(x, y, opix, p->Surface8Bkg->_GetPix(x, y), fgPix, bgPix);
 	// set 8bpp-surface only!
 	p->Surface8->SetPix(x, y, fgPix);
 	p->Surface8Bkg->SetPix(x, y, bgPix);
@@ -887,8 +1028,12 @@ void C4Landscape::_SetPix2Tmp(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
 {
 	// set 8bpp-surface only!
 	assert(x >= 0 && y >= 0 && x < GetWidth() && y < GetHeight());
-	if (fgPix != Transparent) p->Surface8->SetPix(x, y, fgPix);
-	if (bgPix != Transparent) p->Surface8Bkg->SetPix(x, y, bgPix);
+	BYTE oldFgPix = p->Surface8->_GetPix(x, y), oldBgPix = p->Surface8Bkg->_GetPix(x, y);
+	if (fgPix == Transparent) fgPix = oldFgPix;
+	if (bgPix == Transparent) bgPix = oldBgPix;
+	p->UpdatePixHash(x, y, oldFgPix, oldBgPix, fgPix, bgPix);
+	p->Surface8->SetPix(x, y, fgPix);
+	p->Surface8Bkg->SetPix(x, y, bgPix);
 }
 
 bool C4Landscape::CheckInstability(int32_t tx, int32_t ty, int32_t recursion_count)
@@ -1373,6 +1518,12 @@ void C4Landscape::Clear(bool fClearMapCreator, bool fClearSky, bool fClearRender
 	p->pInitial.reset();
 	p->pInitialBkg.reset();
 	p->pFoW.reset();
+	// clear hashes
+	p->HashTilesX = p->HashTilesY = 0;
+	p->TileHashes.clear();
+	p->TileChanges.clear();
+	p->SyncChangedTiles.clear();
+	p->Hash = 0;
 	// clear relight array
 	for (auto &relight : p->Relights)
 		relight.Default();
@@ -1579,7 +1730,10 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 	p->NoScan = Game.C4S.Landscape.NoScan != 0;
 
 	// Scan settings
-	p->ScanSpeed = Clamp(GetWidth() / 500, 2, 15);
+	if (Game.C4S.Landscape.ScanSpeed > 0)
+		p->ScanSpeed = Clamp<int32_t>(Game.C4S.Landscape.ScanSpeed, 1, GetWidth());
+	else
+		p->ScanSpeed = Clamp(GetWidth() / 500, 2, 15);
 
 	// Create pixel count array before any SetPix operations may take place
 	// Proper pixel counts will be done later, but needs to have the arrays redy to avoid dead pointer access.
@@ -1659,6 +1813,7 @@ bool C4Landscape::Init(C4Group &hGroup, bool fOverloadCurrent, bool fLoadSky, bo
 	// Save initial landscape
 	if (!SaveInitial())
 		return false;
+	p->InitTileHashes(this);
 
 	// Load diff, if existant
 	ApplyDiff(hGroup);
@@ -1745,22 +1900,36 @@ bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, boo
 	if (!pInitial || !pInitialBkg) return false;
 
 	// If it shouldn't be sync-save: Clear all bytes that have not changed, i.e.
-	// set them to C4M_MaxTexIndex
+	// set them to C4M_MaxTexIndex. Only tiles changed since the initial landscape
+	// need to be compared.
 	bool fChanged = false, fChangedBkg = false;;
 	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
+		for (int32_t tile = 0; tile < std::max(GetHashTileCount(), 1); tile++)
+		{
+			C4Rect r = HashTilesX ? d->GetHashTile(tile) : C4Rect(0, 0, Width, Height);
+			if (!IsTileChangedSinceInitial(tile))
 			{
-				if (pInitial[y * Width + x] == Surface8->_GetPix(x, y))
-					Surface8->SetPix(x, y, C4M_MaxTexIndex);
-				else
-					fChanged = true;
-
-				if (pInitialBkg[y * Width + x] == Surface8Bkg->_GetPix(x, y))
-					Surface8Bkg->SetPix(x, y, C4M_MaxTexIndex);
-				else
-					fChangedBkg = true;
+				for (int y = r.y; y < r.y + r.Hgt; y++)
+				{
+					memset(Surface8->Bits + y * Surface8->Pitch + r.x, C4M_MaxTexIndex, r.Wdt);
+					memset(Surface8Bkg->Bits + y * Surface8Bkg->Pitch + r.x, C4M_MaxTexIndex, r.Wdt);
+				}
+				continue;
 			}
+			for (int y = r.y; y < r.y + r.Hgt; y++)
+				for (int x = r.x; x < r.x + r.Wdt; x++)
+				{
+					if (pInitial[y * Width + x] == Surface8->_GetPix(x, y))
+						Surface8->SetPix(x, y, C4M_MaxTexIndex);
+					else
+						fChanged = true;
+
+					if (pInitialBkg[y * Width + x] == Surface8Bkg->_GetPix(x, y))
+						Surface8Bkg->SetPix(x, y, C4M_MaxTexIndex);
+					else
+						fChangedBkg = true;
+				}
+		}
 
 	if (fSyncSave || fChanged)
 	{
@@ -1788,14 +1957,27 @@ bool C4Landscape::P::SaveDiffInternal(const C4Landscape *d, C4Group &hGroup, boo
 
 	// Restore landscape pixels
 	if (!fSyncSave)
-		for (int y = 0; y < Height; y++)
-			for (int x = 0; x < Width; x++)
+		for (int32_t tile = 0; tile < std::max(GetHashTileCount(), 1); tile++)
+		{
+			C4Rect r = HashTilesX ? d->GetHashTile(tile) : C4Rect(0, 0, Width, Height);
+			if (!IsTileChangedSinceInitial(tile))
 			{
-				if (Surface8->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8->SetPix(x, y, pInitial[y * Width + x]);
-				if (Surface8Bkg->_GetPix(x, y) == C4M_MaxTexIndex)
-					Surface8Bkg->SetPix(x, y, pInitialBkg[y * Width + x]);
+				for (int y = r.y; y < r.y + r.Hgt; y++)
+				{
+					memcpy(Surface8->Bits + y * Surface8->Pitch + r.x, &pInitial[y * Width + r.x], r.Wdt);
+					memcpy(Surface8Bkg->Bits + y * Surface8Bkg->Pitch + r.x, &pInitialBkg[y * Width + r.x], r.Wdt);
+				}
+				continue;
 			}
+			for (int y = r.y; y < r.y + r.Hgt; y++)
+				for (int x = r.x; x < r.x + r.Wdt; x++)
+				{
+					if (Surface8->_GetPix(x, y) == C4M_MaxTexIndex)
+						Surface8->SetPix(x, y, pInitial[y * Width + x]);
+					if (Surface8Bkg->_GetPix(x, y) == C4M_MaxTexIndex)
+						Surface8Bkg->SetPix(x, y, pInitialBkg[y * Width + x]);
+				}
+		}
 
 	// Save changed map, too
 	if (fMapChanged && Map)
@@ -1813,6 +1995,8 @@ bool C4Landscape::SaveInitial()
 	// Create array
 	p->pInitial = std::make_unique<BYTE[]>(GetWidth() * GetHeight());
 	p->pInitialBkg = std::make_unique<BYTE[]>(GetWidth() * GetHeight());
+	for (uint8_t &changes : p->TileChanges)
+		changes &= ~P::TileChangedSinceInitial;
 
 	// Save material data
 	for (int y = 0; y < GetHeight(); y++)
@@ -1910,6 +2094,7 @@ bool C4Landscape::ApplyDiff(C4Group &hGroup)
 	BYTE byPix;
 	for (int32_t y = 0; y < GetHeight(); ++y) for (int32_t x = 0; x < GetWidth(); ++x)
 	{
+		BYTE oldPix = p->Surface8->_GetPix(x, y), oldPixBkg = p->Surface8Bkg->_GetPix(x, y);
 		if (pDiff && pDiff->GetPix(x, y) != C4M_MaxTexIndex)
 			if (p->Surface8->_GetPix(x, y) != (byPix = pDiff->_GetPix(x, y)))
 				// material has changed here: readjust with new texture
@@ -1917,6 +2102,7 @@ bool C4Landscape::ApplyDiff(C4Group &hGroup)
 		if (pDiffBkg && pDiffBkg->GetPix(x, y) != C4M_MaxTexIndex)
 			if (p->Surface8Bkg->_GetPix(x, y) != (byPix = pDiffBkg->_GetPix(x, y)))
 				p->Surface8Bkg->_SetPix(x, y, byPix);
+		p->UpdatePixHash(x, y, oldPix, oldPixBkg, p->Surface8->_GetPix(x, y), p->Surface8Bkg->_GetPix(x, y));
 	}
 
 	// done
@@ -3943,6 +4129,8 @@ void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox, const bool
 	}
 	C4SolidMask::CheckConsistency();
 	if (updateMatAndPixCnt) UpdatePixCnt(d, BoundingBox);
+	// rehash after the solid masks are back, which are part of the hash
+	UpdateTileHashes(d, BoundingBox);
 	// update FoW
 	if (pFoW)
 	{
@@ -3952,6 +4140,75 @@ void C4Landscape::P::FinishChange(C4Landscape *d, C4Rect BoundingBox, const bool
 }
 
 
+namespace
+{
+	// Contribution of one pixel to the hash of its tile. Tile hashes are the xor of
+	// those of their pixels, so a changed pixel can be rehashed on its own.
+	inline uint32_t PixHash(int32_t x, int32_t y, BYTE fgPix, BYTE bgPix)
+	{
+		uint32_t h = uint32_t(x) * 0x9e3779b1u ^ uint32_t(y) * 0x85ebca77u ^ (uint32_t(fgPix) << 8 | bgPix) * 0xc2b2ae3du;
+		h ^= h >> 16;
+		h *= 0x7feb352du;
+		h ^= h >> 15;
+		h *= 0x846ca68bu;
+		h ^= h >> 16;
+		return h;
+	}
+}
+
+void C4Landscape::P::InitTileHashes(const C4Landscape *d)
+{
+	HashTilesX = (Width + C4LS_HashTileSize - 1) / C4LS_HashTileSize;
+	HashTilesY = (Height + C4LS_HashTileSize - 1) / C4LS_HashTileSize;
+	TileHashes.assign(GetHashTileCount(), 0);
+	TileChanges.assign(GetHashTileCount(), 0);
+	SyncChangedTiles.clear();
+	Hash = 0;
+	UpdateTileHashes(d, C4Rect(0, 0, Width, Height));
+	// Nothing changed yet
+	std::fill(TileChanges.begin(), TileChanges.end(), 0);
+	SyncChangedTiles.clear();
+}
+
+void C4Landscape::P::UpdateTileHashes(const C4Landscape *d, const C4Rect &BoundingBox)
+{
+	// Rehash all tiles touched by the rectangle
+	if (TileHashes.empty()) return;
+	const int32_t tx0 = BoundingBox.x / C4LS_HashTileSize, ty0 = BoundingBox.y / C4LS_HashTileSize;
+	const int32_t tx1 = std::min((BoundingBox.x + BoundingBox.Wdt - 1) / C4LS_HashTileSize, HashTilesX - 1);
+	const int32_t ty1 = std::min((BoundingBox.y + BoundingBox.Hgt - 1) / C4LS_HashTileSize, HashTilesY - 1);
+	for (int32_t ty = ty0; ty <= ty1; ++ty)
+		for (int32_t tx = tx0; tx <= tx1; ++tx)
+		{
+			const int32_t tile = ty * HashTilesX + tx;
+			uint32_t h = 0;
+			for (int32_t y = ty * C4LS_HashTileSize; y < std::min((ty + 1) * C4LS_HashTileSize, Height); ++y)
+				for (int32_t x = tx * C4LS_HashTileSize; x < std::min((tx + 1) * C4LS_HashTileSize, Width); ++x)
+					h ^= PixHash(x, y, Surface8->_GetPix(x, y), Surface8Bkg->_GetPix(x, y));
+			if (h == TileHashes[tile]) continue;
+			Hash ^= TileHashes[tile] ^ h;
+			TileHashes[tile] = h;
+			MarkTileChanged(tile);
+		}
+}
+
+void C4Landscape::P::UpdatePixHash(int32_t x, int32_t y, BYTE oldFgPix, BYTE oldBgPix, BYTE fgPix, BYTE bgPix)
+{
+	if (TileHashes.empty() || (oldFgPix == fgPix && oldBgPix == bgPix)) return;
+	const int32_t tile = (y / C4LS_HashTileSize) * HashTilesX + x / C4LS_HashTileSize;
+	const uint32_t change = PixHash(x, y, oldFgPix, oldBgPix) ^ PixHash(x, y, fgPix, bgPix);
+	TileHashes[tile] ^= change;
+	Hash ^= change;
+	MarkTileChanged(tile);
+}
+
+void C4Landscape::P::MarkTileChanged(int32_t tile)
+{
+	if (!(TileChanges[tile] & TileChangedSinceSync))
+		SyncChangedTiles.push_back(tile);
+	TileChanges[tile] |= TileChangedSinceSync | TileChangedSinceInitial;
+}
+
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 /* ++++++++++++++++++ Functions for Script interface +++++++++++++++++++++++ */
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
@@ -4211,6 +4468,39 @@ int32_t C4Landscape::GetEffectiveMatCount(int material) const
 	return p->EffectiveMatCount[material];
 }
 
+uint32_t C4Landscape::GetHash() const
+{
+	return p->Hash;
+}
+
+void C4Landscape::TakeChangedTileHashes(std::vector<C4LandscapeTileHash> &hashes)
+{
+	// Lowest indices first, so both sides of a sync check agree on which tiles to compare
+	std::sort(p->SyncChangedTiles.begin(), p->SyncChangedTiles.end());
+	hashes.clear();
+	for (int32_t tile : p->SyncChangedTiles)
+	{
+		if (hashes.size() < size_t(C4LS_MaxSyncTiles))
+			hashes.push_back({ tile, p->TileHashes[tile] });
+		p->TileChanges[tile] &= ~P::TileChangedSinceSync;
+	}
+	p->SyncChangedTiles.clear();
+}
+
+C4Rect C4Landscape::GetHashTile(int32_t index) const
+{
+	C4Rect tile((index % std::max(p->HashTilesX, 1)) * C4LS_HashTileSize, (index / std::max(p->HashTilesX, 1)) * C4LS_HashTileSize, C4LS_HashTileSize, C4LS_HashTileSize);
+	tile.Intersect(C4Rect(0, 0, GetWidth(), GetHeight()));
+	return tile;
+}
+
+void C4LandscapeTileHash::CompileFunc(StdCompiler *pComp)
+{
+	pComp->Value(mkIntPackAdapt(Index));
+	pComp->Separator();
+	pComp->Value(Hash);
+}
+
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
 /* +++++++++++++++++++++++++++ Update functions ++++++++++++++++++++++++++++ */
 /* +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++ */
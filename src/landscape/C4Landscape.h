@@ -26,6 +26,9 @@ const int32_t C4MaxMaterial = 125;
 
 const int32_t C4LS_MaxRelights = 50;
 
+const int32_t C4LS_HashTileSize = 64; // edge length of the tiles the landscape is hashed in
+const int32_t C4LS_MaxSyncTiles = 256; // maximum number of tile hashes in a sync check
+
 enum class LandscapeMode
 {
 	Undefined = 0,
@@ -34,6 +37,16 @@ enum class LandscapeMode
 	Exact = 3
 };
 
+// Hash of the foreground and background pixels of one landscape tile
+struct C4LandscapeTileHash
+{
+	int32_t Index;
+	uint32_t Hash;
+
+	bool operator ==(const C4LandscapeTileHash &other) const { return Index == other.Index && Hash == other.Hash; }
+	void CompileFunc(StdCompiler *pComp);
+};
+
 class C4Landscape
 {
 	struct P;
@@ -153,6 +166,10 @@ public:
 	int32_t GetMatCount(int material) const;
 	int32_t GetEffectiveMatCount(int material) const;
 
+	uint32_t GetHash() const; // hash of all landscape pixels, kept up to date while they change
+	void TakeChangedTileHashes(std::vector<C4LandscapeTileHash> &hashes); // hashes of the tiles changed since the last call, sorted by index
+	C4Rect GetHashTile(int32_t index) const;
+
 	int32_t DigFreeShape(int *vtcs, int length, C4Object *by_object = nullptr, bool no_dig2objects = false, bool no_instability_check = false);
 	void BlastFreeShape(int *vtcs, int length, C4Object *by_object = nullptr, int32_t by_player = NO_OWNER, int32_t iMaxDensity = C4M_Vehicle);
 
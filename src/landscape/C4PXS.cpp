@@ -30,36 +30,96 @@
 
 static const C4Real WindDrift_Factor = itofix(1, 800);
 
-bool C4PXS::Execute()
+C4PXSSystem::C4PXSSystem()
 {
+	Default();
+}
+
+C4PXSSystem::~C4PXSSystem()
+{
+	Clear();
+}
+
+void C4PXSSystem::Default()
+{
+	Clear();
+}
+
+void C4PXSSystem::Clear()
+{
+	Mat.clear();
+	X.clear(); Y.clear();
+	XDir.clear(); YDir.clear();
+	PixX.clear(); PixY.clear();
+	Alive.clear();
+}
+
+bool C4PXSSystem::Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir, C4Real iydir)
+{
+	if (!MatValid(mat)) return false;
+	if (Mat.size() >= PXSMax) return false;
+	Mat.push_back(mat);
+	X.push_back(ix); Y.push_back(iy);
+	XDir.push_back(ixdir); YDir.push_back(iydir);
+	return true;
+}
+
+void C4PXSSystem::PrepareExecute(size_t begin, size_t end)
+{
+	// Pixel positions and the validity test only depend on the particle
+	// itself, so they are computed for the whole range in one branch-free
+	// loop over the coordinate columns.
+	if (PixX.size() < end)
+	{
+		PixX.resize(end); PixY.resize(end);
+		Alive.resize(end);
+	}
+	const int32_t mat_num = ::MaterialMap.Num;
+	const C4Real wdt = itofix(::Landscape.GetWidth()), hgt = itofix(::Landscape.GetHeight());
+	const C4Real top = itofix(-10);
+	const int32_t *mat = Mat.data();
+	const C4Real *x = X.data(), *y = Y.data();
+	int32_t *pix_x = PixX.data(), *pix_y = PixY.data();
+	uint8_t *alive = Alive.data();
+	for (size_t i = begin; i < end; ++i)
+	{
+		pix_x[i] = fixtoi(x[i]);
+		pix_y[i] = fixtoi(y[i]);
+		alive[i] = (mat[i] >= 0) & (mat[i] < mat_num)
+		         & (x[i] >= Fix0) & (x[i] < wdt) & (y[i] >= top) & (y[i] < hgt);
+	}
+}
+
+bool C4PXSSystem::ExecutePXS(size_t i)
+{
+	// Work on copies: reactions may create new PXS, which can reallocate the columns
+	int32_t mat = Mat[i];
+	C4Real x = X[i], y = Y[i], xdir = XDir[i], ydir = YDir[i];
+
 	if (DEBUGREC_PXS && Config.General.DebugRec)
 	{
 		C4RCExecPXS rc;
-		rc.x=x; rc.y=y; rc.iMat=Mat;
+		rc.x=x; rc.y=y; rc.iMat=mat;
 		rc.pos = 0;
 		AddDbgRec(RCT_ExecPXS, &rc, sizeof(rc));
 	}
 	int32_t inmat;
 
-	// Safety
-	if (!MatValid(Mat))
-		{ Deactivate(); return false; }
-
-	// Out of bounds
-	if ((x<0) || (x>=::Landscape.GetWidth()) || (y<-10) || (y>=::Landscape.GetHeight()))
-		{ Deactivate(); return false; }
+	// Safety and out of bounds
+	if (!Alive[i])
+		{ Deactivate(i); return false; }
 
 	// Material conversion
-	int32_t iX = fixtoi(x), iY = fixtoi(y);
+	int32_t iX = PixX[i], iY = PixY[i];
 	inmat=GBackMat(iX,iY);
-	C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(Mat, inmat);
-	if (pReact && (*pReact->pFunc)(pReact, iX,iY, iX,iY, xdir,ydir, Mat,inmat, meePXSPos, nullptr))
-		{ Deactivate(); return false; }
+	C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(mat, inmat);
+	if (pReact && (*pReact->pFunc)(pReact, iX,iY, iX,iY, xdir,ydir, mat,inmat, meePXSPos, nullptr))
+		{ Deactivate(i); return false; }
 
 	// Gravity
 	ydir+=GravAccel;
 
-	if (GBackDensity(iX, iY + 1) < ::MaterialMap.Map[Mat].Density)
+	if (GBackDensity(iX, iY + 1) < ::MaterialMap.Map[mat].Density)
 	{
 		// Air speed: Wind plus some random
 		int32_t iWind = Weather.GetWind(iX, iY);
@@ -67,7 +127,7 @@ bool C4PXS::Execute()
 		C4Real tydir = C4REAL256(Random(1200) - 600);
 
 		// Air friction, based on WindDrift. MaxSpeed is ignored.
-		int32_t iWindDrift = std::max(::MaterialMap.Map[Mat].WindDrift - 20, 0);
+		int32_t iWindDrift = std::max(::MaterialMap.Map[mat].WindDrift - 20, 0);
 		xdir += ((txdir - xdir) * iWindDrift) * WindDrift_Factor;
 		ydir += ((tydir - ydir) * iWindDrift) * WindDrift_Factor;
 	}
@@ -82,7 +142,8 @@ bool C4PXS::Execute()
 		// Check path
 		if (::Landscape._PathFree(iX, iY, iToX, iToY))
 		{
-			x=ctcox; y=ctcoy;
+			X[i]=ctcox; Y[i]=ctcoy;
+			XDir[i]=xdir; YDir[i]=ydir;
 			return true;
 		}
 
@@ -95,13 +156,13 @@ bool C4PXS::Execute()
 		int32_t inX = iX + Sign(iToX - iX), inY = iY + Sign(iToY - iY);
 		// Contact?
 		inmat = GBackMat(inX, inY);
-		C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(Mat, inmat);
+		C4MaterialReaction *pReact = ::MaterialMap.GetReactionUnsafe(mat, inmat);
 		if (pReact)
 		{
-			if ((*pReact->pFunc)(pReact, iX,iY, inX,inY, xdir,ydir, Mat,inmat, meePXSMove, &fStopMovement))
+			if ((*pReact->pFunc)(pReact, iX,iY, inX,inY, xdir,ydir, mat,inmat, meePXSMove, &fStopMovement))
 			{
 				// destructive contact
-				Deactivate();
+				Deactivate(i);
 				return false;
 			}
 			else
@@ -110,8 +171,9 @@ bool C4PXS::Execute()
 				if (fStopMovement)
 				{
 					// But keep fractional positions to allow proper movement on moving ground
-					if (iX != iX0) x = itofix(iX);
-					if (iY != iY0) y = itofix(iY);
+					if (iX != iX0) X[i] = itofix(iX);
+					if (iY != iY0) Y[i] = itofix(iY);
+					XDir[i]=xdir; YDir[i]=ydir;
 					return true;
 				}
 				// there was a reaction func, but it didn't do anything - continue movement
@@ -122,75 +184,73 @@ bool C4PXS::Execute()
 	while (iX != iToX || iY != iToY);
 
 	// No contact? Free movement
-	x=ctcox; y=ctcoy;
+	X[i]=ctcox; Y[i]=ctcoy;
+	XDir[i]=xdir; YDir[i]=ydir;
 	if (DEBUGREC_PXS && Config.General.DebugRec)
 	{
 		C4RCExecPXS rc;
-		rc.x=x; rc.y=y; rc.iMat=Mat;
+		rc.x=ctcox; rc.y=ctcoy; rc.iMat=mat;
 		rc.pos = 1;
 		AddDbgRec(RCT_ExecPXS, &rc, sizeof(rc));
 	}
 	return true;
 }
 
-void C4PXS::Deactivate()
+void C4PXSSystem::Deactivate(size_t i)
 {
 	if (DEBUGREC_PXS && Config.General.DebugRec)
 	{
 		C4RCExecPXS rc;
-		rc.x=x; rc.y=y; rc.iMat=Mat;
+		rc.x=X[i]; rc.y=Y[i]; rc.iMat=Mat[i];
 		rc.pos = 2;
 		AddDbgRec(RCT_ExecPXS, &rc, sizeof(rc));
 	}
-	Mat=MNone;
+	Mat[i]=MNone;
 }
 
-C4PXSSystem::C4PXSSystem()
+void C4PXSSystem::Remove(size_t i, size_t &prepared)
 {
-	Default();
-}
-
-C4PXSSystem::~C4PXSSystem()
-{
-	Clear();
-}
-
-void C4PXSSystem::Default()
-{
-	Count=0;
-}
-
-void C4PXSSystem::Clear()
-{
-	Count=0;
-}
-
-C4PXS* C4PXSSystem::New()
-{
-	if (Count < PXSMax)
-		return &PXS[Count++];
-	return nullptr;
-}
-
-bool C4PXSSystem::Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir, C4Real iydir)
-{
-	C4PXS *pxp;
-	if (!MatValid(mat)) return false;
-	if (!(pxp=New())) return false;
-	pxp->Mat=mat;
-	pxp->x=ix; pxp->y=iy;
-	pxp->xdir=ixdir; pxp->ydir=iydir;
-	return true;
+	// Keep storage dense by moving the last particle into the freed slot
+	size_t last = Mat.size() - 1;
+	Mat[i] = Mat[last];
+	X[i] = X[last]; Y[i] = Y[last];
+	XDir[i] = XDir[last]; YDir[i] = YDir[last];
+	if (last < prepared)
+	{
+		PixX[i] = PixX[last]; PixY[i] = PixY[last];
+		Alive[i] = Alive[last];
+	}
+	else if (i < prepared)
+	{
+		// A particle created during this frame takes the slot
+		PrepareExecute(i, i + 1);
+	}
+	Mat.pop_back();
+	X.pop_back(); Y.pop_back();
+	XDir.pop_back(); YDir.pop_back();
+	prepared = std::min(prepared, Mat.size());
 }
 
 void C4PXSSystem::Execute()
 {
-	for (size_t i = 0; i < Count; i++)
+	// First pass over all particles that exist at the start of the frame
+	size_t prepared = Mat.size();
+	PrepareExecute(0, prepared);
+	// Second pass: material reactions and movement. This has to run strictly
+	// in order, because it reads and changes the landscape and draws random
+	// numbers. Particles created by reactions are appended and executed in the
+	// same frame.
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		if (!PXS[i].Execute())
+		if (i >= prepared)
 		{
-			assert(PXS[i].Mat == MNone);
-			PXS[i--] = PXS[--Count];
+			PrepareExecute(i, i + 1);
+			prepared = i + 1;
+		}
+		if (!ExecutePXS(i))
+		{
+			assert(Mat[i] == MNone);
+			Remove(i--, prepared);
 		}
 	}
 }
@@ -211,13 +271,14 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 
 	float cgox = cgo.X - cgo.TargetX, cgoy = cgo.Y - cgo.TargetY;
 	// First pass: draw simple PXS (lines/pixels)
-	for (size_t i = 0; i < Count; i++)
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		C4PXS *pxp = &PXS[i];
-		if (pxp->Mat != MNone && VisibleRect.Contains(fixtoi(pxp->x), fixtoi(pxp->y)))
+		const int32_t mat = Mat[i];
+		const C4Real x = X[i], y = Y[i], xdir = XDir[i], ydir = YDir[i];
+		if (mat != MNone && VisibleRect.Contains(fixtoi(x), fixtoi(y)))
 		{
-			C4Material *pMat = &::MaterialMap.Map[pxp->Mat];
-			const DWORD dwMatClr = ::Landscape.GetPal()->GetClr((BYTE) (Mat2PixColDefault(pxp->Mat)));
+			C4Material *pMat = &::MaterialMap.Map[mat];
+			const DWORD dwMatClr = ::Landscape.GetPal()->GetClr((BYTE) (Mat2PixColDefault(mat)));
 			if(pMat->PXSFace.Surface)
 			{
 				int32_t pnx, pny;
@@ -231,8 +292,8 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 
 				const float w = z;
 				const float h = z * fcHgt / fcWdt;
-				const float x1 = fixtof(pxp->x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt;
-				const float y1 = fixtof(pxp->y) + cgoy + z * pMat->PXSGfxRt.ty / fcHgt;
+				const float x1 = fixtof(x) + cgox + z * pMat->PXSGfxRt.tx / fcWdt;
+				const float y1 = fixtof(y) + cgoy + z * pMat->PXSGfxRt.ty / fcHgt;
 				const float x2 = x1 + w;
 				const float y2 = y1 + h;
 
@@ -255,7 +316,7 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 				vtx[4] = vtx[2];
 				vtx[5] = vtx[0];
 
-				std::vector<C4BltVertex>& vec = bltVtx[pxp->Mat];
+				std::vector<C4BltVertex>& vec = bltVtx[mat];
 				vec.push_back(vtx[0]);
 				vec.push_back(vtx[1]);
 				vec.push_back(vtx[2]);
@@ -266,14 +327,14 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 			else
 			{
 				// old-style: unicolored pixels or lines
-				if (fixtoi(pxp->xdir) || fixtoi(pxp->ydir))
+				if (fixtoi(xdir) || fixtoi(ydir))
 				{
 					// lines for stuff that goes whooosh!
-					int len = fixtoi(Abs(pxp->xdir) + Abs(pxp->ydir));
+					int len = fixtoi(Abs(xdir) + Abs(ydir));
 					const DWORD dwMatClrLen = uint32_t(std::max<int>(dwMatClr >> 24, 195 - (195 - (dwMatClr >> 24)) / len)) << 24 | (dwMatClr & 0xffffff);
 					C4BltVertex begin, end;
-					begin.ftx = fixtof(pxp->x - pxp->xdir) + cgox; begin.fty = fixtof(pxp->y - pxp->ydir) + cgoy;
-					end.ftx = fixtof(pxp->x) + cgox; end.fty = fixtof(pxp->y) + cgoy;
+					begin.ftx = fixtof(x - xdir) + cgox; begin.fty = fixtof(y - ydir) + cgoy;
+					end.ftx = fixtof(x) + cgox; end.fty = fixtof(y) + cgoy;
 					DwTo4UB(dwMatClrLen, begin.color);
 					DwTo4UB(dwMatClrLen, end.color);
 					lineVtx.push_back(begin);
@@ -283,8 +344,8 @@ void C4PXSSystem::Draw(C4TargetFacet &cgo)
 				{
 					// single pixels for slow stuff
 					C4BltVertex vtx;
-					vtx.ftx = fixtof(pxp->x) + cgox;
-					vtx.fty = fixtof(pxp->y) + cgoy;
+					vtx.ftx = fixtof(x) + cgox;
+					vtx.fty = fixtof(y) + cgoy;
 					DwTo4UB(dwMatClr, vtx.color);
 					pixVtx.push_back(vtx);
 				}
@@ -324,7 +385,7 @@ void C4PXSSystem::Cast(int32_t mat, int32_t num, int32_t tx, int32_t ty, int32_t
 
 bool C4PXSSystem::Save(C4Group &hGroup)
 {
-	if (Count == 0)
+	if (Mat.empty())
 	{
 		hGroup.Delete(C4CFN_PXS);
 		return true;
@@ -341,7 +402,15 @@ bool C4PXSSystem::Save(C4Group &hGroup)
 #endif
 	if (!hTempFile.Write(&iNumFormat, sizeof (iNumFormat)))
 		return false;
-	if (!hTempFile.Write(PXS, Count * sizeof(C4PXS)))
+	std::vector<C4PXS> records(Mat.size());
+	for (size_t i = 0; i < Mat.size(); i++)
+	{
+		C4PXS &rec = records[i];
+		rec.Mat = Mat[i];
+		rec.x = X[i]; rec.y = Y[i];
+		rec.xdir = XDir[i]; rec.ydir = YDir[i];
+	}
+	if (!hTempFile.Write(&records[0], records.size() * sizeof(C4PXS)))
 		return false;
 
 	if (!hTempFile.Close())
@@ -375,22 +444,26 @@ bool C4PXSSystem::Load(C4Group &hGroup)
 	// calc chunk count
 	PXSNum = iBinSize / sizeof(C4PXS);
 	if (PXSNum > PXSMax) return false;
-	if (!hGroup.Read(PXS, iBinSize)) return false;
-	// count the PXS, Peter!
-	Count = PXSNum;
-	// convert num format, if neccessary
-	for (size_t i = 0; i < Count; i++)
+	std::vector<C4PXS> records(PXSNum);
+	if (PXSNum && !hGroup.Read(&records[0], iBinSize)) return false;
+	// convert num format, if neccessary, and spread records into the columns
+	Mat.reserve(PXSNum);
+	X.reserve(PXSNum); Y.reserve(PXSNum);
+	XDir.reserve(PXSNum); YDir.reserve(PXSNum);
+	for (C4PXS &rec : records)
 	{
-		C4PXS *pxp = &PXS[i];
-		if (pxp->Mat != MNone)
+		if (rec.Mat != MNone)
 		{
 			// convert number format
 #ifdef C4REAL_USE_FIXNUM
-			if (iNumForm == 2) { FLOAT_TO_FIXED(&pxp->x); FLOAT_TO_FIXED(&pxp->y); FLOAT_TO_FIXED(&pxp->xdir); FLOAT_TO_FIXED(&pxp->ydir); }
+			if (iNumForm == 2) { FLOAT_TO_FIXED(&rec.x); FLOAT_TO_FIXED(&rec.y); FLOAT_TO_FIXED(&rec.xdir); FLOAT_TO_FIXED(&rec.ydir); }
 #else
-			if (iNumForm == 1) { FIXED_TO_FLOAT(&pxp->x); FIXED_TO_FLOAT(&pxp->y); FIXED_TO_FLOAT(&pxp->xdir); FIXED_TO_FLOAT(&pxp->ydir); }
+			if (iNumForm == 1) { FIXED_TO_FLOAT(&rec.x); FIXED_TO_FLOAT(&rec.y); FIXED_TO_FLOAT(&rec.xdir); FIXED_TO_FLOAT(&rec.ydir); }
 #endif
 		}
+		Mat.push_back(rec.Mat);
+		X.push_back(rec.x); Y.push_back(rec.y);
+		XDir.push_back(rec.xdir); YDir.push_back(rec.ydir);
 	}
 	return true;
 }
@@ -399,9 +472,9 @@ int32_t C4PXSSystem::GetCount(int32_t mat) const
 {
 	// count PXS of given material
 	int32_t result = 0;
-	for (size_t i = 0; i < Count; i++)
+	for (int32_t pxs_mat : Mat)
 	{
-		if (PXS[i].Mat == mat) ++result;
+		if (pxs_mat == mat) ++result;
 	}
 	return result;
 }
@@ -410,11 +483,10 @@ int32_t C4PXSSystem::GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, in
 {
 	// count PXS of given material in given area
 	int32_t result = 0;
-	for (size_t i = 0; i < Count; i++)
+	for (size_t i = 0; i < Mat.size(); i++)
 	{
-		const C4PXS *pxp = &PXS[i];
-		if (pxp->Mat == mat || mat == MNone)
-			if (Inside(pxp->x, x, x + wdt - 1) && Inside(pxp->y, y, y + hgt - 1))
+		if (Mat[i] == mat || mat == MNone)
+			if (Inside(X[i], x, x + wdt - 1) && Inside(Y[i], y, y + hgt - 1))
 				++result;
 	}
 	return result;
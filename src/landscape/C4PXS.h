@@ -22,28 +22,30 @@
 
 #include "landscape/C4Material.h"
 
-class C4PXS
+// On-disk record of a single PXS. The system itself keeps its particles in
+// separate columns (see C4PXSSystem); this layout is only used for savegames.
+struct C4PXS
 {
-	friend class C4PXSSystem;
-protected:
 	int32_t Mat{MNone};
 	C4Real x{Fix0}, y{Fix0}, xdir{Fix0}, ydir{Fix0};
-protected:
-	bool Execute();
-	void Deactivate();
 };
 
-const size_t PXSMax = 10000;
+// Upper bound guarding against runaway casts. Storage grows on demand.
+const size_t PXSMax = 1000000;
 
 class C4PXSSystem
 {
 public:
 	C4PXSSystem();
 	~C4PXSSystem();
-public:
-	size_t Count;
 protected:
-	C4PXS PXS[PXSMax];
+	// Particles are stored as a structure of arrays and kept dense: a
+	// deactivated particle is replaced by the last one.
+	std::vector<int32_t> Mat;
+	std::vector<C4Real> X, Y, XDir, YDir;
+	// Per-frame scratch columns, filled by the batched pass in Execute()
+	std::vector<int32_t> PixX, PixY;
+	std::vector<uint8_t> Alive;
 public:
 	void Default();
 	void Clear();
@@ -53,11 +55,14 @@ public:
 	bool Create(int32_t mat, C4Real ix, C4Real iy, C4Real ixdir=Fix0, C4Real iydir=Fix0);
 	bool Load(C4Group &hGroup);
 	bool Save(C4Group &hGroup);
-	int32_t GetCount() const { return Count; } // count all PXS
+	int32_t GetCount() const { return Mat.size(); } // count all PXS
 	int32_t GetCount(int32_t mat) const; // count PXS of given material
 	int32_t GetCount(int32_t mat, int32_t x, int32_t y, int32_t wdt, int32_t hgt) const; // count PXS of given material in given area. mat==-1 for all materials.
 protected:
-	C4PXS *New();
+	void PrepareExecute(size_t begin, size_t end);
+	bool ExecutePXS(size_t i);
+	void Deactivate(size_t i);
+	void Remove(size_t i, size_t &prepared);
 };
 
 extern C4PXSSystem PXS;
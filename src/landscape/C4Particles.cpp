@@ -754,7 +754,7 @@ void C4ParticleProperties::Set(C4PropList *dataSource)
 
 	for (;iter != end; ++iter)
 	{
-		const C4Property * p = *iter;
+		C4PropList::Iterator::Entry p = *iter;
 		C4String *key = p->Key;
 		assert(key && "PropList returns non-string as key");
 		const C4Value &property = p->Value;
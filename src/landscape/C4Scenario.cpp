@@ -309,6 +309,7 @@ void C4SLandscape::Default()
 	ExactLandscape=false;
 	Gravity.Set(100,0,10,200);
 	NoScan=false;
+	ScanSpeed=0;
 	KeepMapCreator=false;
 	SkyScrollMode=0;
 	MaterialZoom=4;
@@ -353,6 +354,7 @@ void C4SLandscape::CompileFunc(StdCompiler *pComp)
 	pComp->Value(mkNamingAdapt(Layers,                  "Layers",                C4NameList()));
 	pComp->Value(mkNamingAdapt(Gravity,                 "Gravity",               C4SVal(100,0,10,200), true));
 	pComp->Value(mkNamingAdapt(NoScan,                  "NoScan",                false));
+	pComp->Value(mkNamingAdapt(ScanSpeed,               "ScanSpeed",             0));
 	pComp->Value(mkNamingAdapt(KeepMapCreator,          "KeepMapCreator",        false));
 	pComp->Value(mkNamingAdapt(SkyScrollMode,           "SkyScrollMode",         0));
 	pComp->Value(mkNamingAdapt(MaterialZoom,            "MaterialZoom",          4));
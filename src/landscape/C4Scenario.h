@@ -173,6 +173,7 @@ public:
 	std::string SkyDef;
 	int32_t SkyDefFade[6];
 	bool NoScan;
+	int32_t ScanSpeed; // columns checked for freezing and melting per frame; 0 for automatic
 	C4SVal Gravity;
 	// Dynamic map
 	C4SVal MapWdt,MapHgt,MapZoom;
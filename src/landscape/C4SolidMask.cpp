@@ -20,6 +20,7 @@
 #include "landscape/C4SolidMask.h"
 
 #include "graphics/C4DrawGL.h"
+#include "graphics/C4Surface.h"
 #include "graphics/CSurface8.h"
 #include "graphics/StdPNG.h"
 #include "landscape/C4Landscape.h"
@@ -291,37 +292,37 @@ void C4SolidMask::Remove(bool fBackupAttachment)
 		iAttachingObjectsCount = 0;
 		// Search in area slightly larger than SolidMask because objects might have vertices slightly outside their shape
 		C4LArea SolidArea(&::Objects.Sectors, MaskPutRect.x-1, MaskPutRect.y-4, MaskPutRect.Wdt+2, MaskPutRect.Hgt+2);
-		C4LSector *pSct;
-		for (C4ObjectList *pLst=SolidArea.FirstObjectShapes(&pSct); pLst; pLst=SolidArea.NextObjectShapes(pLst, &pSct))
-			for (C4Object *pObj : *pLst)
-				if (pObj && pObj != pForObject && pObj->IsMoveableBySolidMask(pForObject->GetSolidMaskPlane()) && !pObj->Shape.CheckContact(pObj->GetX(),pObj->GetY()))
-				{
-					// avoid duplicate that may be found due to sector overlaps
-					bool has_dup = false;
-					for (int32_t i_dup = 0; i_dup < iAttachingObjectsCount; ++i_dup)
-						if (ppAttachingObjects[i_dup] == pObj)
-						{
-							has_dup = true;
-							break;
-						}
-					if (has_dup) continue;
-					// check for any contact to own SolidMask - attach-directions, bottom - "stuck" (CNAT_Center) is ignored, because that causes problems with things being stuck in basements :(
-					int iVtx = 0;
-					for (; iVtx < pObj->Shape.VtxNum; ++iVtx)
-						if (pObj->Shape.GetVertexContact(iVtx, pObj->Action.t_attach | CNAT_Bottom, pObj->GetX(), pObj->GetY(), DensityProvider(*this)))
-							break;
-					if (iVtx == pObj->Shape.VtxNum) continue; // no contact
-					// contact: Add object to list
-					if (iAttachingObjectsCapacity == iAttachingObjectsCount)
+		C4LSectors::Buffer AreaObjs(::Objects.Sectors);
+		SolidArea.GetObjectShapes(AreaObjs.Objects, true);
+		for (C4Object *pObj : AreaObjs.Objects)
+			if (pObj && pObj != pForObject && pObj->IsMoveableBySolidMask(pForObject->GetSolidMaskPlane()) && !pObj->Shape.CheckContact(pObj->GetX(),pObj->GetY()))
+			{
+				// avoid duplicate that may be found due to sector overlaps
+				bool has_dup = false;
+				for (int32_t i_dup = 0; i_dup < iAttachingObjectsCount; ++i_dup)
+					if (ppAttachingObjects[i_dup] == pObj)
 					{
-						iAttachingObjectsCapacity += 4;
-						C4Object **ppNewAttachingObjects = new C4Object *[iAttachingObjectsCapacity];
-						if (iAttachingObjectsCount) memcpy(ppNewAttachingObjects, ppAttachingObjects, sizeof(C4Object *) * iAttachingObjectsCount);
-						delete [] ppAttachingObjects;
-						ppAttachingObjects = ppNewAttachingObjects;
+						has_dup = true;
+						break;
 					}
-					ppAttachingObjects[iAttachingObjectsCount++] = pObj;
+				if (has_dup) continue;
+				// check for any contact to own SolidMask - attach-directions, bottom - "stuck" (CNAT_Center) is ignored, because that causes problems with things being stuck in basements :(
+				int iVtx = 0;
+				for (; iVtx < pObj->Shape.VtxNum; ++iVtx)
+					if (pObj->Shape.GetVertexContact(iVtx, pObj->Action.t_attach | CNAT_Bottom, pObj->GetX(), pObj->GetY(), DensityProvider(*this)))
+						break;
+				if (iVtx == pObj->Shape.VtxNum) continue; // no contact
+				// contact: Add object to list
+				if (iAttachingObjectsCapacity == iAttachingObjectsCount)
+				{
+					iAttachingObjectsCapacity += 4;
+					C4Object **ppNewAttachingObjects = new C4Object *[iAttachingObjectsCapacity];
+					if (iAttachingObjectsCount) memcpy(ppNewAttachingObjects, ppAttachingObjects, sizeof(C4Object *) * iAttachingObjectsCount);
+					delete [] ppAttachingObjects;
+					ppAttachingObjects = ppNewAttachingObjects;
 				}
+				ppAttachingObjects[iAttachingObjectsCount++] = pObj;
+			}
 	}
 
 	CheckConsistency();
@@ -489,14 +490,18 @@ CSurface8 *C4SolidMask::LoadMaskFromFile(class C4Group &hGroup, const char *szFi
 {
 	// Construct SolidMask surface from PNG bitmap:
 	// All pixels that are more than 50% transparent are not solid
-	CPNGFile png;
-	StdBuf png_buf;
-	if (!hGroup.LoadEntry(szFilename, &png_buf)) return nullptr; // error messages done by caller
-	if (!png.Load((BYTE*)png_buf.getMData(), png_buf.getSize())) return nullptr;
-	CSurface8 *result = new CSurface8(png.iWdt, png.iHgt);
-	for (size_t y=0u; y<png.iHgt; ++y)
-		for (size_t x=0u; x<png.iWdt; ++x)
-			result->SetPix(x,y,((png.GetPix(x,y)>>24)<128) ? 0x00 : 0xff);
+	std::unique_ptr<CPNGFile> png = C4Surface::TakeDecodedPNG(hGroup, szFilename);
+	if (!png)
+	{
+		StdBuf png_buf;
+		if (!hGroup.LoadEntryView(szFilename, &png_buf)) return nullptr; // error messages done by caller
+		png = std::make_unique<CPNGFile>();
+		if (!png->Load(static_cast<const BYTE *>(png_buf.getData()), png_buf.getSize())) return nullptr;
+	}
+	CSurface8 *result = new CSurface8(png->iWdt, png->iHgt);
+	for (size_t y=0u; y<png->iHgt; ++y)
+		for (size_t x=0u; x<png->iWdt; ++x)
+			result->SetPix(x,y,((png->GetPix(x,y)>>24)<128) ? 0x00 : 0xff);
 	return result;
 }
 
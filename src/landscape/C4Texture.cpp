@@ -347,9 +347,13 @@ int32_t C4TextureMap::LoadTextures(C4Group &hGroup, C4Group* OverloadFile)
 	C4Surface *ctex;
 	size_t binlen;
 
+	// collect names first: reading an entry resets the group search
+	std::vector<std::string> entry_names;
 	hGroup.ResetSearch();
-	while (hGroup.AccessNextEntry("*",&binlen,texname))
+	while (hGroup.FindNextEntry("*", texname)) entry_names.emplace_back(texname);
+	for (const std::string &entry_name : entry_names)
 	{
+		SCopy(entry_name.c_str(), texname, 256);
 		// check if it already exists in the map
 		const char *base_filename = GetFilenameOnly(texname);
 		if (GetTexture(base_filename)) continue;
@@ -357,7 +361,7 @@ int32_t C4TextureMap::LoadTextures(C4Group &hGroup, C4Group* OverloadFile)
 		if (WildcardMatch("*" C4CFN_MaterialShapeFiles, texname)) continue;
 		// create surface
 		ctex = new C4Surface();
-		if (ctex->Read(hGroup, GetExtension(texname), C4SF_MipMap))
+		if (ctex->ReadEntry(hGroup, entry_name.c_str(), C4SF_MipMap))
 		{
 			SReplaceChar(texname,'.',0);
 			if (AddTexture(texname,ctex)) texnum++;
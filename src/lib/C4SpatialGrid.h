@@ -0,0 +1,246 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* Uniform grid of flat element arrays for spatial queries */
+
+#ifndef INC_C4SpatialGrid
+#define INC_C4SpatialGrid
+
+#include "lib/C4Rect.h"
+
+#include <algorithm>
+#include <vector>
+
+// Divides a rectangle of pixels into square cells and keeps a flat array of
+// element pointers per cell, plus one cell for everything outside the
+// rectangle. Arrays are sorted by an order key supplied by the caller, so
+// visiting the cells of an area yields the elements in the same order no
+// matter in which order they were inserted.
+template<class T> class C4SpatialGrid
+{
+public:
+	struct Entry
+	{
+		uint64_t Order;
+		T *Obj;
+		bool operator <(const Entry &other) const { return Order < other.Order; }
+	};
+	typedef std::vector<Entry> Cell;
+
+	// A rectangle of cells (inclusive bounds), and whether the outside cell belongs to it
+	struct Area
+	{
+		int32_t x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+		bool Out = false;
+
+		bool operator ==(const Area &other) const
+		{ return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1 && Out == other.Out; }
+		bool operator !=(const Area &other) const { return !(*this == other); }
+		bool IsNull() const { return x1 < x0 && !Out; }
+		// cell coordinates; negative for the outside cell
+		bool Contains(int32_t cx, int32_t cy) const
+		{ return cx < 0 ? Out : (cx >= x0 && cx <= x1 && cy >= y0 && cy <= y1); }
+		int32_t GetCellCount() const
+		{ return (x1 >= x0 ? (x1 - x0 + 1) * (y1 - y0 + 1) : 0) + (Out ? 1 : 0); }
+	};
+
+private:
+	int32_t PxWdt = 0, PxHgt = 0; // size in px
+	int32_t CellSize = 1; // cell edge length in px
+	int32_t Wdt = 0, Hgt = 0; // cell count
+	std::vector<Cell> Cells{1}; // Wdt*Hgt cells in rows, followed by the outside cell
+
+public:
+	void Init(int32_t px_wdt, int32_t px_hgt, int32_t cell_size)
+	{
+		CellSize = std::max<int32_t>(cell_size, 1);
+		Wdt = ((PxWdt = px_wdt) - 1) / CellSize + 1;
+		Hgt = ((PxHgt = px_hgt) - 1) / CellSize + 1;
+		Cells.clear();
+		Cells.resize(Wdt * Hgt + 1);
+	}
+	void Clear()
+	{
+		PxWdt = PxHgt = Wdt = Hgt = 0;
+		Cells.clear();
+		Cells.resize(1);
+	}
+	void ClearCells() { for (Cell &cell : Cells) cell.clear(); }
+
+	int32_t GetCellSize() const { return CellSize; }
+	int32_t GetWidth() const { return Wdt; }
+	int32_t GetHeight() const { return Hgt; }
+	int32_t GetOutIndex() const { return Wdt * Hgt; }
+	Area GetFullArea() const
+	{
+		Area area;
+		area.x1 = Wdt - 1; area.y1 = Hgt - 1;
+		area.Out = true;
+		return area;
+	}
+
+	// Index of the cell containing a pixel
+	int32_t IndexAt(int32_t x, int32_t y) const
+	{
+		if (x < 0 || y < 0 || x >= PxWdt || y >= PxHgt) return GetOutIndex();
+		return (y / CellSize) * Wdt + x / CellSize;
+	}
+	Cell &GetCell(int32_t index) { return Cells[index]; }
+	const Cell &GetCell(int32_t index) const { return Cells[index]; }
+
+	// Cells overlapped by a rectangle. Rectangles not fully inside also cover the
+	// outside cell, and degenerate ones still cover the cell they start in.
+	Area GetArea(const C4Rect &rect) const
+	{
+		Area area;
+		C4Rect clipped(rect), bounds(0, 0, PxWdt, PxHgt);
+		clipped.Normalize();
+		if (!bounds.Contains(clipped))
+		{
+			clipped.Intersect(bounds);
+			area.Out = true;
+		}
+		if (IndexAt(clipped.x, clipped.y) == GetOutIndex())
+			return area;
+		if (!clipped.Wdt) clipped.Wdt = 1;
+		if (!clipped.Hgt) clipped.Hgt = 1;
+		area.x0 = clipped.x / CellSize;
+		area.y0 = clipped.y / CellSize;
+		area.x1 = (clipped.x + clipped.Wdt - 1) / CellSize;
+		area.y1 = (clipped.y + clipped.Hgt - 1) / CellSize;
+		return area;
+	}
+
+	// Visit the cells of an area row by row, then the outside cell.
+	// f receives the cell and its coordinates (-1, -1 for the outside cell).
+	template<class F> void ForEachCell(const Area &area, F f)
+	{
+		for (int32_t cy = area.y0; cy <= area.y1; ++cy)
+			for (int32_t cx = area.x0; cx <= area.x1; ++cx)
+				f(Cells[cy * Wdt + cx], cx, cy);
+		if (area.Out) f(Cells[GetOutIndex()], -1, -1);
+	}
+	template<class F> void ForEachCell(const Area &area, F f) const
+	{
+		for (int32_t cy = area.y0; cy <= area.y1; ++cy)
+			for (int32_t cx = area.x0; cx <= area.x1; ++cx)
+				f(Cells[cy * Wdt + cx], cx, cy);
+		if (area.Out) f(Cells[GetOutIndex()], -1, -1);
+	}
+
+	// Visit the cells of an area nearest first: the outside cell, then rings of cells
+	// around the one closest to pixel x/y. Before each further ring, more() receives the
+	// squared distance from x/y to the nearest pixel of all cells not visited yet, and
+	// returns whether to go on.
+	template<class F, class M> void ForEachCellNearestFirst(int32_t x, int32_t y, const Area &area, F f, M more) const
+	{
+		if (area.Out) f(Cells[GetOutIndex()], -1, -1);
+		if (area.x1 < area.x0) return;
+		const int32_t cx = std::min(std::max(x / CellSize, area.x0), area.x1);
+		const int32_t cy = std::min(std::max(y / CellSize, area.y0), area.y1);
+		for (int32_t r = 0; ; ++r)
+		{
+			// Directions in which the area has cells at this distance
+			bool left = cx - r >= area.x0, right = cx + r <= area.x1;
+			bool top = cy - r >= area.y0, bottom = cy + r <= area.y1;
+			if (!left && !right && !top && !bottom) return;
+			if (r)
+			{
+				int64_t gap = INT64_MAX;
+				if (left) gap = std::min<int64_t>(gap, std::max<int64_t>(0, int64_t(x) - ((cx - r + 1) * CellSize - 1)));
+				if (right) gap = std::min<int64_t>(gap, std::max<int64_t>(0, int64_t((cx + r) * CellSize) - x));
+				if (top) gap = std::min<int64_t>(gap, std::max<int64_t>(0, int64_t(y) - ((cy - r + 1) * CellSize - 1)));
+				if (bottom) gap = std::min<int64_t>(gap, std::max<int64_t>(0, int64_t((cy + r) * CellSize) - y));
+				if (!more(gap * gap)) return;
+			}
+			// Full rows at the top and bottom of the ring, single cells at its sides
+			for (int32_t ry = std::max(cy - r, area.y0); ry <= std::min(cy + r, area.y1); ++ry)
+				if (ry == cy - r || ry == cy + r)
+				{
+					for (int32_t rx = std::max(cx - r, area.x0); rx <= std::min(cx + r, area.x1); ++rx)
+						f(Cells[ry * Wdt + rx], rx, ry);
+				}
+				else
+				{
+					if (left) f(Cells[ry * Wdt + cx - r], cx - r, ry);
+					if (right) f(Cells[ry * Wdt + cx + r], cx + r, ry);
+				}
+		}
+	}
+
+	static void Insert(Cell &cell, T *obj, uint64_t order)
+	{
+		Entry entry = { order, obj };
+		cell.insert(std::upper_bound(cell.begin(), cell.end(), entry), entry);
+	}
+	static bool Erase(Cell &cell, T *obj, uint64_t order)
+	{
+		Entry entry = { order, obj };
+		auto it = std::lower_bound(cell.begin(), cell.end(), entry);
+		if (it == cell.end() || it->Obj != obj)
+			it = std::find_if(cell.begin(), cell.end(), [obj](const Entry &e) { return e.Obj == obj; });
+		if (it == cell.end()) return false;
+		cell.erase(it);
+		return true;
+	}
+	static bool IsContained(const Cell &cell, const T *obj)
+	{ return std::any_of(cell.begin(), cell.end(), [obj](const Entry &e) { return e.Obj == obj; }); }
+	// Re-read the order keys of one cell, restoring the sorting if needed
+	template<class F> static void UpdateOrder(Cell &cell, F order_of)
+	{
+		for (Entry &entry : cell) entry.Order = order_of(entry.Obj);
+		if (!std::is_sorted(cell.begin(), cell.end())) std::sort(cell.begin(), cell.end());
+	}
+
+	void Add(int32_t index, T *obj, uint64_t order) { Insert(Cells[index], obj, order); }
+	bool Remove(int32_t index, T *obj, uint64_t order) { return Erase(Cells[index], obj, order); }
+
+	void AddToArea(const Area &area, T *obj, uint64_t order)
+	{ ForEachCell(area, [obj, order](Cell &cell, int32_t, int32_t) { Insert(cell, obj, order); }); }
+	void RemoveFromArea(const Area &area, T *obj, uint64_t order)
+	{ ForEachCell(area, [obj, order](Cell &cell, int32_t, int32_t) { Erase(cell, obj, order); }); }
+	// Move an element between areas, touching only the cells not in both
+	void MoveArea(const Area &from, const Area &to, T *obj, uint64_t order)
+	{
+		ForEachCell(from, [&to, obj, order](Cell &cell, int32_t cx, int32_t cy) { if (!to.Contains(cx, cy)) Erase(cell, obj, order); });
+		ForEachCell(to, [&from, obj, order](Cell &cell, int32_t cx, int32_t cy) { if (!from.Contains(cx, cy)) Insert(cell, obj, order); });
+	}
+
+	// Append the elements of an area in visiting order. Elements spanning
+	// several cells are appended once per cell.
+	void Collect(const Area &area, std::vector<T *> &result) const
+	{
+		ForEachCell(area, [&result](const Cell &cell, int32_t, int32_t)
+		{
+			for (const Entry &entry : cell) result.push_back(entry.Obj);
+		});
+	}
+
+	// Re-read all order keys after the caller renumbered them, restoring the sorting if needed
+	template<class F> void UpdateOrder(F order_of)
+	{
+		for (Cell &cell : Cells) UpdateOrder(cell, order_of);
+	}
+
+	// Number of entries in all cells inside the grid
+	size_t GetEntryCount() const
+	{
+		size_t count = 0;
+		for (int32_t i = 0; i < GetOutIndex(); ++i) count += Cells[i].size();
+		return count;
+	}
+};
+
+#endif
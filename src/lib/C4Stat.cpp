@@ -18,6 +18,12 @@
 #include "C4Include.h"
 #include "lib/C4Stat.h"
 
+#ifdef STAT
+bool C4Stat::Enabled = true;
+#else
+bool C4Stat::Enabled = false;
+#endif
+
 // ** implemetation of C4MainStat
 
 C4MainStat::C4MainStat() = default;
@@ -133,8 +139,8 @@ void C4MainStat::Show()
 		// output it!
 		if (pAkt->iCount)
 			LogSilentF("%s: n = %u, t = %u, td = %.2f",
-			           pAkt->strName, pAkt->iCount, pAkt->tTimeSum,
-			           double(pAkt->tTimeSum) / pAkt->iCount * 1000);
+			           pAkt->strName, pAkt->iCount, unsigned(pAkt->tTimeSum / 1000),
+			           double(pAkt->tTimeSum) / pAkt->iCount);
 	}
 
 	// delete...
@@ -153,7 +159,7 @@ void C4MainStat::ShowPart(int FrameCounter)
 
 	// insert all stats
 	for (pAkt = pFirst; pAkt; pAkt = pAkt->pNext)
-		LogSilentF("%s: n=%u, t=%u", pAkt->strName, pAkt->iCountPart, pAkt->tTimeSumPart);
+		LogSilentF("%s: n=%u, t=%u", pAkt->strName, pAkt->iCountPart, unsigned(pAkt->tTimeSumPart / 1000));
 
 	// insert part stat end idtf
 	LogSilentF("** PartStat end\n");
@@ -17,6 +17,8 @@
 #ifndef INC_C4Stat
 #define INC_C4Stat
 
+#include <chrono>
+
 class C4Stat;
 
 // *** main statistic class
@@ -35,6 +37,8 @@ public:
 	void Reset();
 	void ResetPart();
 
+	C4Stat *GetFirst() const { return pFirst; }
+
 protected:
 	C4Stat* pFirst{nullptr};
 
@@ -56,8 +60,9 @@ public:
 
 	inline void Start()
 	{
+		if (!Enabled) return;
 		if (!iStartCalled)
-			tStartTime = C4TimeMilliseconds::Now();
+			tStartTime = std::chrono::steady_clock::now();
 		iCount ++;
 		iCountPart ++;
 		iStartCalled ++;
@@ -65,11 +70,12 @@ public:
 
 	inline void Stop()
 	{
-		assert(iStartCalled);
+		// may have been enabled between Start and Stop
+		if (!iStartCalled) return;
 		iStartCalled --;
-		if (!iStartCalled && iCount >= 100)
+		if (!iStartCalled)
 		{
-			uint32_t tTime = C4TimeMilliseconds::Now() - tStartTime;
+			uint64_t tTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStartTime).count();
 
 			tTimeSum += tTime;
 			tTimeSumPart += tTime;
@@ -81,13 +87,21 @@ public:
 
 	static C4MainStat *getMainStat();
 
+	C4Stat *GetNext() const { return pNext; }
+	const char *GetName() const { return strName; }
+	unsigned int GetCount() const { return iCount; }
+	uint64_t GetTimeSum() const { return tTimeSum; } // microseconds
+
+	// timing is on by default in STAT builds, and can be turned on at runtime otherwise
+	static bool Enabled;
+
 protected:
 
 	// used by C4MainStat
 	C4Stat* pNext;
 	C4Stat* pPrev;
 
-	C4TimeMilliseconds tStartTime;
+	std::chrono::steady_clock::time_point tStartTime;
 
 	// start-call depth
 	unsigned int iStartCalled;
@@ -95,16 +109,16 @@ protected:
 
 	// ** statistic data
 
-	// sum of times
-	uint32_t tTimeSum;
+	// sum of times in microseconds
+	uint64_t tTimeSum;
 
 	// number of starts called
 	unsigned int iCount;
 
 	// ** statistic data (partial stat)
 
-	// sum of times
-	uint32_t tTimeSumPart;
+	// sum of times in microseconds
+	uint64_t tTimeSumPart;
 
 	// number of starts called
 	unsigned int iCountPart;
@@ -119,7 +133,6 @@ protected:
 };
 
 // *** some directives
-#ifdef STAT
 
 // used to create and start a new C4Stat object
 #define C4ST_STARTNEW(StatName, strName) static C4Stat StatName(strName); StatName.Start();
@@ -133,6 +146,8 @@ protected:
 // used to stop an existing C4Stat object
 #define C4ST_STOP(StatName) StatName.Stop();
 
+#ifdef STAT
+
 // shows the statistic (to log)
 #define C4ST_SHOWSTAT C4Stat::getMainStat()->Show();
 
@@ -147,10 +162,6 @@ protected:
 
 #else
 
-#define C4ST_STARTNEW(StatName, strName)
-#define C4ST_NEW(StatName, strName)
-#define C4ST_START(StatName)
-#define C4ST_STOP(StatName)
 #define C4ST_SHOWSTAT
 #define C4ST_SHOWPARTSTAT(FrameCounter)
 #define C4ST_RESET
@@ -16,6 +16,8 @@
 #include "C4Include.h"
 #include "lib/StdCompiler.h"
 
+#include "lib/StdAdaptors.h"
+
 // *** StdCompiler
 
 void StdCompiler::Warn(const char *szWarning, ...)
@@ -213,6 +215,20 @@ void StdCompilerBinRead::Begin()
 	iPos = 0;
 }
 
+// *** StdCompilerPackedBinWrite
+
+void StdCompilerPackedBinWrite::DWord(int32_t &rInt)   { Value(mkIntPackAdapt(rInt)); }
+void StdCompilerPackedBinWrite::DWord(uint32_t &rInt)  { Value(mkIntPackAdapt(rInt)); }
+void StdCompilerPackedBinWrite::Word(int16_t &rShort)  { Value(mkIntPackAdapt(rShort)); }
+void StdCompilerPackedBinWrite::Word(uint16_t &rShort) { Value(mkIntPackAdapt(rShort)); }
+
+// *** StdCompilerPackedBinRead
+
+void StdCompilerPackedBinRead::DWord(int32_t &rInt)   { Value(mkIntPackAdapt(rInt)); }
+void StdCompilerPackedBinRead::DWord(uint32_t &rInt)  { Value(mkIntPackAdapt(rInt)); }
+void StdCompilerPackedBinRead::Word(int16_t &rShort)  { Value(mkIntPackAdapt(rShort)); }
+void StdCompilerPackedBinRead::Word(uint16_t &rShort) { Value(mkIntPackAdapt(rShort)); }
+
 // *** StdCompilerINIWrite
 
 bool StdCompilerINIWrite::Name(const char *szName)
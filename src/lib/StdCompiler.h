@@ -526,6 +526,26 @@ protected:
 	template <class T> void ReadValue(T &rValue);
 };
 
+// binary write and read with variable length integers. Smaller for mostly small
+// values, but not compatible to the plain binary format.
+class StdCompilerPackedBinWrite : public StdCompilerBinWrite
+{
+public:
+	void DWord(int32_t &rInt) override;
+	void DWord(uint32_t &rInt) override;
+	void Word(int16_t &rShort) override;
+	void Word(uint16_t &rShort) override;
+};
+
+class StdCompilerPackedBinRead : public StdCompilerBinRead
+{
+public:
+	void DWord(int32_t &rInt) override;
+	void DWord(uint32_t &rInt) override;
+	void Word(int16_t &rShort) override;
+	void Word(uint16_t &rShort) override;
+};
+
 // *** INI compiler
 
 // Naming and separators supported, so defaulting can be used through
@@ -63,13 +63,13 @@ namespace
 		{
 			// All VDET_Float* fall through.
 		case Ogre::Mesh::ChunkGeometryVertexDeclElement::VDET_Float4:
-			dest[3] = *reinterpret_cast<const float*>(source + sizeof(float) * 3);
+			std::memcpy(&dest[3], source + sizeof(float) * 3, sizeof(float));
 		case Ogre::Mesh::ChunkGeometryVertexDeclElement::VDET_Float3:
-			dest[2] = *reinterpret_cast<const float*>(source + sizeof(float) * 2);
+			std::memcpy(&dest[2], source + sizeof(float) * 2, sizeof(float));
 		case Ogre::Mesh::ChunkGeometryVertexDeclElement::VDET_Float2:
-			dest[1] = *reinterpret_cast<const float*>(source + sizeof(float) * 1);
+			std::memcpy(&dest[1], source + sizeof(float) * 1, sizeof(float));
 		case Ogre::Mesh::ChunkGeometryVertexDeclElement::VDET_Float1:
-			dest[0] = *reinterpret_cast<const float*>(source + sizeof(float) * 0);
+			std::memcpy(&dest[0], source + sizeof(float) * 0, sizeof(float));
 			break;
 		case Ogre::Mesh::ChunkGeometryVertexDeclElement::VDET_Color_ABGR:
 			dest[3] = source[0] / 255.0f;
@@ -304,8 +304,7 @@ namespace Ogre
 
 		void ChunkGeometryVertexData::ReadImpl(DataStream *stream)
 		{
-			data = new char[GetSize()];
-			stream->Read(data, GetSize());
+			data = stream->ReadRef(GetSize());
 		}
 	}
 
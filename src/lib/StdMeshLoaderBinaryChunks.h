@@ -524,8 +524,7 @@ namespace Ogre
 		{
 		public:
 			ChunkGeometryVertexData() = default;
-			~ChunkGeometryVertexData() override { delete[] static_cast<char*>(data); }
-			void *data{nullptr};
+			const void *data{nullptr}; // points into the source buffer; may be unaligned
 		protected:
 			void ReadImpl(DataStream *stream) override;
 		};
@@ -79,6 +79,15 @@ namespace Ogre
 			Peek(dest, size);
 			cursor += size;
 		}
+		// Skip size bytes and return a pointer to them. The data is only valid as long as the source buffer.
+		const char *ReadRef(size_t size)
+		{
+			if (GetRemainingBytes() < size)
+				throw InsufficientData();
+			const char *data = cursor;
+			cursor += size;
+			return data;
+		}
 	};
 
 	template<> inline bool DataStream::Peek<bool>() const
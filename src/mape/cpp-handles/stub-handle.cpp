@@ -46,6 +46,7 @@ void C4Facet::Set(C4Surface*, float, float, float, float) {}
 C4Surface::C4Surface() {}
 C4Surface::~C4Surface() {}
 bool C4Surface::Read(CStdStream &, const char *, int) { return false; }
+bool C4Surface::ReadEntry(C4Group &, const char *, int) { return false; }
 bool C4Surface::Lock() { return false; }
 bool C4Surface::Unlock() { return false; }
 DWORD C4Surface::GetPixDw(int iX, int iY, bool fApplyModulation) { return 0; }
@@ -22,6 +22,9 @@
 #include "game/C4Application.h"
 #include "game/C4GraphicsSystem.h"
 
+#include <chrono>
+#include <map>
+
 // *** C4GameControlNetwork
 
 C4GameControlNetwork::C4GameControlNetwork(C4GameControl *pnParent)
@@ -159,18 +162,17 @@ void C4GameControlNetwork::DoInput(const C4Control &Input) // by main thread
 	C4GameControlPacket *pCtrl = new C4GameControlPacket();
 	pCtrl->Set(iClientID, iControlSent+1, Input);
 	// client in central or async mode: send to host (will resend it to the other clients)
-	C4NetIOPacket CtrlPkt = MkC4NetIOPacket(PID_Control, *pCtrl);
 	if (eMode != CNM_Decentral)
 	{
 		if (!fHost)
-			if (!pNetwork->Clients.SendMsgToHost(CtrlPkt))
+			if (!SendCtrlToHost({ pCtrl }))
 				Application.InteractiveThread.ThreadLog("Failed to send control to host!");
 	}
 	// decentral mode: always broadcast to everybody
 	else
 	{
 		assert (eMode == CNM_Decentral);
-		if (!pNetwork->Clients.BroadcastMsgToClients(CtrlPkt))
+		if (!BroadcastCtrl({ pCtrl }, true))
 			Application.InteractiveThread.ThreadLog("Failed to broadcast control!");
 	}
 	// add to list
@@ -374,14 +376,20 @@ void C4GameControlNetwork::SetCtrlMode(C4GameControlNetworkMode enMode) // by ma
 	if (enMode == CNM_Decentral)
 	{
 		CStdLock CtrlLock(&CtrlCSec); C4GameControlPacket *pPkt;
+		std::vector<const C4GameControlPacket *> Pkts;
 		for (int32_t iCtrlTick = ::Control.ControlTick; (pPkt = getCtrl(iClientID, iCtrlTick)); iCtrlTick++)
-			::Network.Clients.BroadcastMsgToClients(MkC4NetIOPacket(PID_Control, *pPkt));
+			Pkts.push_back(pPkt);
+		if (!Pkts.empty())
+			BroadcastCtrl(Pkts, true);
 	}
 	else if (enMode == CNM_Central && fHost)
 	{
 		CStdLock CtrlLock(&CtrlCSec); C4GameControlPacket *pPkt;
+		std::vector<const C4GameControlPacket *> Pkts;
 		for (int32_t iCtrlTick = ::Control.ControlTick; (pPkt = getCtrl(C4ClientIDAll, iCtrlTick)); iCtrlTick++)
-			::Network.Clients.BroadcastMsgToClients(MkC4NetIOPacket(PID_Control, *pPkt));
+			Pkts.push_back(pPkt);
+		if (!Pkts.empty())
+			BroadcastCtrl(Pkts, false);
 	}
 }
 
@@ -472,6 +480,24 @@ void C4GameControlNetwork::HandlePacket(char cStatus, const C4PacketBase *pPacke
 	}
 	break;
 
+	case PID_ControlPacked: // control of one or more ticks
+	{
+		GETPKT(C4PacketControlPacked, rPkt)
+		std::vector<std::unique_ptr<C4GameControlPacket> > Pkts;
+		if (!rPkt.Unpack(&Pkts)) break;
+		for (auto &pPkt : Pkts)
+			HandleControl(pConn->getClientID(), *pPkt);
+	}
+	break;
+
+	case PID_ControlFormat: // peer understands packed control
+	{
+		GETPKT(C4PacketControlFormat, rPkt)
+		if (rPkt.getFormat() >= CCF_Packed)
+			pConn->SetPackedControl();
+	}
+	break;
+
 	case PID_ControlReq: // control request
 	{
 		if (!IsEnabled()) break;
@@ -539,14 +565,15 @@ void C4GameControlNetwork::HandleControl(int32_t iByClientID, const C4GameContro
 void C4GameControlNetwork::HandleControlReq(const C4PacketControlReq &rPkt, C4Network2IOConnection *pConn)
 {
 	CStdLock CtrlLock(&CtrlCSec);
+	// collect everything and send it at once
+	std::vector<const C4GameControlPacket *> Pkts;
 	for (int iTick = rPkt.getCtrlTick(); ; iTick++)
 	{
 		// search complete control
 		C4GameControlPacket *pCtrl = getCtrl(C4ClientIDAll, iTick);
 		if (pCtrl)
 		{
-			// send
-			pConn->Send(MkC4NetIOPacket(PID_Control, *pCtrl));
+			Pkts.push_back(pCtrl);
 			continue;
 		}
 		// send everything we have for this tick (this is an emergency case, so efficiency
@@ -555,12 +582,68 @@ void C4GameControlNetwork::HandleControlReq(const C4PacketControlReq &rPkt, C4Ne
 		for (pCtrl = pCtrlStack; pCtrl; pCtrl = pCtrl->pNext)
 			if (pCtrl->getCtrlTick() == iTick)
 			{
-				pConn->Send(MkC4NetIOPacket(PID_Control, *pCtrl));
+				Pkts.push_back(pCtrl);
 				fFound = true;
 			}
 		// nothing found for this tick?
 		if (!fFound) break;
 	}
+	if (!Pkts.empty())
+		SendCtrl(pConn, Pkts);
+}
+
+bool C4GameControlNetwork::SendCtrl(C4Network2IOConnection *pConn, const std::vector<const C4GameControlPacket *> &Pkts)
+{
+	if (pConn->hasPackedControl())
+		return pConn->Send(MkC4NetIOPacket(PID_ControlPacked, C4PacketControlPacked(Pkts)));
+	bool fSuccess = true;
+	for (const C4GameControlPacket *pPkt : Pkts)
+		fSuccess &= pConn->Send(MkC4NetIOPacket(PID_Control, *pPkt));
+	return fSuccess;
+}
+
+bool C4GameControlNetwork::SendCtrlToHost(const std::vector<const C4GameControlPacket *> &Pkts)
+{
+	C4Network2Client *pHost = pNetwork->Clients.GetHost();
+	if (!pHost || !pHost->getMsgConn()) return false;
+	return SendCtrl(pHost->getMsgConn(), Pkts);
+}
+
+bool C4GameControlNetwork::BroadcastCtrl(const std::vector<const C4GameControlPacket *> &Pkts, bool fAllClients)
+{
+	// like C4Network2ClientList::BroadcastMsgToConnClients / BroadcastMsgToClients, once for each format
+	C4PacketFwd Fwd; Fwd.SetListType(true);
+	bool fSuccess = true;
+	for (bool fPacked : { true, false })
+	{
+		pNetwork->NetIO.BeginBroadcast(false);
+		bool fAny = false;
+		for (C4Network2Client *pClient = pNetwork->Clients.GetNextClient(nullptr); pClient; pClient = pNetwork->Clients.GetNextClient(pClient))
+			if (pClient->isConnected() && !(fAllClients && pClient->isHost()))
+				if (pClient->getMsgConn()->hasPackedControl() == fPacked)
+				{
+					pClient->getMsgConn()->SetBroadcastTarget(true);
+					Fwd.AddClient(pClient->getID());
+					fAny = true;
+				}
+		if (fAny)
+		{
+			if (fPacked)
+				fSuccess &= pNetwork->NetIO.Broadcast(MkC4NetIOPacket(PID_ControlPacked, C4PacketControlPacked(Pkts)));
+			else
+				for (const C4GameControlPacket *pPkt : Pkts)
+					fSuccess &= pNetwork->NetIO.Broadcast(MkC4NetIOPacket(PID_Control, *pPkt));
+		}
+		pNetwork->NetIO.EndBroadcast();
+	}
+	// clients: the host forwards to everybody else (plain, as it can't know what they understand)
+	if (fAllClients && !fHost)
+		for (const C4GameControlPacket *pPkt : Pkts)
+		{
+			Fwd.SetData(MkC4NetIOPacket(PID_Control, *pPkt));
+			fSuccess &= pNetwork->Clients.SendMsgToHost(MkC4NetIOPacket(PID_FwdReq, Fwd));
+		}
+	return fSuccess;
 }
 
 void C4GameControlNetwork::HandleControlPkt(C4PacketType eCtrlType, C4ControlPacket *pCtrl, C4ControlDeliveryType eType) // main thread
@@ -694,6 +777,8 @@ void C4GameControlNetwork::CheckCompleteCtrl(bool fSetEvent) // by both
 	CStdLock CtrlLock(&CtrlCSec);
 	CStdLock ClientLock(&ClientsCSec);
 
+	// complete control packed by the host, sent to the clients together
+	std::vector<const C4GameControlPacket *> Packed;
 	for (;;)
 	{
 		// control available?
@@ -717,6 +802,7 @@ void C4GameControlNetwork::CheckCompleteCtrl(bool fSetEvent) // by both
 			// (try to) pack
 			if (!(pComplete = PackCompleteCtrl(iControlReady + 1)))
 				break;
+			Packed.push_back(pComplete);
 		}
 		// preexecute to check if it's ready for execute
 		if (!pComplete->getControl().PreExecute())
@@ -727,6 +813,9 @@ void C4GameControlNetwork::CheckCompleteCtrl(bool fSetEvent) // by both
 		if (fSetEvent && Game.GameGo && iControlReady >= ::Control.ControlTick)
 			Application.NextTick();
 	}
+	// host: send to clients (central and async mode)
+	if (!Packed.empty() && eMode != CNM_Decentral)
+		BroadcastCtrl(Packed, false);
 	// clear old ctrl
 	if (::Control.ControlTick >= C4ControlBacklog)
 		ClearCtrl(::Control.ControlTick - C4ControlBacklog);
@@ -788,10 +877,6 @@ C4GameControlPacket *C4GameControlNetwork::PackCompleteCtrl(int32_t iTick)
 	// add to list
 	AddCtrl(pComplete);
 
-	// host: send to clients (central and async mode)
-	if (eMode != CNM_Decentral)
-		::Network.Clients.BroadcastMsgToConnClients(MkC4NetIOPacket(PID_Control, *pComplete));
-
 	// advance control request time
 	tNextControlRequest = std::max(tNextControlRequest, C4TimeMilliseconds::Now() + C4ControlRequestInterval);
 
@@ -915,3 +1000,198 @@ void C4GameControlClient::AddPerf(int32_t iTime)
 {
 	iPerformance += (iTime * 100 - iPerformance) / 100;
 }
+
+// *** C4PacketControlPacked
+
+void C4PacketControlPacked::Item::CompileFunc(StdCompiler *pComp)
+{
+	pComp->Value(mkNamingAdapt(Type, "Type", 0));
+	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iPrefix), "Prefix", 0));
+	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iSuffix), "Suffix", 0));
+	pComp->Value(mkNamingAdapt(Middle, "Middle"));
+}
+
+void C4PacketControlPacked::Entry::CompileFunc(StdCompiler *pComp)
+{
+	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iClientID), "ClientID", C4ClientIDUnknown));
+	pComp->Value(mkNamingAdapt(mkIntPackAdapt(iTickDiff), "TickDiff", 0));
+	pComp->Value(mkNamingAdapt(mkSTLContainerAdapt(Items), "Items"));
+}
+
+void C4PacketControlPacked::Pack(const std::vector<const C4GameControlPacket *> &Pkts)
+{
+	std::vector<Entry> Entries(Pkts.size());
+	// last control packet of each type, as written by StdCompilerPackedBinWrite
+	std::map<uint8_t, StdBuf> Last;
+	int32_t iLastTick = 0;
+	for (size_t i = 0; i < Pkts.size(); i++)
+	{
+		Entry &rEntry = Entries[i];
+		rEntry.iClientID = Pkts[i]->getClientID();
+		rEntry.iTickDiff = Pkts[i]->getCtrlTick() - iLastTick;
+		iLastTick = Pkts[i]->getCtrlTick();
+		const C4Control &rCtrl = Pkts[i]->getControl();
+		for (C4IDPacket *pPkt = rCtrl.firstPkt(); pPkt; pPkt = rCtrl.nextPkt(pPkt))
+		{
+			Item Item;
+			Item.Type = uint8_t(pPkt->getPktType());
+			StdBuf Body = DecompileToBuf<StdCompilerPackedBinWrite>(*pPkt);
+			// find bytes in common with the last packet of this type
+			StdBuf &rLast = Last[Item.Type];
+			const uint8_t *pBody = getBufPtr<uint8_t>(Body), *pLast = getBufPtr<uint8_t>(rLast);
+			size_t iMax = std::min(Body.getSize(), rLast.getSize()), iPrefix = 0, iSuffix = 0;
+			while (iPrefix < iMax && pBody[iPrefix] == pLast[iPrefix])
+				iPrefix++;
+			while (iPrefix + iSuffix < iMax && pBody[Body.getSize() - 1 - iSuffix] == pLast[rLast.getSize() - 1 - iSuffix])
+				iSuffix++;
+			Item.iPrefix = iPrefix; Item.iSuffix = iSuffix;
+			Item.Middle.Copy(pBody + iPrefix, Body.getSize() - iPrefix - iSuffix);
+			rEntry.Items.push_back(std::move(Item));
+			rLast = std::move(Body);
+		}
+	}
+	Data = DecompileToBuf<StdCompilerPackedBinWrite>(mkSTLContainerAdapt(Entries));
+}
+
+bool C4PacketControlPacked::Unpack(std::vector<std::unique_ptr<C4GameControlPacket> > *pPkts) const
+{
+	try
+	{
+		std::vector<Entry> Entries;
+		CompileFromBuf<StdCompilerPackedBinRead>(mkSTLContainerAdapt(Entries), Data);
+		std::map<uint8_t, StdBuf> Last;
+		int32_t iTick = 0;
+		for (Entry &rEntry : Entries)
+		{
+			std::unique_ptr<C4GameControlPacket> pCtrl(new C4GameControlPacket());
+			iTick += rEntry.iTickDiff;
+			pCtrl->Set(rEntry.iClientID, iTick);
+			for (Item &rItem : rEntry.Items)
+			{
+				// restore the packet from the last one of its type
+				StdBuf &rLast = Last[rItem.Type];
+				if (rItem.iPrefix < 0 || rItem.iSuffix < 0 || size_t(rItem.iPrefix) + rItem.iSuffix > rLast.getSize())
+				{
+					Application.InteractiveThread.ThreadLog("Network: Invalid packed control: bad reference to previous packet");
+					return false;
+				}
+				StdBuf Body; Body.New(rItem.iPrefix + rItem.Middle.getSize() + rItem.iSuffix);
+				Body.Write(rLast.getData(), rItem.iPrefix);
+				Body.Write(rItem.Middle, rItem.iPrefix);
+				Body.Write(getBufPtr<uint8_t>(rLast) + rLast.getSize() - rItem.iSuffix, rItem.iSuffix, rItem.iPrefix + rItem.Middle.getSize());
+				C4IDPacket Pkt;
+				CompileFromBuf<StdCompilerPackedBinRead>(Pkt, Body);
+				if (Pkt.getPktType() != rItem.Type || Pkt.getPktType() < CID_First)
+				{
+					Application.InteractiveThread.ThreadLog("Network: Invalid packed control: not a control packet");
+					return false;
+				}
+				pCtrl->Ctrl.Add(Pkt.getPktType(), static_cast<C4ControlPacket *>(Pkt.getPkt()));
+				Pkt.Default();
+				rLast = std::move(Body);
+			}
+			pPkts->push_back(std::move(pCtrl));
+		}
+	}
+	catch (StdCompiler::Exception *pExc)
+	{
+		Application.InteractiveThread.ThreadLogS("Network: Invalid packed control: %s", pExc->Msg.getData());
+		delete pExc;
+		return false;
+	}
+	return true;
+}
+
+void C4PacketControlPacked::CompileFunc(StdCompiler *pComp)
+{
+	pComp->Value(mkNamingAdapt(Data, "Data"));
+}
+
+void C4PacketControlPacked::Benchmark(int32_t iClients)
+{
+	typedef std::chrono::steady_clock clock;
+	const int32_t iTicks = 3000;
+	iClients = Clamp<int32_t>(iClients, 1, 64);
+	// generate control: Most of the time players hold their keys, sometimes they press a few and aim somewhere
+	std::vector<std::unique_ptr<C4GameControlPacket> > ClientCtrl, CompleteCtrl;
+	uint32_t iSeed = 4711;
+	auto Rnd = [&iSeed](int32_t iRange) { iSeed = iSeed * 1103515245 + 12345; return int32_t((iSeed >> 16) % iRange); };
+	for (int32_t iTick = 1; iTick <= iTicks; iTick++)
+	{
+		C4GameControlPacket *pComplete = new C4GameControlPacket();
+		pComplete->Set(C4ClientIDAll, iTick);
+		for (int32_t iClient = 0; iClient < iClients; iClient++)
+		{
+			C4Control Ctrl;
+			if (Rnd(3) == 0)
+				for (int32_t i = Rnd(3); i >= 0; i--)
+				{
+					C4KeyEventData ExtraData(100, 200 + iClient * 50 + Rnd(40), 300 + Rnd(20), C4KeyEventData::KeyPos_None, C4KeyEventData::KeyPos_None);
+					C4ControlPlayerControl *pCtrl = new C4ControlPlayerControl(iClient, Rnd(4) ? C4PlayerControl::CONS_Down : C4PlayerControl::CONS_Up, ExtraData);
+					pCtrl->AddControl(Rnd(30), Rnd(2));
+					Ctrl.Add(CID_PlrControl, pCtrl);
+				}
+			C4GameControlPacket *pCtrl = new C4GameControlPacket();
+			pCtrl->Set(iClient, iTick, Ctrl);
+			pComplete->Add(*pCtrl);
+			ClientCtrl.emplace_back(pCtrl);
+		}
+		CompleteCtrl.emplace_back(pComplete);
+	}
+	LogF("Control benchmark: %d clients, %d ticks", iClients, iTicks);
+	// measure the traffic of one connection: per client packet to the host, and complete control in batches of one or more ticks
+	struct Case { const char *szName; const std::vector<std::unique_ptr<C4GameControlPacket> > *pCtrl; size_t iBatch; };
+	const Case Cases[] =
+	{
+		{ "client to host", &ClientCtrl, 1 },
+		{ "host to client", &CompleteCtrl, 1 },
+		{ "host to client, 4 ticks batched", &CompleteCtrl, 4 },
+	};
+	for (const Case &rCase : Cases)
+	{
+		// only one client's packets for the client to host case
+		std::vector<const C4GameControlPacket *> Pkts;
+		for (auto &pPkt : *rCase.pCtrl)
+			if (pPkt->getClientID() == C4ClientIDAll || pPkt->getClientID() == 0)
+				Pkts.push_back(pPkt.get());
+		size_t iPlainSize = 0, iPackedSize = 0; bool fOK = true;
+		clock::duration tPlainEncode{}, tPlainDecode{}, tPackedEncode{}, tPackedDecode{};
+		for (size_t i = 0; i < Pkts.size(); i += rCase.iBatch)
+		{
+			std::vector<const C4GameControlPacket *> Batch(Pkts.begin() + i, Pkts.begin() + std::min(i + rCase.iBatch, Pkts.size()));
+			// plain: one PID_Control for each tick
+			std::vector<C4NetIOPacket> Plain;
+			auto tStart = clock::now();
+			for (const C4GameControlPacket *pPkt : Batch)
+				Plain.push_back(MkC4NetIOPacket(PID_Control, *pPkt));
+			auto tEncoded = clock::now();
+			for (C4NetIOPacket &rPkt : Plain)
+			{
+				C4GameControlPacket Pkt;
+				CompileFromBuf<StdCompilerBinRead>(Pkt, rPkt.getPBuf());
+			}
+			tPlainDecode += clock::now() - tEncoded; tPlainEncode += tEncoded - tStart;
+			for (C4NetIOPacket &rPkt : Plain)
+				iPlainSize += rPkt.getSize();
+			// packed
+			tStart = clock::now();
+			C4NetIOPacket Packed = MkC4NetIOPacket(PID_ControlPacked, C4PacketControlPacked(Batch));
+			tEncoded = clock::now();
+			C4PacketControlPacked Received;
+			CompileFromBuf<StdCompilerBinRead>(Received, Packed.getPBuf());
+			std::vector<std::unique_ptr<C4GameControlPacket> > Unpacked;
+			fOK &= Received.Unpack(&Unpacked);
+			tPackedDecode += clock::now() - tEncoded; tPackedEncode += tEncoded - tStart;
+			iPackedSize += Packed.getSize();
+			// must round-trip exactly
+			fOK &= Unpacked.size() == Batch.size();
+			for (size_t j = 0; fOK && j < Batch.size(); j++)
+				fOK &= DecompileToBuf<StdCompilerBinWrite>(*Batch[j]) == DecompileToBuf<StdCompilerBinWrite>(*Unpacked[j]);
+		}
+		auto us = [&Pkts](clock::duration t) { return std::chrono::duration<double, std::micro>(t).count() / Pkts.size(); };
+		LogF("  %s: plain %.1f bytes/tick, encode %.2f us, decode %.2f us; packed %.1f bytes/tick (%+.1f%%), encode %.2f us, decode %.2f us%s",
+			rCase.szName, double(iPlainSize) / Pkts.size(), us(tPlainEncode), us(tPlainDecode),
+			double(iPackedSize) / Pkts.size(), (double(iPackedSize) / iPlainSize - 1) * 100, us(tPackedEncode), us(tPackedDecode),
+			fOK ? "" : " - ROUND TRIP FAILED");
+	}
+}
@@ -30,6 +30,13 @@ const int32_t C4ControlBacklog = 100, // (ctrl ticks)
 
 const uint32_t C4ControlRequestInterval = 2000; // (ms)
 
+// control packet formats, announced to each peer by PID_ControlFormat
+enum C4ControlFormat
+{
+	CCF_Plain  = 0, // PID_Control only
+	CCF_Packed = 1  // PID_ControlPacked, too
+};
+
 enum C4GameControlNetworkMode
 {
 	CNM_Decentral = 0, // 0 is the standard mode set in config
@@ -146,6 +153,11 @@ protected:
 	void RemoveClient(int32_t iClientID); // by main thread
 	void ClearClients(); // by main thread
 
+	// sending control, packed for connections that support it
+	bool SendCtrl(C4Network2IOConnection *pConn, const std::vector<const C4GameControlPacket *> &Pkts);
+	bool SendCtrlToHost(const std::vector<const C4GameControlPacket *> &Pkts);
+	bool BroadcastCtrl(const std::vector<const C4GameControlPacket *> &Pkts, bool fAllClients); // fAllClients: forward to clients that aren't connected
+
 	// packet handling
 	void HandleControl(int32_t iByClientID, const C4GameControlPacket &rPkt);
 	void HandleControlReq(const C4PacketControlReq &rPkt, C4Network2IOConnection *pConn);
@@ -172,6 +184,7 @@ protected:
 class C4GameControlPacket : public C4PacketBase
 {
 	friend class C4GameControlNetwork;
+	friend class C4PacketControlPacked;
 public:
 	C4GameControlPacket();
 
@@ -269,6 +282,61 @@ public:
 	void CompileFunc(StdCompiler *pComp) override;
 };
 
+// Control of one or more ticks in a compact format: Variable length integers,
+// tick numbers relative to the previous packet, and each control packet stored
+// as difference to the previous one of the same type. Packets don't refer to
+// earlier packets, so they can be lost, resent or forwarded like PID_Control.
+class C4PacketControlPacked : public C4PacketBase
+{
+public:
+	C4PacketControlPacked() = default;
+	C4PacketControlPacked(const std::vector<const C4GameControlPacket *> &Pkts) { Pack(Pkts); }
+
+protected:
+	StdCopyBuf Data;
+
+	// one control packet: bytes in common with the previous packet of that type, and the rest
+	struct Item
+	{
+		uint8_t Type{0};
+		int32_t iPrefix{0}, iSuffix{0};
+		StdCopyBuf Middle;
+		void CompileFunc(StdCompiler *pComp);
+	};
+	// one C4GameControlPacket
+	struct Entry
+	{
+		int32_t iClientID{0}, iTickDiff{0};
+		std::vector<Item> Items;
+		void CompileFunc(StdCompiler *pComp);
+	};
+
+public:
+	size_t getSize() const { return Data.getSize(); }
+
+	void Pack(const std::vector<const C4GameControlPacket *> &Pkts);
+	bool Unpack(std::vector<std::unique_ptr<C4GameControlPacket> > *pPkts) const;
+
+	void CompileFunc(StdCompiler *pComp) override;
+
+	// encode and decode generated control of several clients in both formats and log the sizes and times
+	static void Benchmark(int32_t iClients);
+};
+
+class C4PacketControlFormat : public C4PacketBase
+{
+public:
+	C4PacketControlFormat(int32_t iFormat = CCF_Plain) : iFormat(iFormat) { }
+
+protected:
+	int32_t iFormat;
+
+public:
+	int32_t getFormat() const { return iFormat; }
+
+	void CompileFunc(StdCompiler *pComp) override { pComp->Value(mkNamingAdapt(iFormat, "Format", CCF_Plain)); }
+};
+
 class C4PacketExecSyncCtrl : public C4PacketBase
 {
 public:
@@ -1884,6 +1884,9 @@ void C4NetIOTCP::Peer::ClearStatistics() // (mt-safe)
 
 // *** C4NetIOSimpleUDP
 
+const size_t C4NetIOSimpleUDP::iRecvSlotCnt = 16,
+             C4NetIOSimpleUDP::iRecvSlotSize = 2048;
+
 C4NetIOSimpleUDP::C4NetIOSimpleUDP()
 		: iPort(~0), sock(INVALID_SOCKET)
 {
@@ -1974,6 +1977,9 @@ bool C4NetIOSimpleUDP::Init(uint16_t inPort)
 
 #endif
 
+	// receive buffer
+	RecvBuf.New(iRecvSlotCnt * iRecvSlotSize);
+
 	// set flags
 	fInit = true;
 	fMultiCast = false;
@@ -2114,6 +2120,59 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime, pollfd *)
 	if (eWR == WR_Cancelled || eWR == WR_Timeout) return true;
 	assert(eWR == WR_Readable);
 
+#ifdef HAVE_SENDMMSG
+	// read packets from socket, up to iRecvSlotCnt at once
+	mmsghdr Msgs[iRecvSlotCnt]; iovec Vecs[iRecvSlotCnt]; addr_t SrcAddrs[iRecvSlotCnt];
+	for (;;)
+	{
+		for (size_t i = 0; i < iRecvSlotCnt; i++)
+		{
+			Vecs[i].iov_base = getMBufPtr<char>(RecvBuf, i * iRecvSlotSize);
+			Vecs[i].iov_len = iRecvSlotSize;
+			Msgs[i].msg_hdr = msghdr();
+			Msgs[i].msg_hdr.msg_name = static_cast<sockaddr *>(&SrcAddrs[i]);
+			Msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in6);
+			Msgs[i].msg_hdr.msg_iov = &Vecs[i];
+			Msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		int iMsgCnt = ::recvmmsg(sock, Msgs, iRecvSlotCnt, MSG_DONTWAIT, nullptr);
+		// error?
+		if (iMsgCnt == SOCKET_ERROR)
+		{
+			// all read
+			if (HaveWouldBlockError())
+				break;
+			if (HaveConnResetError())
+			{
+				// this is actually some kind of notification: an ICMP msg (unreachable)
+				// came back, so callback and continue reading
+				if (pCB) pCB->OnDisconn(addr_t(), this, GetSocketErrorMsg());
+				continue;
+			}
+			// this is the real thing, though
+			SetError("could not receive data from socket", true);
+			return false;
+		}
+		for (int i = 0; i < iMsgCnt; i++)
+		{
+			// invalid address?
+			socklen_t iSrcAddrLen = Msgs[i].msg_hdr.msg_namelen;
+			if ((iSrcAddrLen != sizeof(sockaddr_in) && iSrcAddrLen != sizeof(sockaddr_in6)) || SrcAddrs[i].GetFamily() == addr_t::UnknownFamily)
+			{
+				SetError("recvmmsg returned an invalid address");
+				return false;
+			}
+			// empty, or too large for a slot? C4NetIOUDP never sends datagrams that large, so ignore it.
+			if (!Msgs[i].msg_len || (Msgs[i].msg_hdr.msg_flags & MSG_TRUNC))
+				continue;
+			// callback, the packet just references the receive buffer
+			if (pCB) pCB->OnPacket(C4NetIOPacket(Vecs[i].iov_base, Msgs[i].msg_len, false, SrcAddrs[i]), this);
+		}
+		// buffer not filled? then there's nothing more to read
+		if (size_t(iMsgCnt) < iRecvSlotCnt)
+			break;
+	}
+#else
 	// read packets from socket
 	for (;;)
 	{
@@ -2133,11 +2192,12 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime, pollfd *)
 		// nothing?
 		if (!iMaxMsgSize)
 			break;
-		// alloc buffer
-		C4NetIOPacket Pkt; Pkt.New(iMaxMsgSize);
+		// grow buffer if needed
+		if (RecvBuf.getSize() < size_t(iMaxMsgSize))
+			RecvBuf.New(iMaxMsgSize);
 		// read data (note: it is _not_ garantueed that iMaxMsgSize bytes are available)
 		addr_t SrcAddr; socklen_t iSrcAddrLen = sizeof(sockaddr_in6);
-		int iMsgSize = ::recvfrom(sock, getMBufPtr<char>(Pkt), iMaxMsgSize, 0, &SrcAddr, &iSrcAddrLen);
+		int iMsgSize = ::recvfrom(sock, getMBufPtr<char>(RecvBuf), iMaxMsgSize, 0, &SrcAddr, &iSrcAddrLen);
 		// error?
 		if (iMsgSize == SOCKET_ERROR)
 		{
@@ -2166,12 +2226,10 @@ bool C4NetIOSimpleUDP::Execute(int iMaxTime, pollfd *)
 			// docs say that the connection has been closed (whatever that means for a connectionless socket...)
 			// let's just pretend it didn't happen, but stop reading.
 			break;
-		// fill in packet information
-		Pkt.SetSize(iMsgSize);
-		Pkt.SetAddr(SrcAddr);
-		// callback
-		if (pCB) pCB->OnPacket(Pkt, this);
+		// callback, the packet just references the receive buffer
+		if (pCB) pCB->OnPacket(C4NetIOPacket(RecvBuf.getData(), iMsgSize, false, SrcAddr), this);
 	}
+#endif
 
 	// ok
 	return true;
@@ -2197,6 +2255,76 @@ bool C4NetIOSimpleUDP::Send(const C4NetIOPacket &rPacket)
 	return true;
 }
 
+bool C4NetIOSimpleUDP::SendDatagrams(const Datagram *pDgrams, size_t iCnt) // (mt-safe)
+{
+	if (!fInit) { SetError("not yet initialized"); return false; }
+
+#ifdef HAVE_SENDMMSG
+	// gather header and data, up to iSendBatch datagrams per call
+	const size_t iSendBatch = 32;
+	mmsghdr Msgs[iSendBatch]; iovec Vecs[iSendBatch][2]; addr_t Addrs[iSendBatch];
+	while (iCnt)
+	{
+		size_t iBatch = std::min(iCnt, iSendBatch);
+		for (size_t i = 0; i < iBatch; i++)
+		{
+			Addrs[i] = pDgrams[i].Addr;
+			Vecs[i][0].iov_base = const_cast<void *>(pDgrams[i].pHdr); Vecs[i][0].iov_len = pDgrams[i].iHdrSize;
+			Vecs[i][1].iov_base = const_cast<void *>(pDgrams[i].pData); Vecs[i][1].iov_len = pDgrams[i].iDataSize;
+			Msgs[i].msg_hdr = msghdr();
+			Msgs[i].msg_hdr.msg_name = static_cast<sockaddr *>(&Addrs[i]);
+			Msgs[i].msg_hdr.msg_namelen = Addrs[i].GetAddrLen();
+			Msgs[i].msg_hdr.msg_iov = Vecs[i];
+			Msgs[i].msg_hdr.msg_iovlen = 2;
+		}
+		int iSent = ::sendmmsg(sock, Msgs, iBatch, 0);
+		if (iSent == SOCKET_ERROR)
+		{
+			if (!HaveWouldBlockError())
+			{
+				SetError("socket sendmmsg failed", true);
+				return false;
+			}
+			// buffer full: the datagram is lost, as it could have been on the way
+			iSent = 1;
+		}
+		pDgrams += iSent; iCnt -= iSent;
+	}
+#else
+	for (; iCnt; pDgrams++, iCnt--)
+	{
+		addr_t addr = pDgrams->Addr;
+#ifdef HAVE_WINSOCK
+		WSABUF Bufs[2];
+		Bufs[0].buf = static_cast<CHAR *>(const_cast<void *>(pDgrams->pHdr)); Bufs[0].len = pDgrams->iHdrSize;
+		Bufs[1].buf = static_cast<CHAR *>(const_cast<void *>(pDgrams->pData)); Bufs[1].len = pDgrams->iDataSize;
+		DWORD iSent;
+		if (::WSASendTo(sock, Bufs, 2, &iSent, 0, &addr, addr.GetAddrLen(), nullptr, nullptr) == SOCKET_ERROR &&
+		    !HaveWouldBlockError())
+#else
+		iovec Vecs[2];
+		Vecs[0].iov_base = const_cast<void *>(pDgrams->pHdr); Vecs[0].iov_len = pDgrams->iHdrSize;
+		Vecs[1].iov_base = const_cast<void *>(pDgrams->pData); Vecs[1].iov_len = pDgrams->iDataSize;
+		msghdr Msg = msghdr();
+		Msg.msg_name = static_cast<sockaddr *>(&addr);
+		Msg.msg_namelen = addr.GetAddrLen();
+		Msg.msg_iov = Vecs;
+		Msg.msg_iovlen = 2;
+		if (::sendmsg(sock, &Msg, 0) == SOCKET_ERROR &&
+		    !HaveWouldBlockError())
+#endif
+		{
+			SetError("socket send failed", true);
+			return false;
+		}
+	}
+#endif
+
+	// ok
+	ResetError();
+	return true;
+}
+
 bool C4NetIOSimpleUDP::Broadcast(const C4NetIOPacket &rPacket)
 {
 	// just set broadcast address and send
@@ -2755,7 +2883,7 @@ bool C4NetIOUDP::Broadcast(const C4NetIOPacket &rPacket) // (mt-safe)
 	{
 		CStdLock OutLock(&OutCSec);
 		// send it via multicast: encapsulate packet
-		Packet *pPkt = new Packet(rPacket.Duplicate(), iOPacketCounter);
+		Packet *pPkt = new Packet(rPacket, iOPacketCounter);
 		iOPacketCounter += pPkt->FragmentCnt();
 		// add to list
 		OPackets.AddPacket(pPkt);
@@ -2915,6 +3043,68 @@ void C4NetIOUDP::OnAddAddress(const addr_t &FromAddr, const AddAddrPacket &Packe
 	pPeer2->Close("address equivalence detected");
 }
 
+// * C4NetIOUDP::BufferPool
+
+void *C4NetIOUDP::BufferPool::Alloc(size_t iSize) // (mt-safe)
+{
+	int iClass = GetSizeClass(iSize);
+	{
+		CStdLock PoolLock(&PoolCSec);
+		// reuse a free block of this size class
+		if (iClass >= 0 && pFree[iClass])
+		{
+			FreeBlock *pBlock = pFree[iClass];
+			pFree[iClass] = pBlock->Next; iFreeSize -= MinBlockSize << iClass;
+			return pBlock;
+		}
+		iHeapAllocCnt++;
+	}
+	// allocate the full class size, so the block can be reused for any size of the class
+	return ::operator new(iClass >= 0 ? MinBlockSize << iClass : iSize);
+}
+
+void C4NetIOUDP::BufferPool::Free(void *pBlock, size_t iSize) // (mt-safe)
+{
+	if (!pBlock) return;
+	int iClass = GetSizeClass(iSize);
+	if (iClass >= 0)
+	{
+		CStdLock PoolLock(&PoolCSec);
+		// keep it for later, unless the pool has grown too large
+		size_t iBlockSize = MinBlockSize << iClass;
+		if (iFreeSize + iBlockSize <= MaxFreeSize)
+		{
+			FreeBlock *pFreeBlock = static_cast<FreeBlock *>(pBlock);
+			pFreeBlock->Next = pFree[iClass]; pFree[iClass] = pFreeBlock;
+			iFreeSize += iBlockSize;
+			return;
+		}
+	}
+	::operator delete(pBlock);
+}
+
+int C4NetIOUDP::BufferPool::GetSizeClass(size_t iSize)
+{
+	// too large to be pooled?
+	if (iSize > MaxBlockSize) return -1;
+	int iClass = 0;
+	for (size_t iBlockSize = MinBlockSize; iBlockSize < iSize; iBlockSize *= 2)
+		iClass++;
+	return iClass;
+}
+
+C4NetIOUDP::BufferPool &C4NetIOUDP::GetBufferPool()
+{
+	// never destroyed, as packets might still be freed by static destructors
+	static BufferPool *pPool = new BufferPool();
+	return *pPool;
+}
+
+unsigned int C4NetIOUDP::GetHeapAllocCount()
+{
+	return GetBufferPool().GetHeapAllocCount();
+}
+
 // * C4NetIOUDP::Packet
 
 // construction / destruction
@@ -2926,17 +3116,17 @@ C4NetIOUDP::Packet::Packet()
 
 }
 
-C4NetIOUDP::Packet::Packet(C4NetIOPacket &&rnData, nr_t inNr)
-		: iNr(inNr),
-		Data(rnData),
-		pFragmentGot(nullptr)
+C4NetIOUDP::Packet::Packet(const C4NetIOPacket &rData, nr_t inNr)
+		: iNr(inNr)
 {
-
+	AllocData(rData.getSize(), rData.getAddr());
+	if (rData.getSize())
+		memcpy(pBuf, rData.getData(), rData.getSize());
 }
 
 C4NetIOUDP::Packet::~Packet()
 {
-	delete [] pFragmentGot; pFragmentGot = nullptr;
+	FreeData();
 }
 
 // implementation
@@ -2944,28 +3134,38 @@ C4NetIOUDP::Packet::~Packet()
 const size_t C4NetIOUDP::Packet::MaxSize = 512;
 const size_t C4NetIOUDP::Packet::MaxDataSize = MaxSize - sizeof(DataPacketHdr);
 
+void C4NetIOUDP::Packet::AllocData(size_t iSize, const C4NetIO::addr_t &addr)
+{
+	FreeData();
+	pBuf = static_cast<char *>(GetBufferPool().Alloc(iSize));
+	Data.Ref(pBuf, iSize); Data.SetAddr(addr);
+}
+
+void C4NetIOUDP::Packet::FreeData()
+{
+	// (fragment list size depends on the data size, so free it first)
+	if (pFragmentGot) { GetBufferPool().Free(pFragmentGot, FragmentCnt()); pFragmentGot = nullptr; }
+	if (pBuf) { GetBufferPool().Free(pBuf, Data.getSize()); pBuf = nullptr; }
+	Data.Clear();
+}
+
 C4NetIOUDP::Packet::nr_t C4NetIOUDP::Packet::FragmentCnt() const
 {
 	return Data.getSize() ? (Data.getSize() - 1) / MaxDataSize + 1 : 1;
 }
 
-C4NetIOPacket C4NetIOUDP::Packet::GetFragment(nr_t iFNr, bool fBroadcastFlag) const
+void C4NetIOUDP::Packet::GetFragment(nr_t iFNr, bool fBroadcastFlag, DataPacketHdr *pHdr, Datagram *pDgram) const
 {
 	assert(iFNr < FragmentCnt());
-	// create buffer
-	uint16_t iFragmentSize = FragmentSize(iFNr);
-	StdBuf Packet; Packet.New(sizeof(DataPacketHdr) + iFragmentSize);
 	// set up header
-	DataPacketHdr *pnHdr = getMBufPtr<DataPacketHdr>(Packet);
-	pnHdr->StatusByte = IPID_Data | (fBroadcastFlag ? 0x80 : 0x00);
-	pnHdr->Nr = iNr + iFNr;
-	pnHdr->FNr = iNr;
-	pnHdr->Size = Data.getSize();
-	// copy data
-	Packet.Write(Data.getPart(iFNr * MaxDataSize, iFragmentSize),
-	             sizeof(DataPacketHdr));
-	// return
-	return C4NetIOPacket(Packet, Data.getAddr());
+	pHdr->StatusByte = IPID_Data | (fBroadcastFlag ? 0x80 : 0x00);
+	pHdr->Nr = iNr + iFNr;
+	pHdr->FNr = iNr;
+	pHdr->Size = Data.getSize();
+	// the data is sent right from the packet
+	pDgram->Addr = Data.getAddr();
+	pDgram->pHdr = pHdr; pDgram->iHdrSize = sizeof(DataPacketHdr);
+	pDgram->pData = Data.getPtr(iFNr * MaxDataSize); pDgram->iDataSize = FragmentSize(iFNr);
 }
 
 bool C4NetIOUDP::Packet::Complete() const
@@ -2993,14 +3193,15 @@ bool C4NetIOUDP::Packet::AddFragment(const C4NetIOPacket &Packet, const C4NetIO:
 	bool fFirstFragment = Empty();
 	if (fFirstFragment)
 	{
+		// check header
+		nr_t iFragmentCnt = pHdr->Size ? (pHdr->Size - 1) / MaxDataSize + 1 : 1;
+		if (pHdr->Nr < pHdr->FNr || pHdr->Nr >= pHdr->FNr + iFragmentCnt) return false;
 		// init
 		iNr = pHdr->FNr;
-		Data.New(pHdr->Size); Data.SetAddr(addr);
+		AllocData(pHdr->Size, addr);
 		// fragmented? create fragment list
-		if (FragmentCnt() > 1)
-			memset(pFragmentGot = new bool [FragmentCnt()], false, FragmentCnt());
-		// check header
-		if (pHdr->Nr < iNr || pHdr->Nr >= iNr + FragmentCnt()) { Data.Clear(); return false; }
+		if (iFragmentCnt > 1)
+			memset(pFragmentGot = static_cast<bool *>(GetBufferPool().Alloc(iFragmentCnt)), false, iFragmentCnt);
 	}
 	else
 	{
@@ -3013,17 +3214,18 @@ bool C4NetIOUDP::Packet::AddFragment(const C4NetIOPacket &Packet, const C4NetIO:
 	nr_t iFNr = pHdr->Nr - iNr;
 	if (iPacketDataSize != FragmentSize(iFNr)) return false;
 	// already got this fragment? (needs check for first packet as FragmentPresent always assumes true if pFragmentGot is nullptr)
-	StdBuf PacketData = Packet.getPart(sizeof(DataPacketHdr), iPacketDataSize);
+	const char *pPacketData = getBufPtr<char>(Packet, sizeof(DataPacketHdr));
 	if (!fFirstFragment && FragmentPresent(iFNr))
 	{
 		// compare
-		if (Data.Compare(PacketData, iFNr * MaxDataSize))
+		if (memcmp(pBuf + iFNr * MaxDataSize, pPacketData, iPacketDataSize))
 			return false;
 	}
 	else
 	{
-		// otherwise: copy data
-		Data.Write(PacketData, iFNr * MaxDataSize);
+		// otherwise: copy data into place
+		if (iPacketDataSize)
+			memcpy(pBuf + iFNr * MaxDataSize, pPacketData, iPacketDataSize);
 		// set flag (if fragmented)
 		if (pFragmentGot)
 			pFragmentGot[iFNr] = true;
@@ -3189,9 +3391,9 @@ bool C4NetIOUDP::Peer::Send(const C4NetIOPacket &rPacket) // (mt-safe)
 {
 	CStdLock OutLock(&OutCSec);
 	// encapsulate packet
-	Packet *pnPacket = new Packet(rPacket.Duplicate(), iOPacketCounter);
+	Packet *pnPacket = new Packet(rPacket, iOPacketCounter);
 	iOPacketCounter += pnPacket->FragmentCnt();
-	pnPacket->GetData().SetAddr(addr);
+	pnPacket->SetAddr(addr);
 	// add it to outgoing packet stack
 	if (!OPackets.AddPacket(pnPacket))
 		return false;
@@ -3218,7 +3420,6 @@ bool C4NetIOUDP::Peer::Check(bool fForceCheck)
 	unsigned int iStartAt = fNoReCheck ? std::max(iLastPacketAsked + 1, iIPacketCounter) : iIPacketCounter;
 	unsigned int iStartAtMC = fNoReCheck ? std::max(iLastMCPacketAsked + 1, iIMCPacketCounter) : iIMCPacketCounter;
 	// check if we have something to ask for
-	const unsigned int iMaxAskCnt = 10;
 	unsigned int i, iAskList[iMaxAskCnt], iAskCnt = 0, iMCAskCnt = 0;
 	for (i = iStartAt; i < iRIPacketCounter; i++)
 		if (!IPackets.FragmentPresent(i))
@@ -3383,11 +3584,25 @@ void C4NetIOUDP::Peer::OnRecv(const C4NetIOPacket &rPacket) // (mt-safe)
 		if (rPacket.getSize() < sizeof(DataPacketHdr)) return;
 		const DataPacketHdr *pHdr = getBufPtr<DataPacketHdr>(rPacket);
 		// already complet?
-		if (pHdr->Nr < (fBroadcasted ? iIMCPacketCounter : iIPacketCounter)) break;
-		// find or create packet
-		bool fAddPacket = false;
+		unsigned int &riPacketCounter = fBroadcasted ? iIMCPacketCounter : iIPacketCounter;
+		if (pHdr->Nr < riPacketCounter) break;
 		PacketList *pPacketList = fBroadcasted ? &IMCPackets : &IPackets;
 		Packet *pPkt = pPacketList->GetPacket(pHdr->FNr);
+		// the next packet, complete in one fragment? hand it over right from the receive buffer
+		if (eStatus == CS_Works && !pPkt && pHdr->Nr == riPacketCounter && pHdr->FNr == pHdr->Nr &&
+		    pHdr->Size <= Packet::MaxDataSize && pHdr->Size == rPacket.getSize() - sizeof(DataPacketHdr))
+		{
+			// do callback
+			if (pParent->pCB)
+				pParent->pCB->OnPacket(C4NetIOPacket(getBufPtr<char>(rPacket, sizeof(DataPacketHdr)), pHdr->Size, false, addr), pParent);
+			// advance packet counter
+			riPacketCounter = pHdr->Nr + 1;
+			// packets received out of order might be complete now
+			CheckCompleteIPackets();
+			break;
+		}
+		// find or create packet
+		bool fAddPacket = false;
 		if (!pPkt) { pPkt = new Packet(); fAddPacket = true; }
 		// add the fragment
 		if (pPkt->AddFragment(rPacket, addr))
@@ -3509,10 +3724,11 @@ bool C4NetIOUDP::Peer::DoCheck(int iAskCnt, int iMCAskCnt, unsigned int *pAskLis
 	if (!pAskList) iAskCnt = iMCAskCnt = 0;
 	// statistics
 	{ CStdLock StatLock(&StatCSec); iLoss += iAskCnt + iMCAskCnt; }
-	// alloc data
+	// build packet on the stack (Check never asks for more than iMaxAskCnt packets)
+	assert(iAskCnt + iMCAskCnt <= int(iMaxAskCnt));
 	int iAskListSize = (iAskCnt + iMCAskCnt) * sizeof(*pAskList);
-	StdBuf Packet; Packet.New(sizeof(CheckPacketHdr) + iAskListSize);
-	CheckPacketHdr *pChkPkt = getMBufPtr<CheckPacketHdr>(Packet);
+	char Buf[sizeof(CheckPacketHdr) + iMaxAskCnt * sizeof(*pAskList)];
+	CheckPacketHdr *pChkPkt = reinterpret_cast<CheckPacketHdr *>(Buf);
 	// set up header
 	pChkPkt->StatusByte = IPID_Check; // (note: always du here, see C4NetIOUDP::DoCheck)
 	pChkPkt->Nr = iOPacketCounter;
@@ -3522,20 +3738,20 @@ bool C4NetIOUDP::Peer::DoCheck(int iAskCnt, int iMCAskCnt, unsigned int *pAskLis
 	pChkPkt->AskCount = iAskCnt;
 	pChkPkt->MCAskCount = iMCAskCnt;
 	if (pAskList)
-		Packet.Write(pAskList, iAskListSize, sizeof(CheckPacketHdr));
+		memcpy(Buf + sizeof(CheckPacketHdr), pAskList, iAskListSize);
 	// send packet
-	return SendDirect(C4NetIOPacket(Packet, addr));
+	return SendDirect(C4NetIOPacket(Buf, sizeof(CheckPacketHdr) + iAskListSize, false, addr));
 }
 
 bool C4NetIOUDP::Peer::SendDirect(const Packet &rPacket, unsigned int iNr)
 {
-	// send one fragment only?
-	if (iNr + 1)
-		return SendDirect(rPacket.GetFragment(iNr - rPacket.GetNr()));
-	// otherwise: send all fragments
-	bool fSuccess = true;
-	for (unsigned int i = 0; i < rPacket.FragmentCnt(); i++)
-		fSuccess &= SendDirect(rPacket.GetFragment(i));
+	// send one fragment only, or all of them
+	unsigned int iFirst = (iNr + 1) ? iNr - rPacket.GetNr() : 0,
+	             iCnt = (iNr + 1) ? 1 : rPacket.FragmentCnt();
+	int iBytes = 0;
+	bool fSuccess = pParent->SendFragments(rPacket, iFirst, iCnt, false, addr.AsIPv6(), &iBytes);
+	// count outgoing
+	{ CStdLock StatLock(&StatCSec); iORate += iBytes; }
 	return fSuccess;
 }
 
@@ -3659,13 +3875,47 @@ void C4NetIOUDP::Peer::OnTimeout()
 
 bool C4NetIOUDP::BroadcastDirect(const Packet &rPacket, unsigned int iNr) // (mt-safe)
 {
-	// only one fragment?
-	if (iNr + 1)
-		return SendDirect(rPacket.GetFragment(iNr - rPacket.GetNr(), true));
-	// send all fragments
+	// send one fragment only, or all of them
+	unsigned int iFirst = (iNr + 1) ? iNr - rPacket.GetNr() : 0,
+	             iCnt = (iNr + 1) ? 1 : rPacket.FragmentCnt();
+	int iBytes = 0;
+	bool fSuccess = SendFragments(rPacket, iFirst, iCnt, true, C4NetIOSimpleUDP::getMCAddr(), &iBytes);
+	// statistics
+	{ CStdLock StatLock(&StatCSec); iBroadcastRate += iBytes; }
+	return fSuccess;
+}
+
+bool C4NetIOUDP::SendFragments(const Packet &rPacket, unsigned int iFirst, unsigned int iCnt, bool fBroadcast, const addr_t &toaddr, int *piBytes) // (mt-safe)
+{
+	// headers go on the stack, the data is sent right from the packet
+	const unsigned int iBatchSize = 32;
+	DataPacketHdr Hdrs[iBatchSize]; Datagram Dgrams[iBatchSize];
 	bool fSuccess = true;
-	for (unsigned int iFrgm = 0; iFrgm < rPacket.FragmentCnt(); iFrgm++)
-		fSuccess &= SendDirect(rPacket.GetFragment(iFrgm, true));
+	while (iCnt)
+	{
+		unsigned int iBatch = std::min(iCnt, iBatchSize), iDgramCnt = 0;
+		for (unsigned int i = 0; i < iBatch; i++)
+		{
+			Datagram &rDgram = Dgrams[iDgramCnt];
+			rPacket.GetFragment(iFirst + i, fBroadcast, &Hdrs[iDgramCnt], &rDgram);
+			rDgram.Addr = toaddr;
+			*piBytes += rDgram.iHdrSize + rDgram.iDataSize + iUDPHeaderSize;
+			// debug
+#ifdef C4NETIO_DEBUG
+			{
+				StdBuf Pkt; Pkt.New(rDgram.iHdrSize + rDgram.iDataSize);
+				Pkt.Write(rDgram.pHdr, rDgram.iHdrSize); Pkt.Write(rDgram.pData, rDgram.iDataSize, rDgram.iHdrSize);
+				DebugLogPkt(true, C4NetIOPacket(Pkt, toaddr));
+			}
+#endif
+#ifdef C4NETIO_SIMULATE_PACKETLOSS
+			if (UnsyncedRandom(100) < C4NETIO_SIMULATE_PACKETLOSS) continue;
+#endif
+			iDgramCnt++;
+		}
+		fSuccess &= SendDatagrams(Dgrams, iDgramCnt);
+		iFirst += iBatch; iCnt -= iBatch;
+	}
 	return fSuccess;
 }
 
@@ -3693,7 +3943,7 @@ bool C4NetIOUDP::SendDirect(C4NetIOPacket &&rPacket) // (mt-safe)
 #endif
 
 	// send it
-	return C4NetIOSimpleUDP::Send(C4NetIOPacket(rPacket.getRef(), toaddr));
+	return C4NetIOSimpleUDP::Send(C4NetIOPacket(rPacket.getData(), rPacket.getSize(), false, toaddr));
 }
 
 bool C4NetIOUDP::DoLoopbackTest()
@@ -528,6 +528,15 @@ public:
 	bool Send(const C4NetIOPacket &rPacket) override;
 	bool Broadcast(const C4NetIOPacket &rPacket) override;
 
+	// datagram made up of a header and a data part, sent without copying them together
+	struct Datagram
+	{
+		addr_t Addr;
+		const void *pHdr; size_t iHdrSize;
+		const void *pData; size_t iDataSize;
+	};
+	bool SendDatagrams(const Datagram *pDgrams, size_t iCnt); // (mt-safe)
+
 	virtual void UnBlock();
 #ifdef STDSCHEDULER_USE_EVENTS
 	HANDLE GetEvent() override;
@@ -567,6 +576,11 @@ private:
 	// multibind
 	int fAllowReUse{false};
 
+	// receive buffer, reused for all incoming datagrams
+	static const size_t iRecvSlotCnt, // = 16
+	                    iRecvSlotSize; // = 2048 (bytes)
+	StdBuf RecvBuf;
+
 protected:
 
 	// multicast address
@@ -627,6 +641,9 @@ public:
 	bool GetConnStatistic(const addr_t &addr, int *pIRate, int *pORate, int *pLoss) override;
 	void ClearStatistic() override;
 
+	// number of packet buffers that had to be taken from the heap (all instances)
+	static unsigned int GetHeapAllocCount();
+
 protected:
 
 	// *** data
@@ -659,6 +676,32 @@ protected:
 
 	static const unsigned int iUDPHeaderSize; // = 8 + 24; // (bytes)
 
+	// memory for packets and their data. Freed blocks are kept in one list per
+	// power-of-two size class, so once the outgoing packet backlog has been
+	// acknowledged a few times, sending and receiving don't need the heap anymore.
+	class BufferPool
+	{
+	public:
+		void *Alloc(size_t iSize); // (mt-safe)
+		void Free(void *pBlock, size_t iSize); // (mt-safe)
+		unsigned int GetHeapAllocCount() const { return iHeapAllocCnt; }
+
+	protected:
+		// constants
+		static const size_t MinBlockSize = 64, MaxBlockSize = 65536; // (bytes)
+		static const size_t MaxFreeSize = 4 * 1024 * 1024; // (bytes, all size classes)
+		static const unsigned int SizeClassCnt = 11;
+
+		struct FreeBlock { FreeBlock *Next; };
+		FreeBlock *pFree[SizeClassCnt]{};
+		size_t iFreeSize{0};
+		unsigned int iHeapAllocCnt{0};
+		CStdCSec PoolCSec;
+
+		static int GetSizeClass(size_t iSize);
+	};
+	static BufferPool &GetBufferPool();
+
 	// packet class
 	class PacketList;
 	class Packet
@@ -675,26 +718,34 @@ protected:
 
 		// construction / destruction
 		Packet();
-		Packet(C4NetIOPacket &&rnData, nr_t inNr);
+		Packet(const C4NetIOPacket &rData, nr_t inNr); // copies the data
 		~Packet();
 
+		// packets live in the buffer pool as well
+		static void *operator new(size_t iSize) { return GetBufferPool().Alloc(iSize); }
+		static void operator delete(void *pPacket, size_t iSize) { GetBufferPool().Free(pPacket, iSize); }
+
 	protected:
-		// data
+		// data (references pBuf, which is owned by the packet)
 		nr_t iNr;
 		C4NetIOPacket Data;
+		char *pBuf{nullptr};
 		bool *pFragmentGot{nullptr};
 
+		void AllocData(size_t iSize, const C4NetIO::addr_t &addr);
+		void FreeData();
+
 	public:
 		// data access
-		C4NetIOPacket       &GetData()          { return Data; }
 		const C4NetIOPacket &GetData()    const { return Data; }
+		void                 SetAddr(const C4NetIO::addr_t &addr) { Data.SetAddr(addr); }
 		nr_t                 GetNr()      const { return iNr; }
 		bool                 Empty()      const { return Data.isNull(); }
 		bool                 Multicast()  const { return !!(Data.getStatus() & 0x80); }
 
 		// fragmention
 		nr_t                 FragmentCnt() const;
-		C4NetIOPacket        GetFragment(nr_t iFNr, bool fBroadcastFlag = false) const;
+		void                 GetFragment(nr_t iFNr, bool fBroadcastFlag, DataPacketHdr *pHdr, Datagram *pDgram) const;
 		bool                 Complete() const;
 		bool                 FragmentPresent(nr_t iFNr) const;
 		bool                 AddFragment(const C4NetIOPacket &Packet, const C4NetIO::addr_t &addr);
@@ -746,6 +797,7 @@ protected:
 		// constants
 		static const unsigned int iConnectRetries; // = 5
 		static const unsigned int iReCheckInterval; // = 1000 (ms)
+		static const unsigned int iMaxAskCnt = 10; // packets asked for per check
 
 		// parent class
 		C4NetIOUDP *const pParent;
@@ -907,6 +959,7 @@ protected:
 
 	// sending
 	bool BroadcastDirect(const Packet &rPacket, unsigned int iNr = ~0u); // (mt-safe)
+	bool SendFragments(const Packet &rPacket, unsigned int iFirst, unsigned int iCnt, bool fBroadcast, const addr_t &toaddr, int *piBytes); // (mt-safe)
 
 	// multicast related
 	bool DoLoopbackTest();
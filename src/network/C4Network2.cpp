@@ -1418,6 +1418,9 @@ void C4Network2::HandleConnRe(const C4PacketConnRe &Pkt, C4Network2IOConnection
 	// accept connection
 	pConn->SetAccepted(); pConn->ResetAutoAccepted();
 
+	// tell the peer that we understand packed control
+	pConn->Send(MkC4NetIOPacket(PID_ControlFormat, C4PacketControlFormat(CCF_Packed)));
+
 	// add connection
 	pConn->SetCCore(pClient->getCore());
 	if (pConn->getNetClass() == NetIO.MsgIO()) pClient->SetMsgConn(pConn);
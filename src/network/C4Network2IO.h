@@ -242,6 +242,7 @@ protected:
 	StdCopyStrBuf Password;                 // password to use for connect
 	bool fConnSent{false};                         // initial connection packet send
 	bool fPostMortemSent{false};                   // post mortem send
+	bool fPackedControl{false};                    // peer understands packed control (C4GameControlNetwork)
 
 	// packet backlog
 	uint32_t iOutPacketCounter{0}, iInPacketCounter{0};
@@ -279,6 +280,7 @@ public:
 	int       getPacketLoss() const { return iPacketLoss; }
 	const char *getPassword() const { return Password.getData(); }
 	bool      isConnSent()    const { return fConnSent; }
+	bool      hasPackedControl() const { return fPackedControl; }
 
 	uint32_t  getInPacketCounter()  const { return iInPacketCounter; }
 	uint32_t  getOutPacketCounter() const { return iOutPacketCounter; }
@@ -312,6 +314,7 @@ public:
 	void SetCCore(const C4ClientCore &nCCore);
 	void ResetAutoAccepted() { fAutoAccept = false; }
 	void SetConnSent()      { fConnSent = true; }
+	void SetPackedControl() { fPackedControl = true; }
 
 	// connection operations
 	bool Connect();
@@ -137,6 +137,8 @@ enum C4PacketType
 	PID_ControlReq    = 0x41,
 	PID_ControlPkt    = 0x42,
 	PID_ExecSyncCtrl  = 0x43,
+	PID_ControlPacked = 0x44,
+	PID_ControlFormat = 0x45,
 
 	// *** control
 	CID_First         = 0x80,
@@ -35,6 +35,8 @@
 #include "platform/C4SoundSystem.h"
 #include "player/C4RankSystem.h"
 
+#include <chrono>
+
 // Helper class to load additional resources required for meshes from
 // a C4Group.
 class C4DefAdditionalResourcesLoader: public StdMeshMaterialLoader
@@ -44,11 +46,11 @@ public:
 
 	C4Surface* LoadTexture(const char* filename) override
 	{
-		if (!Group.AccessEntry(filename)) return nullptr;
+		if (!Group.FindEntry(filename)) return nullptr;
 		C4Surface* surface = new C4Surface;
 		// Suppress error message here, StdMeshMaterial loader
 		// will show one.
-		if (!surface->Read(Group, GetExtension(filename), C4SF_MipMap))
+		if (!surface->ReadEntry(Group, filename, C4SF_MipMap))
 			{ delete surface; surface = nullptr; }
 		return surface;
 	}
@@ -301,6 +303,7 @@ void C4Def::Default()
 	Next=nullptr;
 	Temporary=false;
 	Filename[0]=0;
+	std::fill(std::begin(LoadTime), std::end(LoadTime), 0.0f);
 	Creation=0;
 	Count=0;
 	MainFace.Set(nullptr,0,0,0,0);
@@ -365,21 +368,34 @@ bool C4Def::Load(C4Group &hGroup,
 
 	if (AddFileMonitoring) Game.pFileMonitor->AddDirectory(Filename);
 
+	// Time the loading phases
+	auto phase_start = std::chrono::steady_clock::now();
+	auto end_phase = [this, &phase_start](C4DefLoadPhase phase)
+	{
+		auto now = std::chrono::steady_clock::now();
+		LoadTime[phase] += std::chrono::duration<float, std::milli>(now - phase_start).count();
+		phase_start = now;
+	};
+
 	// Pre-read all images and shader stuff because they ar eaccessed in unpredictable order during loading
 	hGroup.PreCacheEntries(C4CFN_ShaderFiles);
 	hGroup.PreCacheEntries(C4CFN_ImageFiles);
+	end_phase(C4DLP_Preload);
 
 	LoadMeshMaterials(hGroup, gfx_backup);
+	end_phase(C4DLP_Graphics);
 	bool fSuccess = LoadParticleDef(hGroup);
 
 	// Read DefCore
 	if (fSuccess) fSuccess = LoadDefCore(hGroup);
+	end_phase(C4DLP_DefCore);
 
 	// Skip def: don't even read sounds!
 	if (fSuccess && Game.C4S.Definitions.SkipDefs.GetIDCount(id, 1)) return false;
 
 	// Read sounds, even if not a valid def (for pure ocd sound folders)
 	if (dwLoadWhat & C4D_Load_Sounds) LoadSounds(hGroup, pSoundSystem);
+	end_phase(C4DLP_Sounds);
 
 	// cancel if not a valid definition
 	if (!fSuccess) return false;
@@ -389,6 +405,7 @@ bool C4Def::Load(C4Group &hGroup,
 
 	// Read surface bitmap, meshes, skeletons
 	if ((dwLoadWhat & C4D_Load_Bitmap) && !LoadGraphics(hGroup, loader)) return false;
+	end_phase(C4DLP_Graphics);
 
 	// Read string table
 	C4Language::LoadComponentHost(&StringTable, hGroup, C4CFN_ScriptStringTbl, szLanguage);
@@ -399,6 +416,7 @@ bool C4Def::Load(C4Group &hGroup,
 
 	// Read script
 	if (dwLoadWhat & C4D_Load_Script) LoadScript(hGroup, szLanguage);
+	end_phase(C4DLP_Script);
 
 	// Read clonknames
 	if (dwLoadWhat & C4D_Load_ClonkNames) LoadClonkNames(hGroup, pClonkNames, szLanguage);
@@ -411,6 +429,7 @@ bool C4Def::Load(C4Group &hGroup,
 
 	// Temporary flag
 	if (dwLoadWhat & C4D_Load_Temporary) Temporary=true;
+	end_phase(C4DLP_Misc);
 
 	return true;
 }
@@ -575,10 +594,10 @@ void C4Def::LoadRankFaces(C4Group &hGroup)
 	// clear any previous
 	delete pRankSymbols; pRankSymbols = nullptr;
 	// load new
-	if (hGroup.AccessEntry(C4CFN_RankFacesPNG))
+	if (hGroup.FindEntry(C4CFN_RankFacesPNG))
 	{
 		pRankSymbols = new C4FacetSurface();
-		if (!pRankSymbols->GetFace().ReadPNG(hGroup, false)) { delete pRankSymbols; pRankSymbols = nullptr; }
+		if (!pRankSymbols->GetFace().ReadEntry(hGroup, C4CFN_RankFacesPNG, false)) { delete pRankSymbols; pRankSymbols = nullptr; }
 	}
 	// set size
 	if (pRankSymbols)
@@ -91,6 +91,18 @@ C4D_Load_FE        = C4D_Load_Image,
 C4D_Load_RX        = C4D_Load_Bitmap | C4D_Load_Script | C4D_Load_ClonkNames | C4D_Load_Sounds | C4D_Load_RankNames | C4D_Load_RankFaces,
 C4D_Load_Temporary = 1024;
 
+// Phases of definition loading, timed for the startup timing report
+enum C4DefLoadPhase
+{
+	C4DLP_Preload = 0, // group I/O and image decoding
+	C4DLP_DefCore,     // particle, mesh material and DefCore parsing
+	C4DLP_Sounds,
+	C4DLP_Graphics,    // solid mask, bitmaps, skeletons and meshes
+	C4DLP_Script,      // string table and script source
+	C4DLP_Misc,        // clonk names, rank names and rank faces
+	C4DLP_Count
+};
+
 #define C4D_Blit_Normal     0
 #define C4D_Blit_Additive   1
 #define C4D_Blit_ModAdd     2
@@ -190,6 +202,7 @@ public:
 	int32_t iNumRankSymbols;    // number of rank symbols available, if loaded
 	C4DefGraphics Graphics; // base graphics. points to additional graphics
 	CSurface8 *pSolidMask; // SolidMask-bitmap. Nonzero pixels are solid.
+	float LoadTime[C4DLP_Count]; // milliseconds spent in each phase of loading
 
 protected:
 	C4Facet MainFace;
@@ -156,22 +156,23 @@ bool C4DefGraphics::LoadBitmap(C4Group &hGroup, const char *szFilename, const ch
 
 bool C4DefGraphics::LoadMesh(C4Group &hGroup, const char* szFileName, StdMeshSkeletonLoader& loader)
 {
-	char* buf = nullptr;
-	size_t size;
+	StdBuf buf;
 
 	try
 	{
-		if(!hGroup.LoadEntry(szFileName, &buf, &size, 1)) return false;
-
 		if (SEqualNoCase(GetExtension(szFileName), "xml"))
 		{
-			Mesh = StdMeshLoader::LoadMeshXml(buf, size, ::MeshMaterialManager, loader, hGroup.GetName());
+			// The XML parser needs a terminated copy
+			StdStrBuf xml;
+			if (!hGroup.LoadEntryString(szFileName, &xml)) return false;
+			Mesh = StdMeshLoader::LoadMeshXml(xml.getData(), xml.getLength(), ::MeshMaterialManager, loader, hGroup.GetName());
 		}
 		else
 		{
-			Mesh = StdMeshLoader::LoadMeshBinary(buf, size, ::MeshMaterialManager, loader, hGroup.GetName());
+			// Binary meshes are decoded straight from the group
+			if (!hGroup.LoadEntryView(szFileName, &buf)) return false;
+			Mesh = StdMeshLoader::LoadMeshBinary(static_cast<const char *>(buf.getData()), buf.getSize(), ::MeshMaterialManager, loader, hGroup.GetName());
 		}
-		delete[] buf;
 
 		Mesh->SetLabel(pDef->id.ToString());
 
@@ -181,7 +182,6 @@ bool C4DefGraphics::LoadMesh(C4Group &hGroup, const char* szFileName, StdMeshSke
 	catch (const std::runtime_error& ex)
 	{
 		DebugLogF("Failed to load mesh in definition %s: %s", hGroup.GetName(), ex.what());
-		delete[] buf;
 		return false;
 	}
 
@@ -191,32 +191,31 @@ bool C4DefGraphics::LoadMesh(C4Group &hGroup, const char* szFileName, StdMeshSke
 
 bool C4DefGraphics::LoadSkeleton(C4Group &hGroup, const char* szFileName, StdMeshSkeletonLoader& loader)
 {
-	char* buf = nullptr;
-	size_t size;
+	// The XML parser needs a terminated copy, binary skeletons are decoded straight from the group
+	const bool xml = SEqualNoCase(GetExtension(szFileName), "xml");
+	StdStrBuf xml_buf;
+	StdBuf buf;
 
 	try
 	{
-		if (!hGroup.LoadEntry(szFileName, &buf, &size, 1)) return false;
+		if (xml ? !hGroup.LoadEntryString(szFileName, &xml_buf) : !hGroup.LoadEntryView(szFileName, &buf)) return false;
 
 		// delete skeleton from the map for reloading, or else if you delete or rename
 		// a skeleton file in the folder the old skeleton will still exist in the map
 		loader.RemoveSkeleton(hGroup.GetName(), szFileName);
 
-		if (SEqualNoCase(GetExtension(szFileName), "xml"))
+		if (xml)
 		{
-			loader.LoadSkeletonXml(hGroup.GetName(), szFileName, buf, size);
+			loader.LoadSkeletonXml(hGroup.GetName(), szFileName, xml_buf.getData(), xml_buf.getLength());
 		}
 		else
 		{
-			loader.LoadSkeletonBinary(hGroup.GetName(), szFileName, buf, size);
+			loader.LoadSkeletonBinary(hGroup.GetName(), szFileName, static_cast<const char *>(buf.getData()), buf.getSize());
 		}
-
-		delete[] buf;
 	}
 	catch (const std::runtime_error& ex)
 	{
 		DebugLogF("Failed to load skeleton in definition %s: %s", hGroup.GetName(), ex.what());
-		delete[] buf;
 		return false;
 	}
 
@@ -24,9 +24,15 @@
 #include "control/C4Record.h"
 #include "game/C4GameScript.h"
 #include "game/C4GameVersion.h"
+#include "graphics/C4Surface.h"
+#include "graphics/StdPNG.h"
 #include "lib/StdMeshLoader.h"
 #include "object/C4Def.h"
 #include "platform/C4FileMonitor.h"
+#include "platform/C4ThreadPool.h"
+
+#include <chrono>
+#include <numeric>
 
 namespace
 {
@@ -58,6 +64,44 @@ namespace
 	};
 }
 
+// Everything C4Def::Load reads from a definition group except sounds (see C4FLS_Def)
+static const char *PreloadFiles = "*.glsl|*.png|*.bmp|*.jpeg|*.jpg|*.material|*.skeleton|*.mesh|*.txt|*.c";
+
+// A definition group read on the worker pool ahead of C4Def::Load
+class C4DefPreload
+{
+public:
+	C4Group Group; // the group with all entries the loader reads cached in memory (packed groups only)
+	std::vector<std::pair<StdCopyStrBuf, std::unique_ptr<CPNGFile>>> Images; // decoded images by full path
+	float Time = 0; // milliseconds
+
+	void Run(const std::string &path, bool load_sounds)
+	{
+		auto start = std::chrono::steady_clock::now();
+		if (Group.Open(path.c_str()))
+		{
+			// Group I/O
+			if (Group.IsPacked())
+			{
+				Group.PreCacheEntries(PreloadFiles);
+				if (load_sounds) Group.PreCacheEntries(C4CFN_SoundFiles);
+			}
+			// Image decoding
+			StdStrBuf full_name = Group.GetFullName();
+			char filename[_MAX_FNAME_LEN]; *filename = 0;
+			Group.ResetSearch();
+			while (Group.FindNextEntry(C4CFN_PNGFiles, filename, nullptr, !!*filename))
+			{
+				StdBuf data;
+				auto png = std::make_unique<CPNGFile>();
+				if (!Group.LoadEntryView(filename, &data) || !png->Load(static_cast<const BYTE *>(data.getData()), data.getSize())) continue;
+				Images.emplace_back(FormatString("%s%c%s", full_name.getData(), DirectorySeparator, filename), std::move(png));
+			}
+		}
+		Time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+};
+
 C4DefList::C4DefList() : SkeletonLoader(new C4SkeletonManager)
 {
 	Default();
@@ -73,6 +117,21 @@ int32_t C4DefList::Load(C4Group &hGroup, DWORD dwLoadWhat,
                         C4SoundSystem *pSoundSystem,
                         bool fOverload,
                         bool fSearchMessage, int32_t iMinProgress, int32_t iMaxProgress, bool fLoadSysGroups)
+{
+	auto start = std::chrono::steady_clock::now();
+	int32_t iResult = LoadGroup(hGroup, dwLoadWhat, szLanguage, pSoundSystem, fOverload, fSearchMessage, iMinProgress, iMaxProgress, fLoadSysGroups);
+	// Drop whatever was read ahead but not used (skipped or failed definitions)
+	Preloads.clear();
+	C4Surface::ClearDecodedPNGs();
+	LoadWallTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return iResult;
+}
+
+int32_t C4DefList::LoadGroup(C4Group &hGroup, DWORD dwLoadWhat,
+                             const char *szLanguage,
+                             C4SoundSystem *pSoundSystem,
+                             bool fOverload,
+                             bool fSearchMessage, int32_t iMinProgress, int32_t iMaxProgress, bool fLoadSysGroups)
 {
 	int32_t iResult=0;
 	C4Def *nDef = nullptr;
@@ -94,14 +153,20 @@ int32_t C4DefList::Load(C4Group &hGroup, DWORD dwLoadWhat,
 
 	if (fThisSearchMessage) { LogF("%s...",GetFilename(hGroup.GetName())); }
 
+	// Start reading the sub definitions in the background
+	PreloadChildren(hGroup, dwLoadWhat);
+
 	// Load primary definition
 	if (can_be_primary_def)
 	{
+		std::unique_ptr<C4DefPreload> preload = TakePreload(hGroup);
+		C4Group &def_group = (preload && preload->Group.IsOpen() && preload->Group.IsPacked()) ? preload->Group : hGroup;
 		if ((nDef = new C4Def))
 		{
-			if (nDef->Load(hGroup, *SkeletonLoader, dwLoadWhat, szLanguage, pSoundSystem) && Add(nDef, fOverload))
+			if (nDef->Load(def_group, *SkeletonLoader, dwLoadWhat, szLanguage, pSoundSystem) && Add(nDef, fOverload))
 			{
 				iResult++; fPrimaryDef = true;
+				if (preload) nDef->LoadTime[C4DLP_Preload] += preload->Time;
 			}
 			else
 			{
@@ -109,6 +174,7 @@ int32_t C4DefList::Load(C4Group &hGroup, DWORD dwLoadWhat,
 				nDef = nullptr;
 			}
 		}
+		C4Surface::ClearDecodedPNGs();
 	}
 
 	// Remember localized name for pure definition groups
@@ -135,7 +201,7 @@ int32_t C4DefList::Load(C4Group &hGroup, DWORD dwLoadWhat,
 			int iSubMinProgress = std::min(iMaxProgress, iMinProgress + ((iMaxProgress - iMinProgress) * i) / 16);
 			int iSubMaxProgress = std::min(iMaxProgress, iMinProgress + ((iMaxProgress - iMinProgress) * (i + 1)) / 16);
 			++i;
-			iResult += Load(hChild,dwLoadWhat,szLanguage,pSoundSystem,fOverload,fSearchMessage,iSubMinProgress,iSubMaxProgress);
+			iResult += LoadGroup(hChild,dwLoadWhat,szLanguage,pSoundSystem,fOverload,fSearchMessage,iSubMinProgress,iSubMaxProgress,true);
 			hChild.Close();
 		}
 
@@ -173,6 +239,81 @@ int32_t C4DefList::Load(const char *szFilename,
 	return nDefs;
 }
 
+static std::string PreloadKey(const StdStrBuf &group_path)
+{
+	StdCopyStrBuf key(group_path);
+	key.ReplaceChar(AltDirectorySeparator, DirectorySeparator);
+	key.ToLowerCase();
+	return key.getData();
+}
+
+void C4DefList::PreloadChildren(C4Group &hGroup, DWORD dwLoadWhat)
+{
+	// Workers open the children by path, which only pays off if they can seek to them
+	if (hGroup.IsPacked() && hGroup.GetFormat() != C4GF_Indexed) return;
+	if (!C4ThreadPool::Default().GetThreadCount()) return;
+	bool load_sounds = !!(dwLoadWhat & C4D_Load_Sounds);
+	StdStrBuf group_path = hGroup.GetFullName();
+	char szEntryname[_MAX_FNAME_LEN];
+	hGroup.ResetSearch();
+	while (hGroup.FindNextEntry(C4CFN_DefFiles, szEntryname))
+	{
+		std::string path = FormatString("%s%c%s", group_path.getData(), DirectorySeparator, szEntryname).getData();
+		std::string key = PreloadKey(StdStrBuf(path.c_str()));
+		if (Preloads.count(key)) continue;
+		Preloads[key] = C4ThreadPool::Default().Submit([path, load_sounds]()
+		{
+			auto preload = std::make_unique<C4DefPreload>();
+			preload->Run(path, load_sounds);
+			return preload;
+		});
+	}
+}
+
+std::unique_ptr<C4DefPreload> C4DefList::TakePreload(C4Group &hGroup)
+{
+	auto it = Preloads.find(PreloadKey(hGroup.GetFullName()));
+	if (it == Preloads.end()) return nullptr;
+	auto start = std::chrono::steady_clock::now();
+	std::unique_ptr<C4DefPreload> preload = it->second.get();
+	PreloadWaitTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	Preloads.erase(it);
+	// Hand the decoded images to the surface loader
+	for (auto &image : preload->Images)
+		C4Surface::AddDecodedPNG(image.first.getData(), std::move(image.second));
+	preload->Images.clear();
+	return preload;
+}
+
+void C4DefList::LogLoadTiming(float link_time) const
+{
+	static const char *phase_names[C4DLP_Count] = { "preload", "defcore", "sounds", "graphics", "script", "misc" };
+	std::vector<const C4Def *> defs;
+	float phase_total[C4DLP_Count] = {};
+	for (const C4Def *def = FirstDef; def; def = def->Next)
+	{
+		defs.push_back(def);
+		for (int phase = 0; phase < C4DLP_Count; ++phase) phase_total[phase] += def->LoadTime[phase];
+	}
+	auto def_time = [](const C4Def *def) { return std::accumulate(def->LoadTime, def->LoadTime + C4DLP_Count, 0.0f); };
+	std::stable_sort(defs.begin(), defs.end(), [&def_time](const C4Def *a, const C4Def *b) { return def_time(a) > def_time(b); });
+
+	LogF("Startup timing: %d definitions loaded in %.1f ms using %u worker threads (%.1f ms waiting for workers), scripts linked in %.1f ms",
+	     (int)defs.size(), LoadWallTime, C4ThreadPool::Default().GetThreadCount(), PreloadWaitTime, link_time);
+	StdStrBuf phases;
+	for (int phase = 0; phase < C4DLP_Count; ++phase)
+		phases.AppendFormat("%s%s %.1f ms", phase ? ", " : "", phase_names[phase], phase_total[phase]);
+	LogF("  by phase: %s", phases.getData());
+	LogF("  %-24s %9s  %s", "definition", "total", "preload / defcore / sounds / graphics / script / misc (ms)");
+	for (const C4Def *def : defs)
+	{
+		StdStrBuf times;
+		for (int phase = 0; phase < C4DLP_Count; ++phase)
+			times.AppendFormat("%s%.1f", phase ? " / " : "", def->LoadTime[phase]);
+		LogF("  %-24s %9.1f  %s", def->id.ToString(), def_time(def), times.getData());
+	}
+}
+
 bool C4DefList::Add(C4Def *pDef, bool fOverload)
 {
 	if (!pDef) return false;
@@ -415,6 +556,7 @@ void C4DefList::Default()
 	FirstDef=nullptr;
 	LoadFailure=false;
 	table.clear();
+	LoadWallTime = PreloadWaitTime = 0;
 }
 
 bool C4DefList::Reload(C4Def *pDef, DWORD dwLoadWhat, const char *szLanguage, C4SoundSystem *pSoundSystem)
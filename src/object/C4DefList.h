@@ -22,6 +22,10 @@
 
 #include "graphics/C4FontLoaderCustomImages.h"
 
+#include <future>
+
+class C4DefPreload;
+
 class C4DefList: public CStdFontCustomImages
 {
 public:
@@ -71,12 +75,23 @@ public:
 	void AppendAndIncludeSkeletons();
 	StdMeshSkeletonLoader& GetSkeletonLoader();
 	const char *GetLocalizedGroupFolderName(const char *folder_path) const;
+	void LogLoadTiming(float link_time) const; // startup timing report: load time per phase and definition
 
 	// callback from font renderer: get ID image
 	bool DrawFontImage(const char* szImageTag, C4Facet& rTarget, C4DrawTransform* pTransform) override;
 	float GetFontImageAspect(const char* szImageTag) override;
 private:
 	std::unique_ptr<StdMeshSkeletonLoader> SkeletonLoader;
+
+	// Child definition groups read and decoded on the worker pool while the main thread
+	// loads their parent, by lower case group path
+	std::map<std::string, std::future<std::unique_ptr<C4DefPreload>>> Preloads;
+	float LoadWallTime = 0, PreloadWaitTime = 0; // milliseconds
+
+	int32_t LoadGroup(C4Group &hGroup, DWORD dwLoadWhat, const char *szLanguage, C4SoundSystem *pSoundSystem,
+	                  bool fOverload, bool fSearchMessage, int32_t iMinProgress, int32_t iMaxProgress, bool fLoadSysGroups);
+	void PreloadChildren(C4Group &hGroup, DWORD dwLoadWhat);
+	std::unique_ptr<C4DefPreload> TakePreload(C4Group &hGroup);
 };
 
 extern C4DefList Definitions;
@@ -22,6 +22,39 @@
 #include "object/C4GameObjects.h"
 #include "object/C4Object.h"
 #include "player/C4PlayerList.h"
+#include "script/C4AulExec.h"
+#include "script/C4AulScriptFunc.h"
+
+#include <chrono>
+#include <tuple>
+
+namespace
+{
+	// Measures a search for C4FindObjectProfiler while the script profiler runs
+	class ProfileScope
+	{
+		C4FindObjectProfiler::Entry *pEntry;
+		std::chrono::steady_clock::time_point tStart;
+	public:
+		ProfileScope(const char *szOperation)
+			: pEntry(C4AulProfiler::IsRunning() ? &C4FindObjectProfiler::GetEntry(szOperation) : nullptr)
+		{
+			if (!pEntry) return;
+			++pEntry->Calls;
+			tStart = std::chrono::steady_clock::now();
+		}
+		~ProfileScope()
+		{
+			if (pEntry)
+				pEntry->Time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+		}
+		explicit operator bool() const { return !!pEntry; }
+		C4FindObjectProfiler::Entry *operator ->() { return pEntry; }
+	};
+
+	// Searches sorted by distance visit the sectors nearest first if there are more candidates than this
+	const size_t NearestFirstMinCandidates = 64;
+}
 
 // *** C4FindObject
 
@@ -264,7 +297,28 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs)
 		return 0;
 	if (IsEnsured())
 		return Objs.ObjectCount();
-	// Count
+	return CountIn(Objs);
+}
+
+C4Object *C4FindObject::Find(const C4ObjectList &Objs)
+{
+	// Trivial case
+	if (IsImpossible())
+		return nullptr;
+	return FindIn(Objs);
+}
+
+// return is to be freed by the caller
+C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
+{
+	// Trivial case
+	if (IsImpossible())
+		return new C4ValueArray();
+	return FindManyIn(Objs);
+}
+
+template<class List> int32_t C4FindObject::CountIn(const List &Objs)
+{
 	int32_t iCount = 0;
 	for (C4Object *obj : Objs)
 		if (obj->Status && Check(obj))
@@ -272,12 +326,8 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs)
 	return iCount;
 }
 
-C4Object *C4FindObject::Find(const C4ObjectList &Objs)
+template<class List> C4Object *C4FindObject::FindIn(const List &Objs)
 {
-	// Trivial case
-	if (IsImpossible())
-		return nullptr;
-	// Search
 	// Double-check object status, as object might be deleted after Check()!
 	C4Object *pBestResult = nullptr;
 	for (C4Object *obj : Objs)
@@ -295,12 +345,8 @@ C4Object *C4FindObject::Find(const C4ObjectList &Objs)
 	return pBestResult;
 }
 
-// return is to be freed by the caller
-C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
+template<class List> C4ValueArray *C4FindObject::FindManyIn(const List &Objs)
 {
-	// Trivial case
-	if (IsImpossible())
-		return new C4ValueArray();
 	// Set up array
 	C4ValueArray *pArray = new C4ValueArray(32);
 	int32_t iSize = 0;
@@ -324,6 +370,131 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs)
 	return pArray;
 }
 
+bool C4FindObject::GetCacheKey(Operation op, std::string &Key)
+{
+	Key.clear();
+	AppendKeyValue(Key, op);
+	if (!AppendKey(Key)) return false;
+	// The order only matters if not just counting
+	if (pSort && op != OP_Count)
+	{
+		Key.push_back('S');
+		if (!pSort->AppendKey(Key)) return false;
+	}
+	return true;
+}
+
+void C4FindObject::GetAreaObjects(const C4Rect &Bounds, std::vector<C4Object *> &Objs, bool fDuplicates)
+{
+	// Objects are collected before they are checked, so script callbacks from
+	// Check() cannot disturb the iteration by moving objects around
+	C4LArea Area(&::Objects.Sectors, Bounds);
+	if (UseShapes())
+		Area.GetObjectShapes(Objs, fDuplicates);
+	else
+		Area.GetObjects(Objs);
+}
+
+bool C4FindObject::GetCandidates(std::vector<C4Object *> &Objs, bool fDuplicates)
+{
+	C4LSectors &Sectors = ::Objects.Sectors;
+	// All matching objects might be in the list of a prototype or of category bits
+	C4PropList *pPrototype = GetPinnedPrototype();
+	int32_t iCategory = GetPinnedCategory();
+	if (!C4LSectors::IsIndexedCategory(iCategory)) iCategory = 0;
+	const C4SpatialGrid<C4Object>::Cell *pPrototypeObjects = pPrototype ? Sectors.GetPrototypeObjects(pPrototype) : nullptr;
+	size_t iPrototypeCount = pPrototypeObjects ? pPrototypeObjects->size() : 0;
+	size_t iCategoryCount = iCategory ? Sectors.GetCategoryObjectCount(iCategory) : 0;
+	bool fUsePrototype = pPrototype && (!iCategory || iPrototypeCount <= iCategoryCount);
+	bool fUseCategory = !fUsePrototype && iCategory;
+	// Without a list, search the sectors of the bounds or all objects
+	C4Rect *pBounds = GetBounds();
+	C4LArea Area;
+	if (pBounds)
+	{
+		Area.Set(&Sectors, *pBounds);
+		if ((!fUsePrototype && !fUseCategory) || Area.GetObjectCount(UseShapes()) <= (fUsePrototype ? iPrototypeCount : iCategoryCount))
+		{
+			GetAreaObjects(*pBounds, Objs, fDuplicates);
+			return true;
+		}
+	}
+	else if (!fUsePrototype && !fUseCategory)
+		return false;
+	// Collect the list, which is in main list order
+	if (fUsePrototype)
+	{
+		if (pPrototypeObjects)
+			for (const auto &Entry : *pPrototypeObjects)
+				Objs.push_back(Entry.Obj);
+	}
+	else
+		Sectors.GetCategoryObjects(iCategory, Objs);
+	if (!pBounds) return true;
+	// Keep the objects of the area, in the order in which the sectors would have returned them
+	static std::vector<std::pair<int32_t, C4Object *>> Visits;
+	Visits.clear();
+	for (C4Object *pObj : Objs)
+	{
+		int32_t iVisit = Area.GetVisitIndex(pObj, UseShapes());
+		if (iVisit >= 0) Visits.emplace_back(iVisit, pObj);
+	}
+	std::stable_sort(Visits.begin(), Visits.end(), [](const std::pair<int32_t, C4Object *> &a, const std::pair<int32_t, C4Object *> &b) { return a.first < b.first; });
+	Objs.clear();
+	for (const auto &Visit : Visits)
+		Objs.push_back(Visit.second);
+	return true;
+}
+
+bool C4FindObject::CanFindNearest(int32_t &iX, int32_t &iY)
+{
+	// Checks must not call scripts, which could notice the changed order of calls.
+	// Shapes reach into other sectors than the position, so their bounds cannot be used.
+	if (!pSort || !pSort->GetDistanceOrigin(iX, iY)) return false;
+	return GetCost() < C4FOC_Script && !(GetBounds() && UseShapes());
+}
+
+void C4FindObject::FindNearest(int32_t iX, int32_t iY, size_t iMax, std::vector<C4Object *> &Objs, uint64_t &iChecked)
+{
+	// Matches are ordered like a linear search followed by a stable sort would order them:
+	// by distance, then by the sector visiting order of bounded searches, then by main list order
+	struct Match
+	{
+		int32_t Distance, Visit;
+		uint64_t Order;
+		C4Object *Obj;
+		bool operator <(const Match &other) const
+		{ return std::tie(Distance, Visit, Order) < std::tie(other.Distance, other.Visit, other.Order); }
+	};
+	std::vector<Match> Matches;
+	const C4SpatialGrid<C4Object> &Grid = ::Objects.Sectors.Objects;
+	C4Rect *pBounds = GetBounds();
+	C4SpatialGrid<C4Object>::Area Cells = pBounds ? Grid.GetArea(*pBounds) : Grid.GetFullArea();
+	auto VisitCell = [&](const C4SpatialGrid<C4Object>::Cell &Cell, int32_t cx, int32_t cy)
+	{
+		int32_t iVisit = !pBounds ? 0 : cx < 0 ? Grid.GetOutIndex() : cy * Grid.GetWidth() + cx;
+		for (const auto &Entry : Cell)
+		{
+			C4Object *pObj = Entry.Obj;
+			++iChecked;
+			if (!pObj->Status || !Check(pObj) || !pObj->Status) continue;
+			// Same value as C4SortObjectDistance
+			int32_t dx = pObj->GetX() - iX, dy = pObj->GetY() - iY;
+			Match NewMatch = { dx*dx + dy*dy, iVisit, pObj->SectorOrder, pObj };
+			if (Matches.size() >= iMax && !(NewMatch < Matches.back())) continue;
+			Matches.insert(std::upper_bound(Matches.begin(), Matches.end(), NewMatch), NewMatch);
+			if (Matches.size() > iMax) Matches.pop_back();
+		}
+	};
+	// Sectors know objects by their last updated position, just like for bounded searches
+	Grid.ForEachCellNearestFirst(iX, iY, Cells, VisitCell, [&Matches, iMax](int64_t iMinDistance)
+	{
+		return Matches.size() < iMax || iMinDistance <= Matches.back().Distance;
+	});
+	for (const Match &Found : Matches)
+		Objs.push_back(Found.Obj);
+}
+
 int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 {
 	// Trivial cases
@@ -331,41 +502,34 @@ int32_t C4FindObject::Count(const C4ObjectList &Objs, const C4LSectors &Sct)
 		return 0;
 	if (IsEnsured())
 		return Objs.ObjectCount();
-	// Check bounds
-	C4Rect *pBounds = GetBounds();
-	if (!pBounds)
-		return Count(Objs);
-	else if (UseShapes())
+	ProfileScope Profile("ObjectCount");
+	// Same search done before?
+	std::string Key;
+	uint32_t iGeneration = ::Objects.SearchCache.GetGeneration();
+	bool fCacheable = GetCacheKey(OP_Count, Key);
+	if (fCacheable)
+		if (const C4FindObjectCache::Result *pResult = ::Objects.SearchCache.Get(Key))
+		{
+			if (Profile) { ++Profile->CacheHits; Profile->Found += pResult->Count; }
+			return pResult->Count;
+		}
+	// Count objects of the area or of an object list
+	int32_t iCount;
+	C4LSectors::Buffer Candidates(::Objects.Sectors);
+	if (GetCandidates(Candidates.Objects, false))
 	{
-		// Get area
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4ObjectList *pLst = Area.FirstObjectShapes(&pSct);
-		// Check if a single-sector check is enough
-		if (!Area.Next(pSct))
-			return Count(pSct->ObjectShapes);
-		// Create marker, count over all areas
-		uint32_t iMarker = ::Objects.GetNextMarker();
-		int32_t iCount = 0;
-		for (; pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			for (C4Object *obj : Objs)
-				if (obj->Status)
-					if (obj->Marker != iMarker)
-					{
-						obj->Marker = iMarker;
-						if (Check(obj))
-							iCount++;
-					}
-		return iCount;
+		if (Profile) Profile->Candidates += Candidates.Objects.size();
+		iCount = CountIn(Candidates.Objects);
 	}
 	else
 	{
-		// Count objects per area
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		int32_t iCount = 0;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
-			iCount += Count(*pLst);
-		return iCount;
+		if (Profile) Profile->Candidates += Objs.ObjectCount();
+		iCount = CountIn(Objs);
 	}
+	if (Profile) Profile->Found += iCount;
+	if (fCacheable)
+		::Objects.SearchCache.Put(Key, iGeneration).Count = iCount;
+	return iCount;
 }
 
 C4Object *C4FindObject::Find(const C4ObjectList &Objs, const C4LSectors &Sct)
@@ -373,43 +537,49 @@ C4Object *C4FindObject::Find(const C4ObjectList &Objs, const C4LSectors &Sct)
 	// Trivial case
 	if (IsImpossible())
 		return nullptr;
-	C4Object *pBestResult = nullptr;
-	// Check bounds
-	C4Rect *pBounds = GetBounds();
-	if (!pBounds)
-		return Find(Objs);
-	// Traverse areas, return first matching object w/o sort or best with sort
-	else if (UseShapes())
+	ProfileScope Profile("FindObject");
+	// Same search done before?
+	std::string Key;
+	uint32_t iGeneration = ::Objects.SearchCache.GetGeneration();
+	bool fCacheable = GetCacheKey(OP_Find, Key);
+	if (fCacheable)
+		if (const C4FindObjectCache::Result *pResult = ::Objects.SearchCache.Get(Key))
+		{
+			if (Profile) { ++Profile->CacheHits; Profile->Found += pResult->Count; }
+			return pResult->Count ? pResult->Objects[0] : nullptr;
+		}
+	// Return first matching object w/o sort or best with sort. Duplicates don't change that.
+	C4Object *pObj;
+	C4LSectors::Buffer Candidates(::Objects.Sectors);
+	bool fCandidates = GetCandidates(Candidates.Objects, true);
+	int32_t iX, iY;
+	if ((fCandidates ? Candidates.Objects.size() : size_t(Objs.ObjectCount())) > NearestFirstMinCandidates && CanFindNearest(iX, iY))
 	{
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4Object *pObj;
-		for (C4ObjectList *pLst=Area.FirstObjectShapes(&pSct); pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			if ((pObj = Find(*pLst)))
-			{
-				if (!pSort)
-					return pObj;
-				else if (!pBestResult || pSort->Compare(pObj, pBestResult) > 0)
-					if (pObj->Status)
-						pBestResult = pObj;
-			}
+		// Nearest object: stop as soon as no unvisited sector can hold a closer one
+		uint64_t iChecked = 0;
+		Candidates.Objects.clear();
+		FindNearest(iX, iY, 1, Candidates.Objects, iChecked);
+		if (Profile) Profile->Candidates += iChecked;
+		pObj = Candidates.Objects.empty() ? nullptr : Candidates.Objects[0];
+	}
+	else if (fCandidates)
+	{
+		if (Profile) Profile->Candidates += Candidates.Objects.size();
+		pObj = FindIn(Candidates.Objects);
 	}
 	else
 	{
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4Object *pObj;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
-		{
-			if ((pObj = Find(*pLst)))
-			{
-				if (!pSort)
-					return pObj;
-				else if (!pBestResult || pSort->Compare(pObj, pBestResult) > 0)
-					if (pObj->Status)
-						pBestResult = pObj;
-			}
-		}
+		if (Profile) Profile->Candidates += Objs.ObjectCount();
+		pObj = FindIn(Objs);
 	}
-	return pBestResult;
+	if (Profile && pObj) ++Profile->Found;
+	if (fCacheable)
+	{
+		C4FindObjectCache::Result &Result = ::Objects.SearchCache.Put(Key, iGeneration);
+		Result.Count = pObj ? 1 : 0;
+		if (pObj) Result.Objects.push_back(pObj);
+	}
+	return pObj;
 }
 
 // return is to be freed by the caller
@@ -418,64 +588,41 @@ C4ValueArray *C4FindObject::FindMany(const C4ObjectList &Objs, const C4LSectors
 	// Trivial case
 	if (IsImpossible())
 		return new C4ValueArray();
-	C4Rect *pBounds = GetBounds();
-	if (!pBounds)
-		return FindMany(Objs);
-	// Prepare for array that may be generated
-	C4ValueArray *pArray; int32_t iSize;
-	// Check shape lists?
-	if (UseShapes())
+	ProfileScope Profile("FindObjects");
+	// Same search done before?
+	std::string Key;
+	uint32_t iGeneration = ::Objects.SearchCache.GetGeneration();
+	bool fCacheable = GetCacheKey(OP_FindMany, Key);
+	if (fCacheable)
+		if (const C4FindObjectCache::Result *pResult = ::Objects.SearchCache.Get(Key))
+		{
+			if (Profile) { ++Profile->CacheHits; Profile->Found += pResult->Count; }
+			C4ValueArray *pArray = new C4ValueArray(pResult->Count);
+			for (int32_t i = 0; i < pResult->Count; ++i)
+				(*pArray)[i] = C4VObj(pResult->Objects[i]);
+			return pArray;
+		}
+	// Search objects of the area or of an object list
+	C4ValueArray *pArray;
+	C4LSectors::Buffer Candidates(::Objects.Sectors);
+	if (GetCandidates(Candidates.Objects, false))
 	{
-		// Get area
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		C4ObjectList *pLst = Area.FirstObjectShapes(&pSct);
-		// Check if a single-sector check is enough
-		if (!Area.Next(pSct))
-			return FindMany(pSct->ObjectShapes);
-		// Set up array
-		pArray = new C4ValueArray(32); iSize = 0;
-		// Create marker, search all areas
-		uint32_t iMarker = ::Objects.GetNextMarker();
-		for (; pLst; pLst=Area.NextObjectShapes(pLst, &pSct))
-			for (C4Object *obj : *pLst)
-				if (obj->Status)
-					if (obj->Marker != iMarker)
-					{
-						obj->Marker = iMarker;
-						if (Check(obj))
-						{
-							// Grow the array, if neccessary
-							if (iSize >= pArray->GetSize())
-								pArray->SetSize(iSize * 2);
-							// Add object
-							(*pArray)[iSize++] = C4VObj(obj);
-						}
-					}
+		if (Profile) Profile->Candidates += Candidates.Objects.size();
+		pArray = FindManyIn(Candidates.Objects);
 	}
 	else
 	{
-		// Set up array
-		pArray = new C4ValueArray(32); iSize = 0;
-		// Search
-		C4LArea Area(&::Objects.Sectors, *pBounds); C4LSector *pSct;
-		for (C4ObjectList *pLst=Area.FirstObjects(&pSct); pLst; pLst=Area.NextObjects(pLst, &pSct))
-			for (C4Object *obj : *pLst)
-				if (obj->Status)
-					if (Check(obj))
-					{
-						// Grow the array, if neccessary
-						if (iSize >= pArray->GetSize())
-							pArray->SetSize(iSize * 2);
-						// Add object
-						(*pArray)[iSize++] = C4VObj(obj);
-					}
+		if (Profile) Profile->Candidates += Objs.ObjectCount();
+		pArray = FindManyIn(Objs);
+	}
+	if (Profile) Profile->Found += pArray->GetSize();
+	if (fCacheable)
+	{
+		C4FindObjectCache::Result &Result = ::Objects.SearchCache.Put(Key, iGeneration);
+		Result.Count = pArray->GetSize();
+		for (int32_t i = 0; i < Result.Count; ++i)
+			Result.Objects.push_back(pArray->GetItem(i).getObj());
 	}
-	// Shrink array
-	pArray->SetSize(iSize);
-	// Recheck object status (may shrink array again)
-	CheckObjectStatus(pArray);
-	// Apply sorting
-	if (pSort) pSort->SortObjects(pArray);
 	return pArray;
 }
 
@@ -515,6 +662,12 @@ bool C4FindObjectNot::Check(C4Object *pObj)
 	return !pCond->Check(pObj);
 }
 
+bool C4FindObjectNot::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Not);
+	return pCond->AppendKey(Key);
+}
+
 // *** C4FindObjectAnd
 
 C4FindObjectAnd::C4FindObjectAnd(int32_t inCnt, C4FindObject **ppConds, bool fFreeArray)
@@ -552,6 +705,19 @@ C4FindObjectAnd::C4FindObjectAnd(int32_t inCnt, C4FindObject **ppConds, bool fFr
 			// the objects will be filtered out later
 		}
 	}
+	// Check cheap conditions that reject many objects first, and script functions last
+	if (iCnt > 1)
+	{
+		std::vector<std::pair<int32_t, C4FindObject *>> Ranked;
+		for (i = 0; i < iCnt; i++)
+		{
+			int32_t iReject = std::max<int32_t>(100 - Clamp<int32_t>(ppConds[i]->GetPassRate(), 0, 99), 1);
+			Ranked.emplace_back(ppConds[i]->GetCost() * 100 / iReject, ppConds[i]);
+		}
+		std::stable_sort(Ranked.begin(), Ranked.end(), [](const std::pair<int32_t, C4FindObject *> &a, const std::pair<int32_t, C4FindObject *> &b) { return a.first < b.first; });
+		for (i = 0; i < iCnt; i++)
+			ppConds[i] = Ranked[i].second;
+	}
 }
 
 C4FindObjectAnd::~C4FindObjectAnd()
@@ -578,6 +744,48 @@ bool C4FindObjectAnd::IsImpossible()
 	return false;
 }
 
+int32_t C4FindObjectAnd::GetCost()
+{
+	int32_t iCost = 0;
+	for (int32_t i = 0; i < iCnt; i++)
+		iCost += ppConds[i]->GetCost();
+	return iCost;
+}
+
+int32_t C4FindObjectAnd::GetPassRate()
+{
+	int32_t iPassRate = 100;
+	for (int32_t i = 0; i < iCnt; i++)
+		iPassRate = iPassRate * ppConds[i]->GetPassRate() / 100;
+	return iPassRate;
+}
+
+C4PropList *C4FindObjectAnd::GetPinnedPrototype()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (C4PropList *pPrototype = ppConds[i]->GetPinnedPrototype())
+			return pPrototype;
+	return nullptr;
+}
+
+int32_t C4FindObjectAnd::GetPinnedCategory()
+{
+	for (int32_t i = 0; i < iCnt; i++)
+		if (int32_t iCategory = ppConds[i]->GetPinnedCategory())
+			return iCategory;
+	return 0;
+}
+
+bool C4FindObjectAnd::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_And);
+	AppendKeyValue(Key, iCnt);
+	for (int32_t i = 0; i < iCnt; i++)
+		if (!ppConds[i]->AppendKey(Key))
+			return false;
+	return true;
+}
+
 // *** C4FindObjectOr
 
 C4FindObjectOr::C4FindObjectOr(int32_t inCnt, C4FindObject **ppConds)
@@ -638,6 +846,55 @@ bool C4FindObjectOr::IsEnsured()
 	return false;
 }
 
+int32_t C4FindObjectOr::GetCost()
+{
+	int32_t iCost = 0;
+	for (int32_t i = 0; i < iCnt; i++)
+		iCost += ppConds[i]->GetCost();
+	return iCost;
+}
+
+int32_t C4FindObjectOr::GetPassRate()
+{
+	int32_t iPassRate = 0;
+	for (int32_t i = 0; i < iCnt; i++)
+		iPassRate += ppConds[i]->GetPassRate();
+	return std::min<int32_t>(iPassRate, 100);
+}
+
+C4PropList *C4FindObjectOr::GetPinnedPrototype()
+{
+	// All alternatives must pin the same prototype
+	C4PropList *pPrototype = iCnt ? ppConds[0]->GetPinnedPrototype() : nullptr;
+	for (int32_t i = 1; i < iCnt && pPrototype; i++)
+		if (ppConds[i]->GetPinnedPrototype() != pPrototype)
+			return nullptr;
+	return pPrototype;
+}
+
+int32_t C4FindObjectOr::GetPinnedCategory()
+{
+	// Objects have one of the categories of the alternatives
+	int32_t iCategory = 0;
+	for (int32_t i = 0; i < iCnt; i++)
+	{
+		int32_t iChildCategory = ppConds[i]->GetPinnedCategory();
+		if (!iChildCategory) return 0;
+		iCategory |= iChildCategory;
+	}
+	return iCategory;
+}
+
+bool C4FindObjectOr::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Or);
+	AppendKeyValue(Key, iCnt);
+	for (int32_t i = 0; i < iCnt; i++)
+		if (!ppConds[i]->AppendKey(Key))
+			return false;
+	return true;
+}
+
 // *** C4FindObject* (primitive conditions)
 
 bool C4FindObjectExclude::Check(C4Object *pObj)
@@ -645,6 +902,13 @@ bool C4FindObjectExclude::Check(C4Object *pObj)
 	return pObj != pExclude;
 }
 
+bool C4FindObjectExclude::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Exclude);
+	AppendKeyValue(Key, pExclude);
+	return true;
+}
+
 bool C4FindObjectDef::Check(C4Object *pObj)
 {
 	return pObj->GetPrototype() == def;
@@ -655,6 +919,20 @@ bool C4FindObjectDef::IsImpossible()
 	return !def || !def->GetDef() || !def->GetDef()->Count;
 }
 
+int32_t C4FindObjectDef::GetPassRate()
+{
+	const C4LSectors &Sectors = ::Objects.Sectors;
+	const C4SpatialGrid<C4Object>::Cell *pObjs = Sectors.GetPrototypeObjects(def);
+	return pObjs ? int32_t(pObjs->size() * 100 / std::max<size_t>(Sectors.GetObjectCount(), 1)) : 0;
+}
+
+bool C4FindObjectDef::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_ID);
+	AppendKeyValue(Key, def);
+	return true;
+}
+
 bool C4FindObjectInRect::Check(C4Object *pObj)
 {
 	return rect.Contains(pObj->GetX(), pObj->GetY());
@@ -665,11 +943,25 @@ bool C4FindObjectInRect::IsImpossible()
 	return !rect.Wdt || !rect.Hgt;
 }
 
+bool C4FindObjectInRect::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_InRect);
+	AppendKeyValue(Key, rect);
+	return true;
+}
+
 bool C4FindObjectAtPoint::Check(C4Object *pObj)
 {
 	return pObj->Shape.Contains(bounds.x - pObj->GetX(), bounds.y - pObj->GetY());
 }
 
+bool C4FindObjectAtPoint::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_AtPoint);
+	AppendKeyValue(Key, bounds);
+	return true;
+}
+
 bool C4FindObjectAtRect::Check(C4Object *pObj)
 {
 	C4Rect rcShapeBounds = pObj->Shape;
@@ -677,16 +969,38 @@ bool C4FindObjectAtRect::Check(C4Object *pObj)
 	return !!rcShapeBounds.Overlap(bounds);
 }
 
+bool C4FindObjectAtRect::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_AtRect);
+	AppendKeyValue(Key, bounds);
+	return true;
+}
+
 bool C4FindObjectOnLine::Check(C4Object *pObj)
 {
 	return pObj->Shape.IntersectsLine(x - pObj->GetX(), y - pObj->GetY(), x2 - pObj->GetX(), y2 - pObj->GetY());
 }
 
+bool C4FindObjectOnLine::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_OnLine);
+	AppendKeyValue(Key, x); AppendKeyValue(Key, y);
+	AppendKeyValue(Key, x2); AppendKeyValue(Key, y2);
+	return true;
+}
+
 bool C4FindObjectDistance::Check(C4Object *pObj)
 {
 	return (pObj->GetX() - x) * (pObj->GetX() - x) + (pObj->GetY() - y) * (pObj->GetY() - y) <= r2;
 }
 
+bool C4FindObjectDistance::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Distance);
+	AppendKeyValue(Key, x); AppendKeyValue(Key, y); AppendKeyValue(Key, r2);
+	return true;
+}
+
 bool C4FindObjectCone::Check(C4Object *pObj)
 {
 	bool in_circle = (pObj->GetX() - x) * (pObj->GetX() - x) + (pObj->GetY() - y) * (pObj->GetY() - y) <= r2;
@@ -697,6 +1011,14 @@ bool C4FindObjectCone::Check(C4Object *pObj)
 	return in_circle && in_cone;
 }
 
+bool C4FindObjectCone::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Cone);
+	AppendKeyValue(Key, x); AppendKeyValue(Key, y); AppendKeyValue(Key, r2);
+	AppendKeyValue(Key, cone_angle); AppendKeyValue(Key, cone_width); AppendKeyValue(Key, prec_angle);
+	return true;
+}
+
 bool C4FindObjectOCF::Check(C4Object *pObj)
 {
 	return !! (pObj->OCF & ocf);
@@ -717,6 +1039,13 @@ bool C4FindObjectCategory::IsEnsured()
 	return !iCategory;
 }
 
+bool C4FindObjectCategory::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Category);
+	AppendKeyValue(Key, iCategory);
+	return true;
+}
+
 bool C4FindObjectAction::Check(C4Object *pObj)
 {
 	assert(pObj);
@@ -756,11 +1085,24 @@ bool C4FindObjectContainer::Check(C4Object *pObj)
 	return pObj->Contained == pContainer;
 }
 
+bool C4FindObjectContainer::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Container);
+	AppendKeyValue(Key, pContainer);
+	return true;
+}
+
 bool C4FindObjectAnyContainer::Check(C4Object *pObj)
 {
 	return !! pObj->Contained;
 }
 
+bool C4FindObjectAnyContainer::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_AnyContainer);
+	return true;
+}
+
 bool C4FindObjectOwner::Check(C4Object *pObj)
 {
 	return pObj->Owner == iOwner;
@@ -815,6 +1157,13 @@ bool C4FindObjectLayer::IsImpossible()
 	return false;
 }
 
+bool C4FindObjectLayer::AppendKey(std::string &Key)
+{
+	AppendKeyValue(Key, C4FO_Layer);
+	AppendKeyValue(Key, pLayer);
+	return true;
+}
+
 // *** C4FindObjectInArray
 
 bool C4FindObjectInArray::Check(C4Object *pObj)
@@ -833,6 +1182,12 @@ bool C4FindObjectInArray::IsImpossible()
 	return !pArray || !pArray->GetSize();
 }
 
+int32_t C4FindObjectInArray::GetCost()
+{
+	// linear look-up
+	return C4FOC_Field * (1 + (pArray ? pArray->GetSize() : 0) / 4);
+}
+
 // *** C4FindObjectProperty
 
 bool C4FindObjectProperty::Check(C4Object *pObj)
@@ -1005,6 +1360,12 @@ int32_t C4SortObjectReverse::CompareCache(int32_t iObj1, int32_t iObj2, C4Object
 	return pSort->CompareCache(iObj2, iObj1, pObj2, pObj1);
 }
 
+bool C4SortObjectReverse::AppendKey(std::string &Key)
+{
+	C4FindObject::AppendKeyValue(Key, C4SO_Reverse);
+	return pSort->AppendKey(Key);
+}
+
 C4SortObjectMultiple::~C4SortObjectMultiple()
 {
 	for (int32_t i=0; i<iCnt; ++i) delete ppSorts[i];
@@ -1042,12 +1403,30 @@ int32_t C4SortObjectMultiple::CompareCache(int32_t iObj1, int32_t iObj2, C4Objec
 	return 0;
 }
 
+bool C4SortObjectMultiple::AppendKey(std::string &Key)
+{
+	C4FindObject::AppendKeyValue(Key, C4SO_Multiple);
+	C4FindObject::AppendKeyValue(Key, iCnt);
+	for (int32_t i=0; i<iCnt; ++i)
+		if (!ppSorts[i]->AppendKey(Key))
+			return false;
+	return true;
+}
+
 int32_t C4SortObjectDistance::CompareGetValue(C4Object *pFor)
 {
 	int32_t dx=pFor->GetX()-iX, dy=pFor->GetY()-iY;
 	return dx*dx+dy*dy;
 }
 
+bool C4SortObjectDistance::AppendKey(std::string &Key)
+{
+	C4FindObject::AppendKeyValue(Key, C4SO_Distance);
+	C4FindObject::AppendKeyValue(Key, iX);
+	C4FindObject::AppendKeyValue(Key, iY);
+	return true;
+}
+
 int32_t C4SortObjectRandom::CompareGetValue(C4Object *pFor)
 {
 	return Random(1 << 16);
@@ -1081,3 +1460,61 @@ int32_t C4SortObjectFunc::CompareGetValue(C4Object *pObj)
 	if (!Name) return false;
 	return pObj->Call(Name, &Pars).getInt();
 }
+
+// *** C4FindObjectCache
+
+const C4FindObjectCache::Result *C4FindObjectCache::Get(const std::string &Key) const
+{
+	auto iResult = Results.find(Key);
+	if (iResult == Results.end() || iResult->second.Generation != Generation) return nullptr;
+	return &iResult->second;
+}
+
+C4FindObjectCache::Result &C4FindObjectCache::Put(const std::string &Key, uint32_t iGeneration)
+{
+	// Don't let the cache grow without bounds when scripts do lots of different searches
+	if (Results.size() >= MaxResults) Results.clear();
+	Result &NewResult = Results[Key];
+	NewResult.Generation = iGeneration;
+	NewResult.Count = 0;
+	NewResult.Objects.clear();
+	return NewResult;
+}
+
+// *** C4FindObjectProfiler
+
+std::map<std::pair<const C4AulScriptFunc *, const char *>, C4FindObjectProfiler::Entry> C4FindObjectProfiler::Entries;
+
+void C4FindObjectProfiler::Reset()
+{
+	// Entries stay, because searches running while the profiler is restarted may still refer to them
+	for (auto &Entry : Entries) Entry.second = C4FindObjectProfiler::Entry();
+}
+
+C4FindObjectProfiler::Entry &C4FindObjectProfiler::GetEntry(const char *szOperation)
+{
+	C4AulScriptContext *pCtx = AulExec.GetContext(AulExec.GetContextDepth() - 1);
+	return Entries[std::make_pair(pCtx ? pCtx->Func : nullptr, szOperation)];
+}
+
+void C4FindObjectProfiler::Show()
+{
+	// sort by time
+	std::vector<std::pair<std::pair<const C4AulScriptFunc *, const char *>, Entry>> Sorted;
+	for (const auto &Entry : Entries)
+		if (Entry.second.Calls)
+			Sorted.push_back(Entry);
+	if (Sorted.empty()) return;
+	std::sort(Sorted.begin(), Sorted.end(), [](const decltype(Sorted)::value_type &a, const decltype(Sorted)::value_type &b) { return a.second.Time > b.second.Time; });
+	// display them
+	Log("Search statistics:");
+	Log("==============================");
+	for (const auto &Entry : Sorted)
+	{
+		const C4FindObjectProfiler::Entry &e = Entry.second;
+		LogF("%05ums\t%u calls, %u cached, %lu checked, %lu found\t%s in %s", static_cast<unsigned int>(e.Time / 1000),
+			e.Calls, e.CacheHits, static_cast<unsigned long>(e.Candidates), static_cast<unsigned long>(e.Found),
+			Entry.first.second, Entry.first.first ? Entry.first.first->GetFullName().getData() : "engine");
+	}
+	Log("==============================");
+}
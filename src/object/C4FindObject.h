@@ -19,6 +19,10 @@
 #include "lib/C4Rect.h"
 #include "script/C4Value.h"
 
+#include <map>
+#include <string>
+#include <unordered_map>
+
 // Condition map
 enum C4FindObjectCondID
 {
@@ -65,6 +69,17 @@ enum C4SortObjectCondID
 	C4SO_Last         = 50  // no sort condition larger than this
 };
 
+// Relative cost of C4FindObject::Check() calls, used to order conditions
+enum C4FindObjectCost
+{
+	C4FOC_Field    = 1,   // compare an object field
+	C4FOC_Position = 2,   // compare the object position
+	C4FOC_Shape    = 4,   // intersect the object shape
+	C4FOC_Action   = 8,   // look up the action
+	C4FOC_Property = 16,  // look up a property
+	C4FOC_Script   = 256, // call a script function
+};
+
 // Base class
 class C4FindObject
 {
@@ -96,9 +111,30 @@ protected:
 	virtual bool UseShapes() { return false; }
 	virtual bool IsImpossible() { return false; }
 	virtual bool IsEnsured() { return false; }
+	// Query planning
+	virtual int32_t GetCost() { return C4FOC_Field; } // cost of one Check() call
+	virtual int32_t GetPassRate() { return 50; } // estimated percentage of objects passing Check()
+	virtual C4PropList *GetPinnedPrototype() { return nullptr; } // prototype all matching objects have
+	virtual int32_t GetPinnedCategory() { return 0; } // category bits of which all matching objects have one
+	// Result caching: Append a description of the condition to the key, or return false if
+	// the result depends on anything but object position, shape, prototype, category, container and layer
+	virtual bool AppendKey(std::string &Key) { return false; }
+
+public:
+	template<class T> static void AppendKeyValue(std::string &Key, const T &Value)
+	{ Key.append(reinterpret_cast<const char *>(&Value), sizeof(Value)); }
 
 private:
+	enum Operation { OP_Count, OP_Find, OP_FindMany };
 	void CheckObjectStatus(C4ValueArray *pArray);
+	bool GetCacheKey(Operation op, std::string &Key);
+	bool GetCandidates(std::vector<C4Object *> &Objs, bool fDuplicates); // objects to check; false to check all objects
+	void GetAreaObjects(const C4Rect &Bounds, std::vector<C4Object *> &Objs, bool fDuplicates); // candidates from the sectors
+	bool CanFindNearest(int32_t &iX, int32_t &iY); // whether FindNearest can replace searching and sorting all candidates
+	void FindNearest(int32_t iX, int32_t iY, size_t iMax, std::vector<C4Object *> &Objs, uint64_t &iChecked); // up to iMax matches nearest to x/y
+	template<class List> int32_t CountIn(const List &Objs);
+	template<class List> C4Object *FindIn(const List &Objs);
+	template<class List> C4ValueArray *FindManyIn(const List &Objs);
 };
 
 // Combinators
@@ -114,6 +150,9 @@ protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override { return pCond->IsEnsured(); }
 	bool IsEnsured() override { return pCond->IsImpossible(); }
+	int32_t GetCost() override { return pCond->GetCost(); }
+	int32_t GetPassRate() override { return 100 - pCond->GetPassRate(); }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectAnd : public C4FindObject
@@ -131,6 +170,11 @@ protected:
 	bool UseShapes() override { return fUseShapes; }
 	bool IsEnsured() override { return !iCnt; }
 	bool IsImpossible() override;
+	int32_t GetCost() override;
+	int32_t GetPassRate() override;
+	C4PropList *GetPinnedPrototype() override;
+	int32_t GetPinnedCategory() override;
+	bool AppendKey(std::string &Key) override;
 	void ForgetConditions() { ppConds=nullptr; iCnt=0; }
 };
 
@@ -158,6 +202,11 @@ protected:
 	bool UseShapes() override { return fUseShapes; }
 	bool IsEnsured() override;
 	bool IsImpossible() override { return !iCnt; }
+	int32_t GetCost() override;
+	int32_t GetPassRate() override;
+	C4PropList *GetPinnedPrototype() override;
+	int32_t GetPinnedCategory() override;
+	bool AppendKey(std::string &Key) override;
 };
 
 // Primitive conditions
@@ -170,6 +219,8 @@ private:
 	C4Object *pExclude;
 protected:
 	bool Check(C4Object *pObj) override;
+	int32_t GetPassRate() override { return 99; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectDef : public C4FindObject
@@ -182,6 +233,9 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetPassRate() override;
+	C4PropList *GetPinnedPrototype() override { return def; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectInRect : public C4FindObject
@@ -195,6 +249,8 @@ protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return &rect; }
 	bool IsImpossible() override;
+	int32_t GetCost() override { return C4FOC_Position; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectAtPoint : public C4FindObject
@@ -208,6 +264,8 @@ protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
+	int32_t GetCost() override { return C4FOC_Shape; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectAtRect : public C4FindObject
@@ -221,6 +279,8 @@ protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
+	int32_t GetCost() override { return C4FOC_Shape; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectOnLine : public C4FindObject
@@ -235,6 +295,8 @@ protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return &bounds; }
 	bool UseShapes() override { return true; }
+	int32_t GetCost() override { return 2 * C4FOC_Shape; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectDistance : public C4FindObject
@@ -248,6 +310,8 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return &bounds; }
+	int32_t GetCost() override { return C4FOC_Position; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectCone : public C4FindObject
@@ -261,6 +325,8 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	C4Rect *GetBounds() override { return &bounds; }
+	int32_t GetCost() override { return 2 * C4FOC_Position; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectOCF : public C4FindObject
@@ -285,6 +351,9 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsEnsured() override;
+	int32_t GetPassRate() override { return 30; }
+	int32_t GetPinnedCategory() override { return iCategory; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectAction : public C4FindObject
@@ -296,6 +365,8 @@ private:
 	const char *szAction;
 protected:
 	bool Check(C4Object *pObj) override;
+	int32_t GetCost() override { return C4FOC_Action; }
+	int32_t GetPassRate() override { return 20; }
 };
 
 class C4FindObjectActionTarget : public C4FindObject
@@ -308,6 +379,8 @@ private:
 	int index;
 protected:
 	bool Check(C4Object *pObj) override;
+	int32_t GetCost() override { return C4FOC_Action; }
+	int32_t GetPassRate() override { return 10; }
 };
 
 class C4FindObjectProcedure : public C4FindObject
@@ -320,6 +393,8 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetCost() override { return C4FOC_Action + C4FOC_Property; }
+	int32_t GetPassRate() override { return 30; }
 };
 
 class C4FindObjectContainer : public C4FindObject
@@ -331,6 +406,8 @@ private:
 	C4Object *pContainer;
 protected:
 	bool Check(C4Object *pObj) override;
+	int32_t GetPassRate() override { return pContainer ? 5 : 80; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectAnyContainer : public C4FindObject
@@ -339,6 +416,8 @@ public:
 	C4FindObjectAnyContainer() = default;
 protected:
 	bool Check(C4Object *pObj) override;
+	int32_t GetPassRate() override { return 20; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectOwner : public C4FindObject
@@ -351,6 +430,7 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetPassRate() override { return 30; }
 };
 
 class C4FindObjectController : public C4FindObject
@@ -363,6 +443,7 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetPassRate() override { return 30; }
 };
 
 class C4FindObjectFunc : public C4FindObject
@@ -376,6 +457,7 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetCost() override { return C4FOC_Script; }
 };
 
 class C4FindObjectProperty : public C4FindObject
@@ -391,6 +473,7 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetCost() override { return C4FOC_Property; }
 };
 
 class C4FindObjectLayer : public C4FindObject
@@ -402,6 +485,8 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetPassRate() override { return 90; }
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4FindObjectInArray : public C4FindObject
@@ -413,6 +498,8 @@ private:
 protected:
 	bool Check(C4Object *pObj) override;
 	bool IsImpossible() override;
+	int32_t GetCost() override;
+	int32_t GetPassRate() override { return 5; }
 };
 
 // result sorting
@@ -429,6 +516,11 @@ public:
 	virtual bool PrepareCache(const C4ValueArray *pObjs) { return false; }
 	virtual int32_t CompareCache(int32_t iObj1, int32_t iObj2, C4Object *pObj1, C4Object *pObj2) { return Compare(pObj1, pObj2); }
 
+	// Append a description for the result cache, or return false if the order depends on more than object positions
+	virtual bool AppendKey(std::string &Key) { return false; }
+	// Point to sort by ascending distance from, if that is all this sort does
+	virtual bool GetDistanceOrigin(int32_t &x, int32_t &y) { return false; }
+
 public:
 	static C4SortObject *CreateByValue(const C4Value &Data, const C4Object *context=nullptr);
 	static C4SortObject *CreateByValue(int32_t iType, const C4ValueArray &Data, const C4Object *context=nullptr);
@@ -470,6 +562,7 @@ protected:
 
 	bool PrepareCache(const C4ValueArray *pObjs) override;
 	int32_t CompareCache(int32_t iObj1, int32_t iObj2, C4Object *pObj1, C4Object *pObj2) override;
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4SortObjectMultiple : public C4SortObject // apply next sort if previous compares to equality
@@ -488,6 +581,7 @@ protected:
 
 	bool PrepareCache(const C4ValueArray *pObjs) override;
 	int32_t CompareCache(int32_t iObj1, int32_t iObj2, C4Object *pObj1, C4Object *pObj2) override;
+	bool AppendKey(std::string &Key) override;
 };
 
 class C4SortObjectDistance : public C4SortObjectByValue // sort by distance from point x/y
@@ -500,6 +594,8 @@ private:
 
 protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
+	bool AppendKey(std::string &Key) override;
+	bool GetDistanceOrigin(int32_t &x, int32_t &y) override { x = iX; y = iY; return true; }
 };
 
 class C4SortObjectRandom : public C4SortObjectByValue // randomize order
@@ -550,4 +646,49 @@ protected:
 	int32_t CompareGetValue(C4Object *pFor) override;
 };
 
+// Results of cacheable searches. Scripts often repeat the same search many times per frame.
+// Results become invalid when objects are created, removed, moved or otherwise changed in a
+// way that cacheable conditions can see; the cache is emptied every frame.
+class C4FindObjectCache
+{
+public:
+	struct Result
+	{
+		uint32_t Generation;
+		int32_t Count;
+		std::vector<C4Object *> Objects;
+	};
+
+	void Clear() { Results.clear(); ++Generation; }
+	void Invalidate() { ++Generation; }
+	uint32_t GetGeneration() const { return Generation; }
+
+	const Result *Get(const std::string &Key) const;
+	Result &Put(const std::string &Key, uint32_t iGeneration);
+
+private:
+	static const size_t MaxResults = 4096;
+	uint32_t Generation = 0;
+	std::unordered_map<std::string, Result> Results;
+};
+
+// Search counters per calling script function, collected while the script profiler runs
+class C4FindObjectProfiler
+{
+public:
+	struct Entry
+	{
+		uint32_t Calls = 0, CacheHits = 0;
+		uint64_t Candidates = 0, Found = 0;
+		uint64_t Time = 0; // in microseconds
+	};
+
+	static void Reset();
+	static void Show();
+	static Entry &GetEntry(const char *szOperation); // for the currently running script function
+
+private:
+	static std::map<std::pair<const class C4AulScriptFunc *, const char *>, Entry> Entries;
+};
+
 #endif
@@ -42,6 +42,7 @@ C4GameObjects::~C4GameObjects()
 void C4GameObjects::Default()
 {
 	Sectors.Clear();
+	SearchCache.Clear();
 	LastUsedMarker = 0;
 	ForeObjects.Default();
 }
@@ -68,7 +69,8 @@ bool C4GameObjects::Add(C4Object *object)
 	if (!C4ObjectList::Add(object, C4ObjectList::stMain))
 		return false;
 	// Add to sectors
-	Sectors.Add(object, this);
+	Sectors.Add(object);
+	SearchCache.Invalidate();
 	return true;
 }
 
@@ -82,6 +84,7 @@ bool C4GameObjects::Remove(C4Object *object)
 	}
 	// Remove from sectors
 	Sectors.Remove(object);
+	SearchCache.Invalidate();
 	// Remove from forelist
 	ForeObjects.Remove(object);
 	// Manipulate main list
@@ -110,95 +113,94 @@ void C4GameObjects::CrossCheck() // Every Tick1 by ExecObjects
 		if (goal->Status && !goal->Contained && (goal->OCF & goal_required_ocf))
 		{
 			uint32_t Marker = GetNextMarker();
-			C4LSector *sector;
-			for (C4ObjectList *in_goal_area = goal->Area.FirstObjects(&sector); in_goal_area; in_goal_area = goal->Area.NextObjects(in_goal_area, &sector))
+			// The goal might move objects around in callbacks, so search a snapshot of its area
+			C4LSectors::Buffer in_goal_area(Sectors);
+			goal->Area.GetObjects(in_goal_area.Objects);
+			for (C4Object* ball : in_goal_area.Objects)
 			{
-				for (C4Object* ball : *in_goal_area)
+				if ((ball != goal)                 // Ball should not hit itself,
+				&&  ball->Status                   // it cannot hit if it was deleted,
+				&& !ball->Contained                // it cannot hit if it is contained,
+				&& (ball->OCF & ball_required_ocf) // it must have either of the required OFCs,
+				&& (goal->Layer == ball->Layer)    // and must be in the correct layer
+				// TODO: Instead of a custom check, use C4Rect::Contains with the correct coordinates
+				&&  Inside<int32_t>(ball->GetX() - (goal->GetX() + goal->Shape.x), 0, goal->Shape.Wdt - 1)
+				&&  Inside<int32_t>(ball->GetY() - (goal->GetY() + goal->Shape.y), 0, goal->Shape.Hgt - 1))
 				{
-					if ((ball != goal)                 // Ball should not hit itself,
-					&&  ball->Status                   // it cannot hit if it was deleted,
-					&& !ball->Contained                // it cannot hit if it is contained,
-					&& (ball->OCF & ball_required_ocf) // it must have either of the required OFCs,
-					&& (goal->Layer == ball->Layer)    // and must be in the correct layer
-					// TODO: Instead of a custom check, use C4Rect::Contains with the correct coordinates
-					&&  Inside<int32_t>(ball->GetX() - (goal->GetX() + goal->Shape.x), 0, goal->Shape.Wdt - 1)
-					&&  Inside<int32_t>(ball->GetY() - (goal->GetY() + goal->Shape.y), 0, goal->Shape.Hgt - 1))
+					// Handle cross check only once
+					if (ball->Marker == Marker)
 					{
-						// Handle cross check only once
-						if (ball->Marker == Marker)
-						{
-							continue;
-						}
-						ball->Marker = Marker;
+						continue;
+					}
+					ball->Marker = Marker;
 
-						// Collision check
+					// Collision check
 
-						// Note: the layer check was already done further above.
+					// Note: the layer check was already done further above.
 
-						if ((goal->OCF & OCF_Alive)        // <goal> must be alive,
-						&&  (ball->OCF & OCF_HitSpeed2)    // <ball> is fast enough (otherwise a fast <goal> will collide when passing a non-moving ball)
-						&&  (ball->Category & C4D_Object)) // <ball> is an object
+					if ((goal->OCF & OCF_Alive)        // <goal> must be alive,
+					&&  (ball->OCF & OCF_HitSpeed2)    // <ball> is fast enough (otherwise a fast <goal> will collide when passing a non-moving ball)
+					&&  (ball->Category & C4D_Object)) // <ball> is an object
+					{
+						C4Real relative_xdir = ball->xdir - goal->xdir;
+						C4Real relative_ydir = ball->ydir - goal->ydir;
+						C4Real hit_speed = relative_xdir * relative_xdir + relative_ydir * relative_ydir;
+						// Only hit if the relative speed is larger than HitSpeed2, and the <goal> does not prevent getting hit
+						if ((hit_speed > HitSpeed2) &&  !goal->Call(PSF_QueryCatchBlow, &C4AulParSet(ball)))
 						{
-							C4Real relative_xdir = ball->xdir - goal->xdir;
-							C4Real relative_ydir = ball->ydir - goal->ydir;
-							C4Real hit_speed = relative_xdir * relative_xdir + relative_ydir * relative_ydir;
-							// Only hit if the relative speed is larger than HitSpeed2, and the <goal> does not prevent getting hit
-							if ((hit_speed > HitSpeed2) &&  !goal->Call(PSF_QueryCatchBlow, &C4AulParSet(ball)))
+							int32_t hit_energy = fixtoi(hit_speed * ball->Mass / 5);
+							// Hit energy reduced to 1/3rd, but do not drop to zero because of this division.
+							// However, if the hit energy is low because of either speed or <ball> mass, then
+							// having it stay 0 is OK.
+							if (hit_energy != 0)
 							{
-								int32_t hit_energy = fixtoi(hit_speed * ball->Mass / 5);
-								// Hit energy reduced to 1/3rd, but do not drop to zero because of this division.
-								// However, if the hit energy is low because of either speed or <ball> mass, then
-								// having it stay 0 is OK.
-								if (hit_energy != 0)
-								{
-									hit_energy = std::max(hit_energy / 3, 1);
-								}
-								// Apply damage to the goal - not sure why this is divided by 5 yet again,
-								// and this time we allow it being reduced to 0...
-								int32_t damage = -hit_energy / 5;
-								goal->DoEnergy(damage, false, C4FxCall_EngObjHit, ball->Controller);
-								// Fling it around:
-								// light objects will be flung with full speed,
-								// heavier objects will be affected less
-								int min_mass = 50;
-								int goal_mass = std::max<int32_t>(goal->Mass, min_mass);
-								C4PropList* pActionDef = goal->GetAction();
-								if (!::Game.iTick3 || (pActionDef && pActionDef->GetPropertyP(P_Procedure) != DFA_FLIGHT))
-								{
-									goal->Fling(ball->xdir * min_mass / goal_mass, -Abs(ball->ydir / 2) * min_mass / goal_mass, false);
-								}
-								// Callback with the damage value
-								goal->Call(PSF_CatchBlow, &C4AulParSet(damage, ball));
-								// <goal> might have been tampered with
-								if (!goal->Status || goal->Contained || !(goal->OCF & goal_required_ocf))
-								{
-									goto check_next_goal;
-								}
-								// Skip collection check
-								continue;
+								hit_energy = std::max(hit_energy / 3, 1);
 							}
-						}
-
-						// Collection check
-
-						// Note: the layer check was already done further above.
-						// This is confusing, because this requires
-						// the ball to be both inside the goal shape AND the goal collection area, so
-						// collection areas that go further than the goal shape are useless, as well
-						// as collection areas that are entirely outside of the goal shape.
-
-						if ((goal->OCF & OCF_Collection) // <goal> has a collection area?
-						&&  (ball->OCF & OCF_Carryable)  // <ball> can be collected?
-						// TODO: Instead of a custom check, use C4Rect::Contains with the correct coordinates
-						&&  Inside<int32_t>(ball->GetX() - (goal->GetX() + goal->Def->Collection.x), 0, goal->Def->Collection.Wdt - 1)
-						&&  Inside<int32_t>(ball->GetY() - (goal->GetY() + goal->Def->Collection.y), 0, goal->Def->Collection.Hgt - 1))
-						{
-							goal->Collect(ball);
+							// Apply damage to the goal - not sure why this is divided by 5 yet again,
+							// and this time we allow it being reduced to 0...
+							int32_t damage = -hit_energy / 5;
+							goal->DoEnergy(damage, false, C4FxCall_EngObjHit, ball->Controller);
+							// Fling it around:
+							// light objects will be flung with full speed,
+							// heavier objects will be affected less
+							int min_mass = 50;
+							int goal_mass = std::max<int32_t>(goal->Mass, min_mass);
+							C4PropList* pActionDef = goal->GetAction();
+							if (!::Game.iTick3 || (pActionDef && pActionDef->GetPropertyP(P_Procedure) != DFA_FLIGHT))
+							{
+								goal->Fling(ball->xdir * min_mass / goal_mass, -Abs(ball->ydir / 2) * min_mass / goal_mass, false);
+							}
+							// Callback with the damage value
+							goal->Call(PSF_CatchBlow, &C4AulParSet(damage, ball));
 							// <goal> might have been tampered with
 							if (!goal->Status || goal->Contained || !(goal->OCF & goal_required_ocf))
 							{
 								goto check_next_goal;
 							}
+							// Skip collection check
+							continue;
+						}
+					}
+
+					// Collection check
+
+					// Note: the layer check was already done further above.
+					// This is confusing, because this requires
+					// the ball to be both inside the goal shape AND the goal collection area, so
+					// collection areas that go further than the goal shape are useless, as well
+					// as collection areas that are entirely outside of the goal shape.
+
+					if ((goal->OCF & OCF_Collection) // <goal> has a collection area?
+					&&  (ball->OCF & OCF_Carryable)  // <ball> can be collected?
+					// TODO: Instead of a custom check, use C4Rect::Contains with the correct coordinates
+					&&  Inside<int32_t>(ball->GetX() - (goal->GetX() + goal->Def->Collection.x), 0, goal->Def->Collection.Wdt - 1)
+					&&  Inside<int32_t>(ball->GetY() - (goal->GetY() + goal->Def->Collection.y), 0, goal->Def->Collection.Hgt - 1))
+					{
+						goal->Collect(ball);
+						// <goal> might have been tampered with
+						if (!goal->Status || goal->Contained || !(goal->OCF & goal_required_ocf))
+						{
+							goto check_next_goal;
 						}
 					}
 				}
@@ -253,6 +255,7 @@ void C4GameObjects::DeleteObjects(bool delete_inactive_objects)
 {
 	C4ObjectList::DeleteObjects();
 	Sectors.ClearObjects();
+	SearchCache.Clear();
 	ForeObjects.Clear();
 	if (delete_inactive_objects)
 	{
@@ -430,14 +433,23 @@ C4Value C4GameObjects::GRBroadcast(const char *function_name, C4AulParSet *param
 void C4GameObjects::UpdatePos(C4Object *object)
 {
 	// Position might have changed. Update sector lists
-	Sectors.Update(object, this);
+	Sectors.Update(object);
+	SearchCache.Invalidate();
 }
 
 void C4GameObjects::UpdatePosResort(C4Object *object)
 {
 	// Object order for this object was changed. Readd object to sectors
 	Sectors.Remove(object);
-	Sectors.Add(object, this);
+	Sectors.Add(object);
+	SearchCache.Invalidate();
+}
+
+void C4GameObjects::UpdateSearch(C4Object *object)
+{
+	// Properties seen by FindObject have changed
+	Sectors.UpdateIndex(object);
+	SearchCache.Invalidate();
 }
 
 void C4GameObjects::FixObjectOrder()
@@ -526,9 +538,70 @@ void C4GameObjects::FixObjectOrder()
 		}
 		pLnk0 = pLnk1stUnsorted;
 	}
+	// Objects were swapped between links: Renumber and resort sector lists
+	RenumberSectorOrder();
 	// Objects fixed!
 }
 
+void C4GameObjects::InsertLinkBefore(C4ObjectLink *link, C4ObjectLink *before_link)
+{
+	C4NotifyingObjectList::InsertLinkBefore(link, before_link);
+	AssignSectorOrder(link);
+}
+
+void C4GameObjects::InsertLink(C4ObjectLink *link, C4ObjectLink *after_link)
+{
+	C4NotifyingObjectList::InsertLink(link, after_link);
+	AssignSectorOrder(link);
+}
+
+void C4GameObjects::AssignSectorOrder(C4ObjectLink *link)
+{
+	C4Object *object = link->Obj;
+	// Objects that are already in the sectors must be resorted there as well
+	bool in_sectors = !object->Area.IsNull();
+	if (in_sectors)
+	{
+		Sectors.Remove(object);
+	}
+	// Pick a value between the neighbours, or renumber everything if there is no room
+	const uint64_t prev = link->Prev ? link->Prev->Obj->SectorOrder : 0;
+	const uint64_t next = link->Next ? link->Next->Obj->SectorOrder : UINT64_MAX;
+	if (!link->Next && next - prev > SectorOrderSpacing)
+	{
+		object->SectorOrder = prev + SectorOrderSpacing;
+	}
+	else if (!link->Prev && link->Next && next > SectorOrderSpacing)
+	{
+		object->SectorOrder = next - SectorOrderSpacing;
+	}
+	else if (next - prev > 1)
+	{
+		object->SectorOrder = prev + (next - prev) / 2;
+	}
+	else
+	{
+		RenumberSectorOrder();
+	}
+	if (in_sectors)
+	{
+		Sectors.Add(object);
+	}
+	SearchCache.Invalidate();
+}
+
+void C4GameObjects::RenumberSectorOrder()
+{
+	// Start in the middle of the value range to leave room at both ends
+	uint64_t order = UINT64_MAX / 2;
+	for (C4ObjectLink *link = First; link; link = link->Next)
+	{
+		link->Obj->SectorOrder = (order += SectorOrderSpacing);
+	}
+	Sectors.UpdateOrder();
+	SearchCache.Invalidate();
+}
+
 void C4GameObjects::ResortUnsorted()
 {
 	for (C4Object *object : *this)
@@ -38,10 +38,20 @@ public:
 private:
 	uint32_t LastUsedMarker; // Last used value for C4Object::Marker
 
+	// Gap between C4Object::SectorOrder values of neighbouring objects after renumbering
+	static const uint64_t SectorOrderSpacing = uint64_t(1) << 24;
+	void AssignSectorOrder(C4ObjectLink *link); // give a newly linked object an order value between its neighbours
+	void RenumberSectorOrder();
+
+protected:
+	void InsertLinkBefore(C4ObjectLink *link, C4ObjectLink *before_link) override;
+	void InsertLink(C4ObjectLink *link, C4ObjectLink *after_link) override;
+
 public:
 	C4LSectors Sectors; // Section object lists
 	C4ObjectList InactiveObjects; // Inactive objects (Status=2)
 	C4ObjectList ForeObjects; // Objects in foreground (C4D_Foreground)
+	C4FindObjectCache SearchCache; // Results of recent FindObject calls
 
 	using C4ObjectList::Add;
 	bool Add(C4Object *game_object); // Add object
@@ -62,6 +72,7 @@ public:
 
 	void UpdatePos(C4Object *game_object);
 	void UpdatePosResort(C4Object *game_object);
+	void UpdateSearch(C4Object *game_object);
 
 	void FixObjectOrder(); // Called after loading: Resort any objects that are out of order
 	void ResortUnsorted(); // Resort any objects with unsorted-flag set into lists
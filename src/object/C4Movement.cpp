@@ -136,6 +136,8 @@ bool C4Object::Contact(int32_t iCNAT)
 {
 	if (GetPropertyInt(P_ContactCalls))
 	{
+		// Position changed, but sectors are only updated after the movement
+		UpdateSearch();
 		return !! Call(FormatString(PSF_Contact, CNATName(iCNAT)).getData());
 	}
 	return false;
@@ -543,10 +545,12 @@ void C4Object::DoMovement()
 		}
 		fix_r = target_r;
 	}
-	// Reput solid mask if moved by motion
+	// Reput solid mask if moved by motion. Sectors are only updated at the end, but the callbacks
+	// below must not see cached search results from before the movement.
 	if (has_moved || has_turned)
 	{
 		UpdateSolidMask(true);
+		UpdateSearch();
 	}
 	// Misc checks ===========================================================================================
 	// InLiquid check
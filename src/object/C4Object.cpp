@@ -94,6 +94,8 @@ void C4Object::Default()
 	Menu=nullptr;
 	MaterialContents=nullptr;
 	Marker=0;
+	SectorOrder=0;
+	IndexedPrototype=nullptr; IndexedCategory=0;
 	ColorMod=0xffffffff;
 	BlitMode=0;
 	CrewDisabled=false;
@@ -279,6 +281,8 @@ void C4Object::AssignRemoval(bool exit_contents)
 	}
 
 	Status = C4OS_DELETED;
+	// cached search results might contain the object
+	::Objects.SearchCache.Invalidate();
 	// count decrease
 	Def->Count--;
 
@@ -1320,6 +1324,10 @@ void C4Object::SetPropertyByS(C4String * k, const C4Value & to)
 				if (!to.getInt()) throw C4AulExecError("invalid Plane 0");
 				SetPlane(to.getInt());
 				return;
+			case P_Prototype:
+				C4PropListNumbered::SetPropertyByS(k, to);
+				UpdateSearch();
+				return;
 		}
 	}
 	C4PropListNumbered::SetPropertyByS(k, to);
@@ -1334,6 +1342,10 @@ void C4Object::ResetProperty(C4String * k)
 			case P_Plane:
 				SetPlane(GetPropertyInt(P_Plane));
 				return;
+			case P_Prototype:
+				C4PropListNumbered::ResetProperty(k);
+				UpdateSearch();
+				return;
 		}
 	}
 	return C4PropListNumbered::ResetProperty(k);
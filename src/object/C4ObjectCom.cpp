@@ -231,6 +231,7 @@ bool ObjectActionCornerScale(C4Object *cObj)
 		cObj->fix_x += itofix(iRangeX);
 	}
 	cObj->fix_y -= itofix(iRangeY);
+	cObj->UpdateSearch();
 	return true;
 }
 
@@ -45,6 +45,7 @@ bool C4Object::Exit(int32_t iX, int32_t iY, int32_t iR, C4Real iXDir, C4Real iYD
 	pContainer->SetOCF();
 	// No container
 	Contained=nullptr;
+	UpdateSearch();
 	// Position/motion
 	fix_x=itofix(iX); fix_y=itofix(iY);
 	fix_r=itofix(iR);
@@ -104,6 +105,7 @@ bool C4Object::Enter(C4Object *pTarget, bool fCalls, bool fCopyMotion, bool *pfR
 	SetOCF();
 	// Set container
 	Contained=pTarget;
+	UpdateSearch();
 	// Enter
 	if (!Contained->Contents.Add(this, C4ObjectList::stContents))
 	{
@@ -44,6 +44,15 @@ void C4Object::UpdatePos()
 	}
 }
 
+void C4Object::UpdateSearch()
+{
+	// Refresh the lists and cached results of FindObject
+	if (!Initializing && Status == C4OS_NORMAL)
+	{
+		::Objects.UpdateSearch(this);
+	}
+}
+
 void C4Object::UpdateMass()
 {
 	Mass = std::max<int32_t>((Def->Mass + OwnMass) * Con / FullCon, 1);
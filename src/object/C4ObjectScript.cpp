@@ -1958,12 +1958,14 @@ static void FnSetObjectLayer(C4Object *Obj, C4Object *pNewLayer)
 {
 	// set layer object
 	Obj->Layer = pNewLayer;
+	Obj->UpdateSearch();
 	// set for all contents as well
 	for (C4Object* contentObj : Obj->Contents)
 	{
 		if (contentObj && contentObj->Status)
 		{
 			contentObj->Layer = pNewLayer;
+			contentObj->UpdateSearch();
 		}
 	}
 }
@@ -22,109 +22,68 @@
 #include "object/C4GameObjects.h"
 #include "object/C4Object.h"
 
-/* sector */
-
-void C4LSector::Init(int ix, int iy)
-{
-	// clear any previous initialization
-	Clear();
-	// store class members
-	x=ix; y=iy;
-}
-
-void C4LSector::Clear()
-{
-	// clear objects
-	ClearObjects();
-}
-
-void C4LSector::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
-{
-	pComp->Value(mkNamingAdapt(mkIntAdapt(x), "x"));
-	pComp->Value(mkNamingAdapt(mkIntAdapt(y), "y"));
-	pComp->Value(mkNamingAdapt(mkParAdapt(Objects, numbers), "Objects"));
-	pComp->Value(mkNamingAdapt(mkParAdapt(ObjectShapes, numbers), "ObjectShapes"));
-}
-
-void C4LSector::ClearObjects()
-{
-	// clear objects
-	Objects.Clear();
-	ObjectShapes.Clear();
-}
-
 /* sector map */
 
-void C4LSectors::Init(int iWdt, int iHgt)
+void C4LSectors::Init(int iWdt, int iHgt, int32_t iSectorSize)
 {
 	// clear any previous initialization
 	Clear();
-	// store class members, calc size
-	Wdt = ((PxWdt=iWdt)-1)/C4LSectorWdt+1;
-	Hgt = ((PxHgt=iHgt)-1)/C4LSectorHgt+1;
 	// create sectors
-	Sectors = new C4LSector[Size=Wdt*Hgt];
-	// init sectors
-	C4LSector *sct=Sectors;
-	for (int cnt=0; cnt<Size; cnt++, sct++)
-		sct->Init(cnt%Wdt, cnt/Wdt);
-	SectorOut.Init(-1,-1); // outpos at -1,-1 - MUST NOT intersect with an inside sector!
+	Objects.Init(iWdt, iHgt, iSectorSize);
+	ObjectShapes.Init(iWdt, iHgt, iSectorSize);
 }
 
 void C4LSectors::Clear()
 {
-	// clear out-sector
-	SectorOut.Clear();
-	// free sectors
-	delete [] Sectors; Sectors=nullptr;
-}
-
-C4LSector *C4LSectors::SectorAt(int ix, int iy)
-{
-	// check bounds
-	if (ix<0 || iy<0 || ix>=PxWdt || iy>=PxHgt)
-		return &SectorOut;
-	// get sector
-	return Sectors+(iy/C4LSectorHgt)*Wdt+(ix/C4LSectorWdt);
+	Objects.Clear();
+	ObjectShapes.Clear();
+	PrototypeObjects.clear();
+	for (auto &Category : CategoryObjects) Category.clear();
+	ObjectCount = 0;
 }
 
-void C4LSectors::Add(C4Object *pObj, C4ObjectList *pMainList)
+void C4LSectors::Add(C4Object *pObj)
 {
-	assert(Sectors);
 	// Add to owning sector
-	C4LSector *pSct = SectorAt(pObj->GetX(), pObj->GetY());
-	pSct->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+	Objects.Add(Objects.IndexAt(pObj->GetX(), pObj->GetY()), pObj, pObj->SectorOrder);
 	// Save position
 	pObj->old_x = pObj->GetX(); pObj->old_y = pObj->GetY();
 	// Add to all sectors in shape area
 	pObj->Area.Set(this, pObj);
-	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-	{
-		pSct->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
-	}
+	ObjectShapes.AddToArea(pObj->Area.Cells, pObj, pObj->SectorOrder);
 	if (Config.General.DebugRec)
 		pObj->Area.DebugRec(pObj, 'A');
+	AddToIndex(pObj);
+}
+
+void C4LSectors::AddToIndex(C4Object *pObj)
+{
+	pObj->IndexedPrototype = pObj->GetPrototype();
+	pObj->IndexedCategory = pObj->Category;
+	++ObjectCount;
+	C4SpatialGrid<C4Object>::Insert(PrototypeObjects[pObj->IndexedPrototype], pObj, pObj->SectorOrder);
+	for (int32_t i = 0; i < C4LSectorCategoryBits; ++i)
+		if (pObj->IndexedCategory & (1 << i))
+			C4SpatialGrid<C4Object>::Insert(CategoryObjects[i], pObj, pObj->SectorOrder);
 }
 
-void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
+void C4LSectors::Update(C4Object *pObj)
 {
-	assert(Sectors);
 	// Not added yet?
 	if (pObj->Area.IsNull())
 	{
-		Add(pObj, pMainList);
+		Add(pObj);
 		return;
 	}
-	C4LSector *pOld, *pNew;
 	if (pObj->old_x != pObj->GetX() || pObj->old_y != pObj->GetY())
 	{
 		// Get involved sectors
-		pOld = SectorAt(pObj->old_x, pObj->old_y);
-		pNew = SectorAt(pObj->GetX(), pObj->GetY());
-		if (pOld != pNew)
+		int32_t iOld = Objects.IndexAt(pObj->old_x, pObj->old_y);
+		int32_t iNew = Objects.IndexAt(pObj->GetX(), pObj->GetY());
+		if (iOld != iNew)
 		{
-			pOld->Objects.Remove(pObj);
-			pNew->Objects.Add(pObj, C4ObjectList::stMain, pMainList);
+			Objects.Remove(iOld, pObj, pObj->SectorOrder);
+			Objects.Add(iNew, pObj, pObj->SectorOrder);
 		}
 		// Save position
 		pObj->old_x = pObj->GetX(); pObj->old_y = pObj->GetY();
@@ -132,16 +91,8 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 	// New area
 	C4LArea NewArea(this, pObj);
 	if (pObj->Area == NewArea) return;
-	// Remove from all old sectors in shape area
-	for (pOld = pObj->Area.First(); pOld; pOld = pObj->Area.Next(pOld))
-		if (!NewArea.Contains(pOld))
-			pOld->ObjectShapes.Remove(pObj);
-	// Add to all new sectors in shape area
-	for (pNew = NewArea.First(); pNew; pNew = NewArea.Next(pNew))
-		if (!pObj->Area.Contains(pNew))
-		{
-			pNew->ObjectShapes.Add(pObj, C4ObjectList::stMain, pMainList);
-		}
+	// Leave old sectors, enter new sectors
+	ObjectShapes.MoveArea(pObj->Area.Cells, NewArea.Cells, pObj, pObj->SectorOrder);
 	// Update area
 	pObj->Area = NewArea;
 	if (Config.General.DebugRec)
@@ -150,121 +101,194 @@ void C4LSectors::Update(C4Object *pObj, C4ObjectList *pMainList)
 
 void C4LSectors::Remove(C4Object *pObj)
 {
-	assert(Sectors); assert(pObj);
+	assert(pObj);
+	// Not added?
+	if (pObj->Area.IsNull()) return;
 	// Remove from owning sector
-	C4LSector *pSct = SectorAt(pObj->old_x, pObj->old_y);
-	if (!pSct->Objects.Remove(pObj))
+	if (!Objects.Remove(Objects.IndexAt(pObj->old_x, pObj->old_y), pObj, pObj->SectorOrder))
 	{
 #ifdef _DEBUG
 		LogF("WARNING: Object %d of type %s deleted but not found in pos sector list!", pObj->Number, pObj->id.ToString());
 #endif
 		// if it was not found in owning sector, it must be somewhere else. yeah...
 		bool fFound = false;
-		for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-			if (pSct->Objects.Remove(pObj)) { fFound=true; break; }
-		// yukh, somewhere else entirely...
-		if (!fFound)
-		{
-			fFound = !!SectorOut.Objects.Remove(pObj);
-			if (!fFound)
-			{
-				pSct = Sectors;
-				for (int cnt=0; cnt<Size; cnt++, pSct++)
-					if (pSct->Objects.Remove(pObj)) { fFound=true; break; }
-			}
-			assert(fFound);
-		}
+		for (int32_t i = 0; i <= Objects.GetOutIndex() && !fFound; ++i)
+			fFound = Objects.Remove(i, pObj, pObj->SectorOrder);
+		assert(fFound);
 	}
 	// Remove from all sectors in shape area
-	for (pSct = pObj->Area.First(); pSct; pSct = pObj->Area.Next(pSct))
-		pSct->ObjectShapes.Remove(pObj);
+	ObjectShapes.RemoveFromArea(pObj->Area.Cells, pObj, pObj->SectorOrder);
 	if (Config.General.DebugRec)
 		pObj->Area.DebugRec(pObj, 'R');
+	pObj->Area.Clear();
+	RemoveFromIndex(pObj);
+}
+
+void C4LSectors::RemoveFromIndex(C4Object *pObj)
+{
+	--ObjectCount;
+	auto iPrototype = PrototypeObjects.find(pObj->IndexedPrototype);
+	if (iPrototype != PrototypeObjects.end())
+	{
+		C4SpatialGrid<C4Object>::Erase(iPrototype->second, pObj, pObj->SectorOrder);
+		if (iPrototype->second.empty()) PrototypeObjects.erase(iPrototype);
+	}
+	for (int32_t i = 0; i < C4LSectorCategoryBits; ++i)
+		if (pObj->IndexedCategory & (1 << i))
+			C4SpatialGrid<C4Object>::Erase(CategoryObjects[i], pObj, pObj->SectorOrder);
+	pObj->IndexedPrototype = nullptr;
+	pObj->IndexedCategory = 0;
+}
+
+void C4LSectors::UpdateIndex(C4Object *pObj)
+{
+	// Not added or nothing changed?
+	if (pObj->Area.IsNull()) return;
+	if (pObj->IndexedPrototype == pObj->GetPrototype() && pObj->IndexedCategory == pObj->Category) return;
+	// Move to the lists of the new prototype and category
+	RemoveFromIndex(pObj);
+	AddToIndex(pObj);
+}
+
+void C4LSectors::UpdateOrder()
+{
+	auto order_of = [](const C4Object *pObj) { return pObj->SectorOrder; };
+	Objects.UpdateOrder(order_of);
+	ObjectShapes.UpdateOrder(order_of);
+	for (auto &Prototype : PrototypeObjects)
+		C4SpatialGrid<C4Object>::UpdateOrder(Prototype.second, order_of);
+	for (auto &Category : CategoryObjects)
+		C4SpatialGrid<C4Object>::UpdateOrder(Category, order_of);
 }
 
 void C4LSectors::AssertObjectNotInList(C4Object *pObj)
 {
 #ifndef NDEBUG
-	C4LSector *sct=Sectors;
-	for (int cnt=0; cnt<Size; cnt++, sct++)
+	for (int32_t i = 0; i <= Objects.GetOutIndex(); ++i)
 	{
-		assert(!sct->Objects.IsContained(pObj));
-		assert(!sct->ObjectShapes.IsContained(pObj));
+		assert(!Objects.IsContained(Objects.GetCell(i), pObj));
+		assert(!ObjectShapes.IsContained(ObjectShapes.GetCell(i), pObj));
 	}
-	assert(!SectorOut.Objects.IsContained(pObj));
-	assert(!SectorOut.ObjectShapes.IsContained(pObj));
+	for (const auto &Prototype : PrototypeObjects)
+		assert(!C4SpatialGrid<C4Object>::IsContained(Prototype.second, pObj));
+	for (const auto &Category : CategoryObjects)
+		assert(!C4SpatialGrid<C4Object>::IsContained(Category, pObj));
 #endif
 }
 
 int C4LSectors::getShapeSum() const
 {
-	int iSum = 0;
-	for (int cnt=0; cnt<Size; cnt++)
-		iSum += Sectors[cnt].ObjectShapes.ObjectCount();
-	return iSum;
+	return ObjectShapes.GetEntryCount();
+}
+
+const C4SpatialGrid<C4Object>::Cell *C4LSectors::GetPrototypeObjects(const C4PropList *pPrototype) const
+{
+	auto iPrototype = PrototypeObjects.find(pPrototype);
+	return iPrototype != PrototypeObjects.end() ? &iPrototype->second : nullptr;
+}
+
+size_t C4LSectors::GetCategoryObjectCount(int32_t iCategory) const
+{
+	size_t iCount = 0;
+	for (int32_t i = 0; i < C4LSectorCategoryBits; ++i)
+		if (iCategory & (1 << i))
+			iCount += CategoryObjects[i].size();
+	return iCount;
+}
+
+void C4LSectors::GetCategoryObjects(int32_t iCategory, std::vector<C4Object *> &objects) const
+{
+	assert(IsIndexedCategory(iCategory));
+	const C4SpatialGrid<C4Object>::Cell *pSingle = nullptr;
+	int32_t iLists = 0;
+	for (int32_t i = 0; i < C4LSectorCategoryBits; ++i)
+		if (iCategory & (1 << i))
+			{ pSingle = &CategoryObjects[i]; ++iLists; }
+	if (iLists == 1)
+	{
+		for (const auto &Entry : *pSingle) objects.push_back(Entry.Obj);
+		return;
+	}
+	// Merge the lists of several bits. Objects may be in more than one of them.
+	static std::vector<C4SpatialGrid<C4Object>::Entry> Merged;
+	Merged.clear();
+	for (int32_t i = 0; i < C4LSectorCategoryBits; ++i)
+		if (iCategory & (1 << i))
+			Merged.insert(Merged.end(), CategoryObjects[i].begin(), CategoryObjects[i].end());
+	std::sort(Merged.begin(), Merged.end());
+	for (size_t i = 0; i < Merged.size(); ++i)
+		if (!i || Merged[i].Obj != Merged[i-1].Obj)
+			objects.push_back(Merged[i].Obj);
 }
 
 void C4LSectors::Dump()
 {
-	C4ValueNumbers numbers;
-	LogSilent(DecompileToBuf<StdCompilerINIWrite>(
-	            mkNamingAdapt(
-	              mkArrayAdaptMap(Sectors, Size, mkParAdaptMaker(&numbers)),
-	              "Sector")).getData());
+	for (int32_t i = 0; i <= Objects.GetOutIndex(); ++i)
+	{
+		StdStrBuf Line;
+		for (const auto &Entry : Objects.GetCell(i))
+			Line.AppendFormat(" %d", (int) Entry.Obj->Number);
+		Line.Append(" /");
+		for (const auto &Entry : ObjectShapes.GetCell(i))
+			Line.AppendFormat(" %d", (int) Entry.Obj->Number);
+		if (i == Objects.GetOutIndex())
+			LogSilentF("[Sector] out:%s", Line.getData());
+		else
+			LogSilentF("[Sector] %d,%d:%s", i % Objects.GetWidth(), i / Objects.GetWidth(), Line.getData());
+	}
 }
 
 bool C4LSectors::CheckSort()
 {
-	for (int cnt=0; cnt<Size; cnt++)
-		if (!Sectors[cnt].Objects.CheckSort(&::Objects))
-			return false;
-	if (!SectorOut.Objects.CheckSort(&::Objects)) return false;
+	// sector lists must be sorted by current SectorOrder, which follows the main object list
+	for (const C4SpatialGrid<C4Object> *pGrid : { &Objects, &ObjectShapes })
+		for (int32_t i = 0; i <= pGrid->GetOutIndex(); ++i)
+		{
+			const auto &Cell = pGrid->GetCell(i);
+			for (size_t j = 0; j < Cell.size(); ++j)
+				if (Cell[j].Order != Cell[j].Obj->SectorOrder || (j && !(Cell[j-1] < Cell[j])))
+					return false;
+		}
+	uint64_t iLastOrder = 0;
+	for (C4Object *pObj : ::Objects)
+	{
+		if (pObj->SectorOrder <= iLastOrder) return false;
+		iLastOrder = pObj->SectorOrder;
+	}
 	return true;
 }
 
 void C4LSectors::ClearObjects()
 {
-	if (Sectors)
-	{
-		for (int cnt=0; cnt<Size; cnt++) Sectors[cnt].ClearObjects();
-	}
-	SectorOut.ClearObjects();
+	Objects.ClearCells();
+	ObjectShapes.ClearCells();
+	PrototypeObjects.clear();
+	for (auto &Category : CategoryObjects) Category.clear();
+	ObjectCount = 0;
 }
 
-/* landscape area */
+std::vector<C4Object *> &C4LSectors::AcquireBuffer()
+{
+	if (BuffersUsed == Buffers.size())
+		Buffers.emplace_back(new std::vector<C4Object *>());
+	std::vector<C4Object *> &Result = *Buffers[BuffersUsed++];
+	Result.clear();
+	return Result;
+}
+
+C4LSectors::Buffer::Buffer(C4LSectors &rSectors) : Objects(rSectors.AcquireBuffer()), rSectors(rSectors) { }
 
-bool C4LArea::operator == (const C4LArea &Area) const
+C4LSectors::Buffer::~Buffer()
 {
-	return pFirst == Area.pFirst &&
-	       xL == Area.xL &&
-	       yL == Area.yL &&
-	       pOut == Area.pOut;
+	--rSectors.BuffersUsed;
 }
 
+/* landscape area */
+
 void C4LArea::Set(C4LSectors *pSectors, const C4Rect &Rect)
 {
-	// default: no area
-	pFirst=nullptr; pOut=nullptr;
-	// check bounds
-	C4Rect ClippedRect(Rect),
-	Bounds(0, 0, pSectors->PxWdt, pSectors->PxHgt);
-	ClippedRect.Normalize();
-	if (!Bounds.Contains(ClippedRect))
-	{
-		ClippedRect.Intersect(Bounds);
-		pOut = &pSectors->SectorOut;
-	}
-	// calc first sector
-	pFirst = pSectors->SectorAt(ClippedRect.x, ClippedRect.y);
-	// assert the rect isn't degenerated for the following calculations
-	// (note this will associate areas that are above landscape bounds with sectors inside)
-	if (!ClippedRect.Wdt) ClippedRect.Wdt = 1;
-	if (!ClippedRect.Hgt) ClippedRect.Hgt = 1;
-	// calc bounds
-	xL = (ClippedRect.x + ClippedRect.Wdt - 1) / C4LSectorWdt;
-	yL = (ClippedRect.y + ClippedRect.Hgt - 1) / C4LSectorHgt;
-	// calc pitch
-	dpitch = pSectors->Wdt - (ClippedRect.x + ClippedRect.Wdt - 1) / C4LSectorWdt + ClippedRect.x / C4LSectorWdt;
+	this->pSectors = pSectors;
+	Cells = pSectors->Objects.GetArea(Rect);
 }
 
 void C4LArea::Set(C4LSectors *pSectors, C4Object *pObj)
@@ -273,59 +297,62 @@ void C4LArea::Set(C4LSectors *pSectors, C4Object *pObj)
 	Set(pSectors, C4Rect(pObj->Left(), pObj->Top(), pObj->Width(), pObj->Height()));
 }
 
-C4LSector *C4LArea::Next(C4LSector *pPrev) const
+void C4LArea::GetObjects(std::vector<C4Object *> &objects) const
 {
-	// the outside-sector is the last sector that is returned
-	if (pPrev == pOut)
-		return nullptr;
-	// within one line?
-	if (pPrev->x<xL)
-		return pPrev+1;
-	// within the area?
-	if (pPrev->y<yL)
-		return pPrev+dpitch;
-	// end reached - return outside-sector if applicable
-	return pOut;
+	if (!pSectors) return;
+	pSectors->Objects.Collect(Cells, objects);
 }
 
-bool C4LArea::Contains(C4LSector *pSct) const
+void C4LArea::GetObjectShapes(std::vector<C4Object *> &objects, bool fDuplicates) const
 {
-	assert(pSct);
-	// no area
-	if (!pFirst) return false;
-	// outside?
-	if (pSct == pOut) return true;
-	if (pFirst == pOut) return false;
-	// check bounds
-	return (pSct->x>=pFirst->x && pSct->y>=pFirst->y && pSct->x<=xL && pSct->y<=yL);
+	if (!pSectors) return;
+	// objects spanning several sectors are found once per sector
+	if (fDuplicates || IsSingleSector())
+	{
+		pSectors->ObjectShapes.Collect(Cells, objects);
+		return;
+	}
+	uint32_t iMarker = ::Objects.GetNextMarker();
+	pSectors->ObjectShapes.ForEachCell(Cells, [&objects, iMarker](const C4SpatialGrid<C4Object>::Cell &Cell, int32_t, int32_t)
+	{
+		for (const auto &Entry : Cell)
+			if (Entry.Obj->Marker != iMarker)
+			{
+				Entry.Obj->Marker = iMarker;
+				objects.push_back(Entry.Obj);
+			}
+	});
 }
 
-C4ObjectList *C4LArea::NextObjects(C4ObjectList *pPrev, C4LSector **ppSct)
+size_t C4LArea::GetObjectCount(bool fShapes) const
 {
-	// get next sector
-	if (!*ppSct)
-		*ppSct = First();
-	else
-		*ppSct = Next(*ppSct);
-	// nothing left?
-	if (!*ppSct)
-		return nullptr;
-	// return object list
-	return &(*ppSct)->Objects;
+	if (!pSectors) return 0;
+	size_t iCount = 0;
+	(fShapes ? pSectors->ObjectShapes : pSectors->Objects).ForEachCell(Cells, [&iCount](const C4SpatialGrid<C4Object>::Cell &Cell, int32_t, int32_t)
+	{
+		iCount += Cell.size();
+	});
+	return iCount;
 }
 
-C4ObjectList *C4LArea::NextObjectShapes(C4ObjectList *pPrev, C4LSector **ppSct)
+int32_t C4LArea::GetVisitIndex(const C4Object *pObj, bool fShapes) const
 {
-	// get next sector
-	if (!*ppSct)
-		*ppSct = First();
-	else
-		*ppSct = Next(*ppSct);
-	// nothing left?
-	if (!*ppSct)
-		return nullptr;
-	// return object list
-	return &(*ppSct)->ObjectShapes;
+	if (!pSectors || pObj->Area.IsNull()) return -1;
+	const C4SpatialGrid<C4Object> &Grid = pSectors->Objects;
+	// Objects are in one sector by position
+	if (!fShapes)
+	{
+		int32_t iIndex = Grid.IndexAt(pObj->old_x, pObj->old_y);
+		if (iIndex == Grid.GetOutIndex()) return Cells.Out ? iIndex : -1;
+		return Cells.Contains(iIndex % Grid.GetWidth(), iIndex / Grid.GetWidth()) ? iIndex : -1;
+	}
+	// Shapes are in a rectangle of sectors. Sectors are visited row by row, so the first
+	// common sector is the top left one of the intersection.
+	const C4SpatialGrid<C4Object>::Area &Shape = pObj->Area.Cells;
+	int32_t x0 = std::max(Cells.x0, Shape.x0), x1 = std::min(Cells.x1, Shape.x1);
+	int32_t y0 = std::max(Cells.y0, Shape.y0), y1 = std::min(Cells.y1, Shape.y1);
+	if (x0 <= x1 && y0 <= y1) return y0 * Grid.GetWidth() + x0;
+	return Cells.Out && Shape.Out ? Grid.GetOutIndex() : -1;
 }
 
 void C4LArea::DebugRec(class C4Object *pObj, char cMarker)
@@ -333,11 +360,11 @@ void C4LArea::DebugRec(class C4Object *pObj, char cMarker)
 	C4RCArea rc;
 	rc.op = cMarker;
 	rc.obj = pObj ? pObj->Number : -1;
-	rc.x1 = pFirst ? pFirst->x : -1;
-	rc.y1 = pFirst ? pFirst->x /* 2do: y */ : -1;
-	rc.xL = xL;
-	rc.yL = yL;
-	rc.dpitch = dpitch;
-	rc.out = !!pOut;
+	rc.x1 = Cells.x1 >= Cells.x0 ? Cells.x0 : -1;
+	rc.y1 = Cells.x1 >= Cells.x0 ? Cells.y0 : -1;
+	rc.xL = Cells.x1;
+	rc.yL = Cells.y1;
+	rc.dpitch = pSectors ? pSectors->Objects.GetWidth() - (Cells.x1 - Cells.x0) : 0;
+	rc.out = Cells.Out;
 	AddDbgRec(RCT_Area, &rc, sizeof(C4RCArea));
 }
@@ -20,110 +20,116 @@
 #define INC_C4Sector
 
 #include "lib/C4Rect.h"
-#include "object/C4ObjectList.h"
+#include "lib/C4SpatialGrid.h"
+
+#include <memory>
+#include <unordered_map>
 
 // class predefs
-class C4LSector;
 class C4LSectors;
 class C4LArea;
 
 // constants
-const int32_t C4LSectorWdt = 50,
-                             C4LSectorHgt = 50;
+const int32_t C4LSectorSize = 50; // default sector edge length in px. Must be the same for all clients, because it affects the order of search results.
+const int32_t C4LSectorCategoryBits = 8; // category bits with an object list: C4D_StaticBack to C4D_Environment
 
-// one of those object list sectors
-class C4LSector
+// a defined sector-area within the map
+class C4LArea
 {
 public:
-	C4LSector() = default; // constructor
-	~C4LSector() { Clear(); } // destructor
+	C4LSectors *pSectors; // map of the area; nullptr for no area
+	C4SpatialGrid<C4Object>::Area Cells; // covered sectors
 
-protected:
-	void Init(int ix, int iy);
-	void Clear();
+	C4LArea() { Clear(); } // default constructor
+	C4LArea(C4LSectors *pSectors, int ix, int iy, int iwdt, int ihgt) // initializing constructor
+	{ Set(pSectors, C4Rect(ix, iy, iwdt, ihgt)); }
+	C4LArea(C4LSectors *pSectors, const C4Rect &rect) // initializing constructor
+	{ Set(pSectors, rect); }
 
-public:
-	int x, y; // pos
+	C4LArea(C4LSectors *pSectors, C4Object *pObj) // initializing constructor
+	{ Set(pSectors, pObj); }
 
-	C4ObjectList Objects; // objects within this sector
-	C4ObjectList ObjectShapes; // objects with shapes that overlap this sector
+	inline void Clear() { pSectors=nullptr; Cells = C4SpatialGrid<C4Object>::Area(); } // zero sector
 
-	void CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers);
-	void ClearObjects(); // remove all objects from object lists
+	bool operator == (const C4LArea &Area) const { return pSectors == Area.pSectors && Cells == Area.Cells; }
 
-	friend class C4LSectors;
+	bool IsNull() const { return !pSectors; }
+
+	void Set(C4LSectors *pSectors, const C4Rect &rect); // set rect, calc bounds
+	void Set(C4LSectors *pSectors, C4Object *pObj); // set to object facet rect
+
+	bool IsSingleSector() const { return Cells.GetCellCount() <= 1; }
+
+	// Number of objects (or shapes) in the covered sectors, counting objects spanning several sectors once per sector
+	size_t GetObjectCount(bool fShapes) const;
+	// Position of the first sector containing the object (or its shape) in the order in which the
+	// area is visited, or -1 if it is not in the area
+	int32_t GetVisitIndex(const C4Object *pObj, bool fShapes) const;
+
+	// Append all objects positioned within the area, in sector order and main list order within each sector.
+	void GetObjects(std::vector<C4Object *> &objects) const;
+	// Append all objects whose shapes overlap the area. Objects overlapping several sectors are appended
+	// once unless fDuplicates is set, which saves marking them.
+	void GetObjectShapes(std::vector<C4Object *> &objects, bool fDuplicates = false) const;
+
+	void DebugRec(class C4Object *pObj, char cMarker);
 };
 
 // the whole map
 class C4LSectors
 {
 public:
-	C4LSector *Sectors; // mem holding the sector array
-	int PxWdt, PxHgt; // size in px
-	int Wdt, Hgt, Size; // sector count
-
-	C4LSector SectorOut; // the sector "outside"
+	C4SpatialGrid<C4Object> Objects; // objects by position
+	C4SpatialGrid<C4Object> ObjectShapes; // objects by sectors overlapped by their shapes
+	// All objects by prototype and by category bit, sorted like the sector lists
+	std::unordered_map<const C4PropList *, C4SpatialGrid<C4Object>::Cell> PrototypeObjects;
+	C4SpatialGrid<C4Object>::Cell CategoryObjects[C4LSectorCategoryBits];
 
 public:
-	void Init(int Wdt, int Hgt); // init map sectors
+	void Init(int Wdt, int Hgt, int32_t iSectorSize = C4LSectorSize); // init map sectors
 	void Clear(); // free map sectors
-	C4LSector *SectorAt(int ix, int iy); // get sector at pos
 
-	void Add(C4Object *pObj, C4ObjectList *pMainList);
-	void Update(C4Object *pObj, C4ObjectList *pMainList); // does not update object order!
+	void Add(C4Object *pObj);
+	void Update(C4Object *pObj); // incremental: only touches sectors the object entered or left
 	void Remove(C4Object *pObj);
+	void UpdateIndex(C4Object *pObj); // prototype or category changed
 	void ClearObjects(); // remove all objects from object lists
+	void UpdateOrder(); // re-sort after C4Object::SectorOrder values have been renumbered
 
 	void AssertObjectNotInList(C4Object *pObj); // searches all sector lists for object, and assert if it's inside a list
 
 	int getShapeSum() const;
 
+	size_t GetObjectCount() const { return ObjectCount; }
+	const C4SpatialGrid<C4Object>::Cell *GetPrototypeObjects(const C4PropList *pPrototype) const;
+	static bool IsIndexedCategory(int32_t iCategory) { return iCategory && !(iCategory & ~((1 << C4LSectorCategoryBits) - 1)); }
+	size_t GetCategoryObjectCount(int32_t iCategory) const; // upper bound; objects with several of the bits are counted repeatedly
+	void GetCategoryObjects(int32_t iCategory, std::vector<C4Object *> &objects) const; // append in main list order
+
 	void Dump();
 	bool CheckSort();
-};
 
-// a defined sector-area within the map
-class C4LArea
-{
-public:
-	C4LSector *pFirst;
-	int xL, yL, dpitch; // bounds / delta-pitch
-	C4LSector *pOut; // outside?
-
-	C4LArea() { Clear(); } // default constructor
-	C4LArea(C4LSectors *pSectors, int ix, int iy, int iwdt, int ihgt) // initializing constructor
-	{ Set(pSectors, C4Rect(ix, iy, iwdt, ihgt)); }
-	C4LArea(C4LSectors *pSectors, const C4Rect &rect) // initializing constructor
-	{ Set(pSectors, rect); }
-
-	C4LArea(C4LSectors *pSectors, C4Object *pObj) // initializing constructor
-	{ Set(pSectors, pObj); }
-
-	inline void Clear() { pFirst=pOut=nullptr; } // zero sector
-
-	bool operator == (const C4LArea &Area) const;
-
-	bool IsNull() const { return !pFirst; }
-
-	void Set(C4LSectors *pSectors, const C4Rect &rect); // set rect, calc bounds and get pitch
-	void Set(C4LSectors *pSectors, C4Object *pObj); // set to object facet rect
-
-	C4LSector *First() const { return pFirst; } // get first sector
-	C4LSector *Next(C4LSector *pPrev) const; // get next sector within area
-
-	// void MoveObject(C4Object *pObj, const C4LArea &toArea); // store object into new area
-
-	bool Contains(C4LSector *pSct) const; // return whether sector is contained in area
-
-	inline C4ObjectList *FirstObjects(C4LSector **ppSct) // get first object list of this area
-	{ *ppSct=nullptr; return NextObjects(nullptr, ppSct); }
-	C4ObjectList *NextObjects(C4ObjectList *pPrev, C4LSector **ppSct); // get next object list of this area
-
-	inline C4ObjectList *FirstObjectShapes(C4LSector **ppSct) // get first object shapes list of this area
-	{ *ppSct=nullptr; return NextObjectShapes(nullptr, ppSct); }
-	C4ObjectList *NextObjectShapes(C4ObjectList *pPrev, C4LSector **ppSct); // get next object shapes list of this area
-
-	void DebugRec(class C4Object *pObj, char cMarker);
+	// Scratch list for collecting the objects of an area. Lists are recycled; nested
+	// searches (e.g. from script callbacks during a search) each get their own.
+	class Buffer
+	{
+	public:
+		explicit Buffer(C4LSectors &rSectors);
+		~Buffer();
+		std::vector<C4Object *> &Objects;
+	private:
+		C4LSectors &rSectors;
+	};
+
+private:
+	void AddToIndex(C4Object *pObj);
+	void RemoveFromIndex(C4Object *pObj);
+
+	size_t ObjectCount = 0;
+
+	std::vector<std::unique_ptr<std::vector<C4Object *>>> Buffers;
+	size_t BuffersUsed = 0;
+	std::vector<C4Object *> &AcquireBuffer();
 };
 
 #endif
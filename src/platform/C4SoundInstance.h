@@ -40,7 +40,7 @@ public:
 public:
 	void Clear();
 	bool Load(const char *szFileName, C4Group &hGroup, const char *namespace_prefix);
-	bool Load(BYTE *pData, size_t iDataLen, bool fRaw=false); // load directly from memory
+	bool Load(const BYTE *pData, size_t iDataLen, bool fRaw=false); // load directly from memory
 	void Execute();
 	C4SoundInstance *New(bool fLoop = false, int32_t iVolume = 100, C4Object *pObj = nullptr, int32_t iCustomFalloffDistance = 0, int32_t iPitch = 0, C4SoundModifier *modifier = nullptr);
 	C4SoundInstance *GetInstance(C4Object *pObj);
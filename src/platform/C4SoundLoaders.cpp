@@ -51,7 +51,7 @@ namespace
 	}
 }
 
-bool AppleSoundLoader::ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t)
+bool AppleSoundLoader::ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t)
 {
 	CFDataRef data_container = CFDataCreateWithBytesNoCopy(kCFAllocatorDefault, data, data_length, kCFAllocatorNull);
 	AudioFileID sound_file;
@@ -118,7 +118,7 @@ size_t VorbisLoader::mem_read_func(void* ptr, size_t byte_size, size_t size_to_r
 	
 	if (actualSizeToRead)
 	{
-		memcpy(ptr, (char*)data->data + data->data_pos, actualSizeToRead);
+		memcpy(ptr, data->data + data->data_pos, actualSizeToRead);
 		data->data_pos += actualSizeToRead;
 	}
 	
@@ -182,7 +182,7 @@ long VorbisLoader::file_tell_func(void* datasource)
 	return ogg->source_file.Tell();
 }
 
-bool VorbisLoader::ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t)
+bool VorbisLoader::ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t)
 {
 	CompressedData compressed(data, data_length);
 
@@ -239,7 +239,7 @@ bool VorbisLoader::ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, u
 VorbisLoader VorbisLoader::singleton;
 
 #ifndef __APPLE__
-bool WavLoader::ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t)
+bool WavLoader::ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t)
 {
 	// load WAV resource
 	Application.MusicSystem.SelectContext();
@@ -281,7 +281,7 @@ WavLoader WavLoader::singleton;
 #define USE_RWOPS
 #include <SDL_mixer.h>
 
-bool SDLMixerSoundLoader::ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t)
+bool SDLMixerSoundLoader::ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t)
 {
 	// Be paranoid about SDL_Mixer initialisation
 	if (!Application.MusicSystem.IsMODInitialized())
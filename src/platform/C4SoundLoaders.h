@@ -48,7 +48,7 @@ namespace C4SoundLoaders
 			first_loader = this;
 		}
 		virtual ~SoundLoader() = default;
-		virtual bool ReadInfo(SoundInfo* info, BYTE* data, size_t data_length, uint32_t options = 0) = 0;
+		virtual bool ReadInfo(SoundInfo* info, const BYTE* data, size_t data_length, uint32_t options = 0) = 0;
 	};
 
 #if AUDIO_TK == AUDIO_TK_OPENAL && defined(__APPLE__)
@@ -56,7 +56,7 @@ namespace C4SoundLoaders
 	{
 	public:
 		AppleSoundLoader(): SoundLoader() {}
-		virtual bool ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t);
+		virtual bool ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t);
 	protected:
 		static AppleSoundLoader singleton;
 	};
@@ -69,11 +69,11 @@ namespace C4SoundLoaders
 		struct CompressedData
 		{
 		public:
-			BYTE* data{nullptr};
+			const BYTE* data{nullptr};
 			size_t data_length{0};
 			size_t data_pos{0};
 			bool is_data_owned{false}; // if true, dtor will delete data
-			CompressedData(BYTE* data, size_t data_length): data(data), data_length(data_length) {}
+			CompressedData(const BYTE* data, size_t data_length): data(data), data_length(data_length) {}
 			CompressedData() = default;
 			void SetOwnedData(BYTE* data, size_t data_length)
 			{ clear(); this->data=data; this->data_length=data_length; this->data_pos=0; is_data_owned=true; }
@@ -92,7 +92,7 @@ namespace C4SoundLoaders
 		static int file_close_func(void* datasource);
 		static long file_tell_func(void* datasource);
 	public:
-		bool ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t) override;
+		bool ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t) override;
 	protected:
 		static VorbisLoader singleton;
 	};
@@ -101,7 +101,7 @@ namespace C4SoundLoaders
 	class WavLoader: public SoundLoader
 	{
 	public:
-		bool ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t) override;
+		bool ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t) override;
 	protected:
 		static WavLoader singleton;
 	};
@@ -112,7 +112,7 @@ namespace C4SoundLoaders
 	{
 	public:
 		static SDLMixerSoundLoader singleton;
-		bool ReadInfo(SoundInfo* result, BYTE* data, size_t data_length, uint32_t) override;
+		bool ReadInfo(SoundInfo* result, const BYTE* data, size_t data_length, uint32_t) override;
 	};
 #endif
 }
@@ -0,0 +1,100 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* A fixed set of worker threads processing a queue of tasks */
+
+#include "C4Include.h"
+#include "platform/C4ThreadPool.h"
+
+#include <atomic>
+
+C4ThreadPool::C4ThreadPool(unsigned int thread_count)
+{
+	threads.reserve(thread_count);
+	for (unsigned int i = 0; i < thread_count; ++i)
+		threads.emplace_back(&C4ThreadPool::Work, this);
+}
+
+C4ThreadPool::~C4ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		stopping = true;
+	}
+	queue_cond.notify_all();
+	for (std::thread &thread : threads)
+		thread.join();
+}
+
+C4ThreadPool &C4ThreadPool::Default()
+{
+	static C4ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+	return pool;
+}
+
+void C4ThreadPool::Enqueue(std::function<void()> task)
+{
+	if (threads.empty())
+	{
+		task();
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(queue_mutex);
+		queue.push_back(std::move(task));
+	}
+	queue_cond.notify_one();
+}
+
+void C4ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)> &body)
+{
+	if (!count) return;
+	// Workers and the calling thread pull indices until all are taken
+	auto next = std::make_shared<std::atomic<size_t>>(0);
+	auto run = [next, count, &body]()
+	{
+		for (size_t i; (i = (*next)++) < count; )
+			body(i);
+	};
+	const size_t helper_count = std::min<size_t>(threads.size(), count - 1);
+	std::vector<std::future<void>> helpers;
+	helpers.reserve(helper_count);
+	for (size_t i = 0; i < helper_count; ++i)
+		helpers.push_back(Submit(run));
+	// Helpers reference body, so wait for all of them before passing on any exception
+	std::exception_ptr error;
+	try { run(); } catch (...) { error = std::current_exception(); }
+	for (std::future<void> &helper : helpers)
+	{
+		try { helper.get(); } catch (...) { if (!error) error = std::current_exception(); }
+	}
+	if (error) std::rethrow_exception(error);
+}
+
+void C4ThreadPool::Work()
+{
+	for (;;)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(queue_mutex);
+			queue_cond.wait(lock, [this]() { return stopping || !queue.empty(); });
+			if (queue.empty()) return;
+			task = std::move(queue.front());
+			queue.pop_front();
+		}
+		task();
+	}
+}
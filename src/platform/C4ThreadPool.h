@@ -0,0 +1,66 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+/* A fixed set of worker threads processing a queue of tasks */
+
+#ifndef INC_C4ThreadPool
+#define INC_C4ThreadPool
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+class C4ThreadPool
+{
+public:
+	explicit C4ThreadPool(unsigned int thread_count);
+	~C4ThreadPool();
+	C4ThreadPool(const C4ThreadPool &) = delete;
+	C4ThreadPool &operator=(const C4ThreadPool &) = delete;
+
+	// Pool shared by all engine subsystems. One worker per hardware thread besides the main thread.
+	static C4ThreadPool &Default();
+
+	unsigned int GetThreadCount() const { return threads.size(); }
+
+	// Queue a task. Without worker threads, it is run immediately.
+	void Enqueue(std::function<void()> task);
+	template<class F> std::future<typename std::result_of<F()>::type> Submit(F &&f)
+	{
+		typedef typename std::result_of<F()>::type Result;
+		auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+		std::future<Result> result = task->get_future();
+		Enqueue([task]() { (*task)(); });
+		return result;
+	}
+
+	// Run body(i) for all i in [0, count) and wait for completion. The calling thread
+	// participates, so this must not be called from a worker of the same pool.
+	void ParallelFor(size_t count, const std::function<void(size_t)> &body);
+
+private:
+	std::vector<std::thread> threads;
+	std::deque<std::function<void()>> queue;
+	std::mutex queue_mutex;
+	std::condition_variable queue_cond;
+	bool stopping = false;
+
+	void Work();
+};
+
+#endif // INC_C4ThreadPool
@@ -241,6 +241,8 @@ class C4AulCompiler::CodegenAstVisitor : public ::aul::DefaultRecursiveVisitor
 	}
 
 	static int GetStackValue(C4AulBCCType eType, intptr_t X);
+	void FuseSuperinstructions();
+	void AddInlineCaches();
 	void RemoveLastBCC();
 	C4AulBCC MakeSetter(const char *SPos, bool fLeaveValue);
 
@@ -496,6 +498,9 @@ void C4AulCompiler::Preparse(C4ScriptHost *host, C4ScriptHost *source_host, cons
 	ConstantResolver::resolve_quiet(host, script);
 }
 
+bool C4AulCompiler::UseSuperinstructions = true;
+bool C4AulCompiler::UseInlineCaches = true;
+
 void C4AulCompiler::Compile(C4ScriptHost *host, C4ScriptHost *source_host, const ::aul::ast::Script *script)
 {
 	ConstantResolver::resolve(host, script);
@@ -784,6 +789,14 @@ int C4AulCompiler::CodegenAstVisitor::GetStackValue(C4AulBCCType eType, intptr_t
 
 	case AB_ARRAY_SLICE_SET:
 		return -3;
+
+	// Superinstructions only appear after code generation
+	case AB_DUP_PROP:
+	case AB_INT_CMP_CONDN:
+	case AB_PROP_SET_POP:
+	case AB_STACK_FUNC:
+	case AB_STACK_CALL:
+		break;
 	}
 	assert(0 && "GetStackValue: unexpected bytecode not handled");
 	return 0;
@@ -1631,6 +1644,72 @@ void C4AulCompiler::CodegenAstVisitor::EmitFunctionCode(const ::aul::ast::Functi
 	// case.
 	AddBCC(n->loc, AB_EOFN);
 	assert(stack_height == 0);
+	if (C4AulCompiler::UseSuperinstructions)
+		FuseSuperinstructions();
+	if (C4AulCompiler::UseInlineCaches)
+		AddInlineCaches();
+}
+
+void C4AulCompiler::CodegenAstVisitor::AddInlineCaches()
+{
+	// Engine property names can have special handling in GetPropertyByS, so
+	// only method calls use the cache for them
+	auto is_engine_name = [](const C4String *k) { return k >= &Strings.P[0] && k < &Strings.P[P_LAST]; };
+	for (C4AulBCC &bcc : Fn->Code)
+	{
+		switch (bcc.bccType)
+		{
+		case AB_PROP:
+		case AB_LOCALN:
+			if (is_engine_name(bcc.Par.s)) continue;
+			break;
+		case AB_CALL:
+		case AB_CALLFS:
+			break;
+		default:
+			continue;
+		}
+		bcc.Cache = Fn->InlineCaches.size();
+		Fn->InlineCaches.emplace_back();
+	}
+}
+
+void C4AulCompiler::CodegenAstVisitor::FuseSuperinstructions()
+{
+	// Only the first chunk of a sequence is replaced, so code positions and
+	// jump offsets stay valid. Sequences must not contain jump targets, though.
+	std::vector<C4AulBCC> &code = Fn->Code;
+	std::vector<bool> is_target(code.size() + 1, false);
+	for (size_t i = 0; i < code.size(); ++i)
+	{
+		if (IsJump(code[i].bccType))
+			is_target[i + code[i].Par.i] = true;
+		else if (code[i].bccType == AB_FOREACH_NEXT)
+			is_target[i + 2] = true;
+	}
+	auto is_cmp = [](C4AulBCCType t)
+	{
+		return t == AB_LessThan || t == AB_LessThanEqual || t == AB_GreaterThan || t == AB_GreaterThanEqual || t == AB_Equal || t == AB_NotEqual;
+	};
+	for (size_t i = 0; i + 1 < code.size(); ++i)
+	{
+		C4AulBCC &first = code[i], &second = code[i + 1];
+		if (is_target[i + 1]) continue;
+		if (first.bccType == AB_DUP && second.bccType == AB_PROP)
+			first.bccType = AB_DUP_PROP;
+		else if (first.bccType == AB_PROP_SET && second.bccType == AB_STACK && second.Par.i < 0)
+			first.bccType = AB_PROP_SET_POP;
+		else if (first.bccType == AB_STACK && first.Par.i > 0 && second.bccType == AB_FUNC)
+			first.bccType = AB_STACK_FUNC;
+		else if (first.bccType == AB_STACK && first.Par.i > 0 && (second.bccType == AB_CALL || second.bccType == AB_CALLFS))
+			first.bccType = AB_STACK_CALL;
+		else if (first.bccType == AB_INT && is_cmp(second.bccType) && code[i + 2].bccType == AB_CONDN && !is_target[i + 2])
+			first.bccType = AB_INT_CMP_CONDN;
+		else
+			continue;
+		// The remaining chunks of the sequence are operands now
+		i += first.bccType == AB_INT_CMP_CONDN ? 2 : 1;
+	}
 }
 
 void C4AulCompiler::CodegenAstVisitor::visit(const ::aul::ast::DoLoop *n)
@@ -27,6 +27,11 @@ public:
 	static void Preparse(C4ScriptHost *out, C4ScriptHost *source, const ::aul::ast::Script *s);
 	static void Compile(C4ScriptHost *out, C4ScriptHost *source, const ::aul::ast::Script *s);
 
+	// Combine frequent chunk sequences into superinstructions after code generation
+	static bool UseSuperinstructions;
+	// Give property accesses and method calls an inline cache
+	static bool UseInlineCaches;
+
 private:
 	class ConstexprEvaluator;
 	class ConstantResolver;
@@ -20,6 +20,7 @@
 
 #include "control/C4Record.h"
 #include "object/C4Def.h"
+#include "object/C4FindObject.h"
 #include "object/C4Object.h"
 #include "script/C4Aul.h"
 #include "script/C4AulScriptFunc.h"
@@ -190,6 +191,25 @@ C4Value C4AulExec::Exec(C4AulScriptFunc *pSFunc, C4PropList * p, C4Value *pnPars
 	return C4VNull;
 }
 
+inline bool C4AulExec::GetPropertyCached(const C4PropList *pPropList, const C4AulBCC *pCPos, C4Value *pResult)
+{
+	if (pCPos->Cache < 0)
+		return pPropList->GetPropertyByS(pCPos->Par.s, pResult);
+	const C4Value *pProp = pPropList->GetPropertyCached(pCPos->Par.s, pCurCtx->Func->InlineCaches[pCPos->Cache]);
+	if (!pProp)
+		return false;
+	*pResult = *pProp;
+	return true;
+}
+
+inline C4AulFunc *C4AulExec::GetFuncCached(const C4PropList *pPropList, const C4AulBCC *pCPos)
+{
+	if (pCPos->Cache < 0)
+		return pPropList->GetFunc(pCPos->Par.s);
+	const C4Value *pProp = pPropList->GetPropertyCached(pCPos->Par.s, pCurCtx->Func->InlineCaches[pCPos->Cache]);
+	return pProp ? pProp->getFunction() : nullptr;
+}
+
 C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 {
 	try
@@ -257,7 +277,7 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				if (!pCurCtx->Obj)
 					throw C4AulExecError("can't access local variables without this");
 				PushNullVals(1);
-				pCurCtx->Obj->GetPropertyByS(pCPos->Par.s, pCurVal);
+				GetPropertyCached(pCurCtx->Obj, pCPos, pCurVal);
 				break;
 			case AB_LOCALN_SET:
 				if (!pCurCtx->Obj)
@@ -270,7 +290,7 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 			case AB_PROP:
 				if (!pCurVal->CheckConversion(C4V_PropList))
 					throw C4AulExecError(FormatString("proplist access: proplist expected, got %s", pCurVal->GetTypeName()).getData());
-				if (!pCurVal->_getPropList()->GetPropertyByS(pCPos->Par.s, pCurVal))
+				if (!GetPropertyCached(pCurVal->_getPropList(), pCPos, pCurVal))
 					pCurVal->Set0();
 				break;
 			case AB_PROP_SET:
@@ -286,6 +306,62 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				break;
 			}
 
+			// superinstructions, falling back to their first chunk if the fast path doesn't apply
+			case AB_DUP_PROP:
+			{
+				C4Value *pPropList = pCurVal + pCPos->Par.i;
+				if (!pPropList->CheckConversion(C4V_PropList))
+				{
+					PushValue(*pPropList);
+					break;
+				}
+				PushNullVals(1);
+				if (!GetPropertyCached(pPropList->_getPropList(), pCPos + 1, pCurVal))
+					pCurVal->Set0();
+				pCPos += 2;
+				fJump = true;
+				break;
+			}
+			case AB_PROP_SET_POP:
+			{
+				C4Value *pPropList = pCurVal - 1;
+				if (!pPropList->CheckConversion(C4V_PropList))
+					throw C4AulExecError(FormatString("proplist write: proplist expected, got %s", pPropList->GetTypeName()).getData());
+				if (pPropList->_getPropList()->IsFrozen())
+					throw C4AulExecError("proplist write: proplist is readonly");
+				pPropList->_getPropList()->SetPropertyByS(pCPos->Par.s, pCurVal[0]);
+				PopValues(1 - pCPos[1].Par.i);
+				pCPos += 2;
+				fJump = true;
+				break;
+			}
+			case AB_INT_CMP_CONDN:
+			{
+				if (pCurVal->GetType() != C4V_Int)
+				{
+					PushInt(pCPos->Par.i);
+					break;
+				}
+				int32_t iLeft = pCurVal->_getInt(), iRight = pCPos->Par.i;
+				bool fResult;
+				switch (pCPos[1].bccType)
+				{
+				case AB_LessThan: fResult = iLeft < iRight; break;
+				case AB_LessThanEqual: fResult = iLeft <= iRight; break;
+				case AB_GreaterThan: fResult = iLeft > iRight; break;
+				case AB_GreaterThanEqual: fResult = iLeft >= iRight; break;
+				case AB_Equal: fResult = iLeft == iRight; break;
+				default: assert(pCPos[1].bccType == AB_NotEqual); fResult = iLeft != iRight; break;
+				}
+				PopValue();
+				if (fResult)
+					pCPos += 3;
+				else
+					pCPos += 2 + pCPos[2].Par.i;
+				fJump = true;
+				break;
+			}
+
 			case AB_GLOBALN:
 				PushValue(*::ScriptEngine.GlobalNamed.GetItem(pCPos->Par.i));
 				break;
@@ -683,6 +759,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				break;
 			}
 
+			case AB_STACK_FUNC:
+				PushNullVals(pCPos->Par.i);
+				++pCPos;
+				// fallthrough
 			case AB_FUNC:
 			{
 				// Get function call data
@@ -743,6 +823,10 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 				break;
 			}
 
+			case AB_STACK_CALL:
+				PushNullVals(pCPos->Par.i);
+				++pCPos;
+				// fallthrough
 			case AB_CALL:
 			case AB_CALLFS:
 			{
@@ -759,7 +843,7 @@ C4Value C4AulExec::Exec(C4AulBCC *pCPos)
 					throw C4AulExecError(FormatString("'->': invalid target type %s, expected proplist", pTargetVal->GetTypeName()).getData());
 
 				// Search function for given context
-				C4AulFunc * pFunc = pDest->GetFunc(pCPos->Par.s);
+				C4AulFunc * pFunc = GetFuncCached(pDest, pCPos);
 				if (!pFunc && pCPos->bccType == AB_CALLFS)
 				{
 					PopValuesUntil(pTargetVal);
@@ -882,6 +966,7 @@ C4AulBCC *C4AulExec::Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4
 		}
 
 		// Execute
+		++iEngineCalls;
 #ifdef _DEBUG
 		C4AulScriptContext *pCtx = pCurCtx;
 #endif
@@ -927,6 +1012,7 @@ void C4AulExec::PushContext(const C4AulScriptContext &rContext)
 	if (pCurCtx >= Contexts + MAX_CONTEXT_STACK - 1)
 		throw C4AulExecError("context stack overflow");
 	*++pCurCtx = rContext;
+	++iScriptCalls;
 	// Trace?
 	if (iTraceStart >= 0)
 	{
@@ -967,6 +1053,7 @@ void C4AulProfiler::StartProfiling(C4ScriptHost *pScript)
 		ResetTimes(pScript->GetPropList());
 	else
 		ResetTimes();
+	C4FindObjectProfiler::Reset();
 }
 
 void C4AulProfiler::StopProfiling()
@@ -981,6 +1068,7 @@ void C4AulProfiler::StopProfiling()
 	else
 		Profiler.CollectTimes();
 	Profiler.Show();
+	C4FindObjectProfiler::Show();
 }
 
 void C4AulProfiler::CollectEntry(C4AulScriptFunc *pFunc, uint32_t tProfileTime)
@@ -994,6 +1082,21 @@ void C4AulProfiler::CollectEntry(C4AulScriptFunc *pFunc, uint32_t tProfileTime)
 	Times.push_back(e);
 }
 
+void C4AulProfiler::CollectCaches(C4AulScriptFunc *pFunc)
+{
+	for (C4AulBCC *pCPos = pFunc->GetCode(); pCPos->bccType != AB_EOFN; ++pCPos)
+	{
+		if (pCPos->Cache < 0) continue;
+		const C4AulInlineCache &cache = pFunc->InlineCaches[pCPos->Cache];
+		if (!cache.Hits && !cache.Misses) continue;
+		CacheKind kind = pCPos->bccType == AB_PROP ? CK_Property : pCPos->bccType == AB_LOCALN ? CK_Local : CK_Call;
+		CacheHits[kind] += cache.Hits;
+		CacheMisses[kind] += cache.Misses;
+		if (cache.Misses)
+			CacheSites.push_back({ pFunc, pCPos, cache.Misses });
+	}
+}
+
 void C4AulProfiler::Show()
 {
 	// sort by time
@@ -1006,6 +1109,20 @@ void C4AulProfiler::Show()
 		LogF("%05ums\t%s", e.tProfileTime, e.pFunc ? (e.pFunc->GetFullName().getData()) : "Direct exec");
 	}
 	Log("==============================");
+	// inline cache hit rates, and the sites missing most often
+	const char *szKinds[CK_Count] = { "property reads", "local variables", "method calls" };
+	for (int i = 0; i < CK_Count; ++i)
+	{
+		uint64_t iLookups = CacheHits[i] + CacheMisses[i];
+		if (iLookups)
+			LogF("Inline caches, %s: %.1f%% hits (%llu lookups)", szKinds[i], 100.0 * CacheHits[i] / iLookups, (unsigned long long) iLookups);
+	}
+	std::sort(CacheSites.rbegin(), CacheSites.rend());
+	if (CacheSites.size() > 10) CacheSites.resize(10);
+	for (auto & e : CacheSites)
+		LogF("%u misses\t%s line %d (%s)", e.Misses, e.pFunc->GetFullName().getData(), e.pFunc->GetLineOfCode(e.pCPos), e.pCPos->Par.s->GetCStr());
+	if (!CacheSites.empty())
+		Log("==============================");
 	// done!
 }
 
@@ -1062,7 +1179,11 @@ void C4AulProfiler::ResetTimes(C4PropListStatic * p)
 	C4AulScriptFunc *pSFunc;
 	for (C4String *pFn = p->EnumerateOwnFuncs(); pFn; pFn = p->EnumerateOwnFuncs(pFn))
 		if ((pSFunc = p->GetFunc(pFn)->SFunc()))
+		{
 			pSFunc->tProfileTime = 0;
+			for (C4AulInlineCache &cache : pSFunc->InlineCaches)
+				cache.Hits = cache.Misses = 0;
+		}
 }
 
 void C4AulProfiler::CollectTimes(C4PropListStatic * p)
@@ -1071,7 +1192,10 @@ void C4AulProfiler::CollectTimes(C4PropListStatic * p)
 	C4AulScriptFunc *pSFunc;
 	for (C4String *pFn = p->EnumerateOwnFuncs(); pFn; pFn = p->EnumerateOwnFuncs(pFn))
 		if ((pSFunc = p->GetFunc(pFn)->SFunc()))
+		{
 			CollectEntry(pSFunc, pSFunc->tProfileTime);
+			CollectCaches(pSFunc);
+		}
 }
 
 void C4AulProfiler::ResetTimes()
@@ -69,6 +69,10 @@ private:
 	uint32_t tDirectExecTotal; // profiler time for DirectExec
 	C4ScriptHost *pProfiledScript;
 
+	// number of script and engine function calls since startup
+	uint64_t iScriptCalls{0};
+	uint64_t iEngineCalls{0};
+
 	C4AulScriptContext Contexts[MAX_CONTEXT_STACK];
 	C4Value Values[MAX_VALUE_STACK];
 
@@ -84,6 +88,9 @@ public:
 	inline void StartDirectExec() { if (fProfiling) tDirectExecStart = C4TimeMilliseconds::Now(); }
 	inline void StopDirectExec() { if (fProfiling) tDirectExecTotal += C4TimeMilliseconds::Now() - tDirectExecStart; }
 
+	uint64_t GetScriptCallCount() const { return iScriptCalls; }
+	uint64_t GetEngineCallCount() const { return iEngineCalls; }
+
 	int GetContextDepth() const { return pCurCtx - Contexts + 1; }
 	C4AulScriptContext *GetContext(int iLevel) { return iLevel >= 0 && iLevel < GetContextDepth() ? Contexts + iLevel : nullptr; }
 	void LogCallStack();
@@ -227,6 +234,10 @@ private:
 			throw C4AulExecError(FormatString("can't access %s as array or proplist", pStructure->GetTypeName()).getData());
 	}
 	C4AulBCC *Call(C4AulFunc *pFunc, C4Value *pReturn, C4Value *pPars, C4PropList * pContext = nullptr);
+
+	// property lookup and function search through the inline cache of the chunk, if it has one
+	bool GetPropertyCached(const C4PropList *pPropList, const C4AulBCC *pCPos, C4Value *pResult);
+	C4AulFunc *GetFuncCached(const C4PropList *pPropList, const C4AulBCC *pCPos);
 };
 
 extern C4AulExec AulExec;
@@ -244,10 +255,24 @@ private:
 		bool operator < (const Entry &e2) const { return tProfileTime < e2.tProfileTime ; }
 	};
 
+	// inline cache statistics per kind of call site
+	enum CacheKind { CK_Property, CK_Local, CK_Call, CK_Count };
+	struct CacheSite
+	{
+		C4AulScriptFunc *pFunc;
+		C4AulBCC *pCPos;
+		uint32_t Misses;
+
+		bool operator < (const CacheSite &e2) const { return Misses < e2.Misses; }
+	};
+
 	// items
 	std::vector<Entry> Times;
+	uint64_t CacheHits[CK_Count] = {}, CacheMisses[CK_Count] = {};
+	std::vector<CacheSite> CacheSites;
 
 	void CollectEntry(C4AulScriptFunc *pFunc, uint32_t tProfileTime);
+	void CollectCaches(C4AulScriptFunc *pFunc);
 	void CollectTimes(C4PropListStatic * p);
 	void CollectTimes();
 	static void ResetTimes(C4PropListStatic * p);
@@ -255,6 +280,7 @@ private:
 	void Show();
 public:
 	static void Abort() { AulExec.StopProfiling(); }
+	static bool IsRunning() { return AulExec.IsProfiling(); }
 	static void StartProfiling(C4ScriptHost *pScript); // reset times and start collecting new ones
 	static void StopProfiling(); // stop the profiler and displays results
 };
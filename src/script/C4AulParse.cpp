@@ -599,6 +599,11 @@ static const char * GetTTName(C4AulBCCType e)
 	case AB_CONDN: return "CONDN";    // conditional jump (negated, pops stack)
 	case AB_COND: return "COND";    // conditional jump (pops stack)
 	case AB_FOREACH_NEXT: return "FOREACH_NEXT"; // foreach: next element
+	case AB_DUP_PROP: return "DUP_PROP";
+	case AB_INT_CMP_CONDN: return "INT_CMP_CONDN";
+	case AB_PROP_SET_POP: return "PROP_SET_POP";
+	case AB_STACK_FUNC: return "STACK_FUNC";
+	case AB_STACK_CALL: return "STACK_CALL";
 	case AB_RETURN: return "RETURN";  // return statement
 	case AB_ERR: return "ERR";      // parse error at this position
 	case AB_DEBUG: return "DEBUG";      // debug break
@@ -635,7 +640,7 @@ void C4AulScriptFunc::DumpByteCode()
 				fprintf(stderr, "\t%s\n", bcc.Par.f->GetFullName().getData()); break;
 			case AB_ERR:
 				if (bcc.Par.s)
-			case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+			case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET: case AB_PROP_SET_POP:
 				fprintf(stderr, "\t%s\n", bcc.Par.s->GetCStr()); break;
 			case AB_STRING:
 			{
@@ -721,7 +726,8 @@ bool C4ScriptHost::Preparse()
 	IncludesResolved = false;
 
 	// Parse will write the properties back after the ones from included scripts
-	GetPropList()->Properties.Swap(&LocalValues);
+	GetPropList()->MakeDictionary().Swap(&LocalValues);
+	GetPropList()->InvalidateInlineCaches();
 
 	// return success
 	this->State = ASS_PREPARSED;
@@ -1723,7 +1729,7 @@ void C4ScriptHost::CopyPropList(C4Set<C4Property> & from, C4PropListStatic * to)
 					if (!p || p->GetParent() != to)
 					{
 						p = C4PropList::NewStatic(nullptr, to, prop->Key);
-						CopyPropList(prop->Value._getPropList()->Properties, p);
+						CopyPropList(prop->Value._getPropList()->MakeDictionary(), p);
 					}
 				to->SetPropertyByS(prop->Key, C4VPropList(p));
 			}
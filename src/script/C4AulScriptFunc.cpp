@@ -76,6 +76,7 @@ void C4AulScriptFunc::ClearCode()
 {
 	Code.clear();
 	PosForCode.clear();
+	InlineCaches.clear();
 	// This function is now broken until an AddBCC call
 }
 
@@ -86,6 +86,14 @@ enum C4AulBCCType : int
 	AB_CONDN,   // conditional jump (negated, pops stack)
 	AB_COND,    // conditional jump (pops stack)
 	AB_FOREACH_NEXT, // foreach: next element
+
+// superinstructions: replace the first chunk of a sequence, the others remain as operands
+	AB_DUP_PROP, // DUP, PROP
+	AB_INT_CMP_CONDN, // INT, comparison, CONDN
+	AB_PROP_SET_POP, // PROP_SET, STACK (pop)
+	AB_STACK_FUNC, // STACK (push), FUNC
+	AB_STACK_CALL, // STACK (push), CALL or CALLFS
+
 	AB_RETURN,  // return statement
 	AB_ERR,     // parse error at this position
 	AB_DEBUG,   // debug break
@@ -97,6 +105,7 @@ class C4AulBCC
 {
 public:
 	C4AulBCCType bccType{AB_EOFN}; // chunk type
+	int32_t Cache{-1}; // index of the inline cache in the function, if any
 	union
 	{
 		intptr_t X;
@@ -111,16 +120,17 @@ public:
 	{
 		IncRef();
 	}
-	C4AulBCC(const C4AulBCC & from): C4AulBCC(from.bccType, from.Par.X) { }
+	C4AulBCC(const C4AulBCC & from): C4AulBCC(from.bccType, from.Par.X) { Cache = from.Cache; }
 	C4AulBCC & operator = (const C4AulBCC & from)
 	{
 		DecRef();
 		bccType = from.bccType;
+		Cache = from.Cache;
 		Par = from.Par;
 		IncRef();
 		return *this;
 	}
-	C4AulBCC(C4AulBCC && from): bccType(from.bccType), Par(from.Par)
+	C4AulBCC(C4AulBCC && from): bccType(from.bccType), Cache(from.Cache), Par(from.Par)
 	{
 		from.bccType = AB_EOFN;
 	}
@@ -128,6 +138,7 @@ public:
 	{
 		DecRef();
 		bccType = from.bccType;
+		Cache = from.Cache;
 		Par = from.Par;
 		from.bccType = AB_EOFN;
 		return *this;
@@ -143,7 +154,7 @@ private:
 		{
 		case AB_ERR:
 			if (Par.s)
-		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET: case AB_PROP_SET_POP:
 			Par.s->IncRef();
 			break;
 		case AB_CARRAY:
@@ -158,7 +169,7 @@ private:
 		{
 		case AB_ERR:
 			if (Par.s)
-		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET:
+		case AB_STRING: case AB_CALL: case AB_CALLFS: case AB_LOCALN: case AB_LOCALN_SET: case AB_PROP: case AB_PROP_SET: case AB_PROP_SET_POP:
 			Par.s->DecRef();
 			break;
 		case AB_CARRAY:
@@ -169,6 +180,26 @@ private:
 	}
 };
 
+class C4Property;
+
+// Inline cache of a property access or method call site. Remembers where the
+// property was found for the last receivers: among their own properties, or
+// inherited from their prototype.
+struct C4AulInlineCache
+{
+	static const int Ways = 4;
+	struct Entry
+	{
+		const C4PropList *Prototype; // prototype of the receiver
+		const C4Value *Found; // nullptr if no proplist in the chain has the property
+		uint32_t Version; // C4PropList::PrototypeVersion when recorded, 0 for unused entries
+	};
+	Entry Entries[Ways] = {}; // most recently recorded first
+	int32_t Slot{-1}; // slot in the own property table of a receiver
+	uint32_t Shape{0}; // id of the shape of the last receiver without the property
+	uint32_t Hits{0}, Misses{0};
+};
+
 // script function class
 class C4AulScriptFunc : public C4AulFunc
 {
@@ -220,6 +251,7 @@ public:
 	C4AulBCC * GetCode();
 
 	uint32_t tProfileTime; // internally set by profiler
+	std::vector<C4AulInlineCache> InlineCaches; // referenced by C4AulBCC::Cache
 
 	friend class C4AulCompiler;
 	friend class C4AulParse;
@@ -21,6 +21,7 @@
 #include "control/C4Record.h"
 #include "object/C4GameObjects.h"
 #include "script/C4Aul.h"
+#include "script/C4AulScriptFunc.h"
 
 void C4PropList::AddRef(C4Value *pRef)
 {
@@ -249,13 +250,70 @@ const char *C4PropListStatic::GetName() const
 }
 
 C4PropList::C4PropList(C4PropList * prototype):
-		prototype(prototype)
+		Shape(UseShapes ? C4PropListShape::GetRoot() : nullptr), prototype(prototype)
 {
+	if (Shape)
+		Shape->IncRef();
+	else
+		Dictionary.reset(new C4Set<C4Property>);
 #ifdef _DEBUG
 	PropLists.Add(this);
 #endif
 }
 
+uint32_t C4PropList::PrototypeVersion = 1;
+bool C4PropList::UseShapes = true;
+
+uint32_t C4PropListShape::NextId = 1;
+size_t C4PropListShape::Count = 0;
+
+C4PropListShape::C4PropListShape(C4PropListShape *parent, C4String *k):
+		Parent(parent), ParentKey(k), Id(NextId++)
+{
+	++Count;
+	if (!parent) return;
+	// Adding to a copy of the parent table gives the layout a proplist adding k would get
+	Slots = parent->Slots;
+	Slots.Add(C4Property(k, C4VInt(parent->GetSize())));
+	parent->IncRef();
+	parent->Children[k] = this;
+}
+
+C4PropListShape::~C4PropListShape()
+{
+	assert(Children.empty());
+	--Count;
+	if (!Parent) return;
+	Parent->Children.erase(ParentKey);
+	Parent->DecRef();
+}
+
+C4PropListShape *C4PropListShape::GetRoot()
+{
+	// Never deleted, so that proplists destroyed during static destruction can still release it
+	static C4PropListShape *root = []
+	{
+		C4PropListShape *r = new C4PropListShape(nullptr, nullptr);
+		r->IncRef();
+		return r;
+	}();
+	return root;
+}
+
+C4PropListShape *C4PropListShape::GetChild(C4String *k)
+{
+	auto child = Children.find(k);
+	C4PropListShape *r = child != Children.end() ? child->second : new C4PropListShape(this, k);
+	r->IncRef();
+	return r;
+}
+
+void C4PropListShape::DecRef()
+{
+	assert(RefCnt);
+	if (!--RefCnt) delete this;
+}
+
 void C4PropList::ThawRecursively()
 {
 	//thaw self and all owned properties
@@ -285,7 +343,7 @@ C4PropListStatic *C4PropList::FreezeAndMakeStaticRecursively(std::vector<C4Value
 	{
 		// Make self static by creating a copy and replacing all references
 		this_static = NewStatic(GetPrototype(), parent, key);
-		this_static->Properties.Swap(&Properties); // grab properties
+		this_static->SwapProperties(*this); // grab properties
 		this_static->Status = Status;
 		RefSet pre_freeze_refs{Refs}; // copy to avoid iterator validity headaches
 		C4Value holder = C4VPropList(this); // add another reference to prevent premature deletion
@@ -320,18 +378,18 @@ C4PropListStatic *C4PropList::FreezeAndMakeStaticRecursively(std::vector<C4Value
 
 void C4PropList::Denumerate(C4ValueNumbers * numbers)
 {
-	const C4Property * p = Properties.First();
-	while (p)
-	{
-		const_cast<C4Value &>(p->Value).Denumerate(numbers);
-		p = Properties.Next(p);
-	}
+	const C4Set<C4Property> &table = GetPropertyTable();
+	for (const C4Property *p = table.First(); p; p = table.Next(p))
+		GetValue(*p).Denumerate(numbers);
 	prototype.Denumerate(numbers);
 	RemoveCyclicPrototypes();
+	InvalidateInlineCaches();
 }
 
 C4PropList::~C4PropList()
 {
+	InvalidateInlineCaches();
+	if (Shape) Shape->DecRef();
 	for (C4Value * Ref : Refs)
 	{
 		// Manually kill references so DelRef doesn't destroy us again
@@ -350,15 +408,16 @@ bool C4PropList::operator==(const C4PropList &b) const
 	// every numbered proplist has a unique number and is only identical to itself
 	if (this == &b) return true;
 	if (IsNumbered() || b.IsNumbered()) return false;
-	if (Properties.GetSize() != b.Properties.GetSize()) return false;
+	const C4Set<C4Property> &table = GetPropertyTable();
+	if (table.GetSize() != b.GetPropertyTable().GetSize()) return false;
 	if (GetDef() != b.GetDef()) return false;
-	const C4Property * p = Properties.First();
+	const C4Property * p = table.First();
 	while (p)
 	{
-		const C4Property & bp = b.Properties.Get(p->Key);
-		if (!bp) return false;
-		if (p->Value != bp.Value) return false;
-		p = Properties.Next(p);
+		const C4Value *bv = b.GetOwnValue(p->Key);
+		if (!bv) return false;
+		if (GetValue(*p) != *bv) return false;
+		p = table.Next(p);
 	}
 	return true;
 }
@@ -368,6 +427,7 @@ void C4PropList::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	bool oldFormat = false;
 	// constant proplists are not serialized to savegames, but recreated from the game data instead
 	assert(!constant);
+	InvalidateInlineCaches();
 	if (pComp->isDeserializer() && pComp->hasNaming())
 	{
 		// backwards compat to savegames and scenarios before 5.5
@@ -385,13 +445,74 @@ void C4PropList::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 	else
 		pComp->Value(mkParAdapt(prototype, numbers));
 	pComp->Separator(StdCompiler::SEP_SEP2);
-	pComp->Value(mkParAdapt(Properties, numbers));
+	if (Shape && (!pComp->isDeserializer() || !Shape->GetSize()))
+		CompilePropertiesFunc(pComp, numbers);
+	else
+		// Reading into a table with leftovers of earlier properties must keep its capacity
+		pComp->Value(mkParAdapt(MakeDictionary(), numbers));
 	if (oldFormat)
 	{
-		if (Properties.Has(&::Strings.P[P_Prototype]))
+		if (C4Value *old_prototype = GetOwnValue(&::Strings.P[P_Prototype]))
 		{
-			prototype = Properties.Get(&::Strings.P[P_Prototype]).Value;
-			Properties.Remove(&::Strings.P[P_Prototype]);
+			prototype = *old_prototype;
+			MakeDictionary().Remove(&::Strings.P[P_Prototype]);
+		}
+	}
+}
+
+void C4PropList::CompilePropertiesFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
+{
+	// Same format as C4Set<C4Property>::CompileFunc, but the values are compiled
+	// in place because value numbering remembers their addresses
+	bool fNaming = pComp->hasNaming();
+	if (pComp->isDeserializer())
+	{
+		uint32_t iSize;
+		if (!fNaming) pComp->Value(iSize);
+		do
+		{
+			if (!fNaming && !iSize--)
+				break;
+			try
+			{
+				StdStrBuf s;
+				pComp->Value(s);
+				C4String *k = ::Strings.RegString(s);
+				C4RefCntPointer<C4String> key_ref(k);
+				pComp->Separator(StdCompiler::SEP_SET);
+				C4Value v;
+				pComp->Value(mkParAdapt(v, numbers));
+				if (C4Value *own = GetOwnValue(k))
+					*own = std::move(v);
+				else
+					AddProperty(k, v);
+			}
+			catch (StdCompiler::NotFoundException *pEx)
+			{
+				delete pEx;
+				break;
+			}
+		}
+		while (pComp->Separator(StdCompiler::SEP_SEP));
+		Values.shrink_to_fit();
+	}
+	else
+	{
+		const C4Set<C4Property> &table = GetPropertyTable();
+		if (!fNaming)
+		{
+			int32_t iSize = table.GetSize();
+			pComp->Value(iSize);
+		}
+		const C4Property * p = table.First();
+		while (p)
+		{
+			StdStrBuf s(p->Key->GetData());
+			pComp->Value(s);
+			pComp->Separator(StdCompiler::SEP_SET);
+			pComp->Value(mkParAdapt(GetValue(*p), numbers));
+			p = table.Next(p);
+			if (p) pComp->Separator(StdCompiler::SEP_SEP);
 		}
 	}
 }
@@ -487,7 +608,7 @@ void C4Property::CompileFunc(StdCompiler *pComp, C4ValueNumbers * numbers)
 void C4PropList::AppendDataString(StdStrBuf * out, const char * delim, int depth, bool ignore_reference_parent) const
 {
 	StdStrBuf & DataString = *out;
-	if (depth <= 0 && Properties.GetSize())
+	if (depth <= 0 && GetPropertyTable().GetSize())
 	{
 		DataString.Append("...");
 		return;
@@ -501,20 +622,20 @@ void C4PropList::AppendDataString(StdStrBuf * out, const char * delim, int depth
 		has_elements = true;
 	}
 	// Append other properties
-	std::list<const C4Property *> sorted_props = Properties.GetSortedListOfElementPointers();
+	std::list<const C4Property *> sorted_props = GetPropertyTable().GetSortedListOfElementPointers();
 	for (std::list<const C4Property *>::const_iterator p = sorted_props.begin(); p != sorted_props.end(); ++p)
 	{
 		if (has_elements) DataString.Append(delim);
 		DataString.Append((*p)->Key->GetData());
 		DataString.Append(" = ");
-		DataString.Append((*p)->Value.GetDataString(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
+		DataString.Append(GetValue(**p).GetDataString(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
 		has_elements = true;
 	}
 }
 
 StdStrBuf C4PropList::ToJSON(int depth, bool ignore_reference_parent) const
 {
-	if (depth <= 0 && Properties.GetSize())
+	if (depth <= 0 && GetPropertyTable().GetSize())
 	{
 		throw new C4JSONSerializationError("maximum depth reached");
 	}
@@ -529,13 +650,13 @@ StdStrBuf C4PropList::ToJSON(int depth, bool ignore_reference_parent) const
 		has_elements = true;
 	}
 	// Append other properties
-	std::list<const C4Property *> sorted_props = Properties.GetSortedListOfElementPointers();
+	std::list<const C4Property *> sorted_props = GetPropertyTable().GetSortedListOfElementPointers();
 	for (std::list<const C4Property *>::const_iterator p = sorted_props.begin(); p != sorted_props.end(); ++p)
 	{
 		if (has_elements) DataString.Append(",");
 		DataString.Append(C4Value((*p)->Key).ToJSON());
 		DataString.Append(":");
-		DataString.Append((*p)->Value.ToJSON(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
+		DataString.Append(GetValue(**p).ToJSON(depth - 1, ignore_reference_parent ? IsStatic() : nullptr));
 		has_elements = true;
 	}
 	DataString.Append("}");
@@ -545,7 +666,7 @@ StdStrBuf C4PropList::ToJSON(int depth, bool ignore_reference_parent) const
 std::vector< C4String * > C4PropList::GetSortedLocalProperties(bool add_prototype) const
 {
 	// return property list without descending into prototype
-	std::list<const C4Property *> sorted_props = Properties.GetSortedListOfElementPointers();
+	std::list<const C4Property *> sorted_props = GetPropertyTable().GetSortedListOfElementPointers();
 	std::vector< C4String * > result;
 	result.reserve(sorted_props.size() + add_prototype);
 	if (add_prototype) result.push_back(&::Strings.P[P_Prototype]); // implicit prototype for every prop list
@@ -558,7 +679,8 @@ std::vector< C4String * > C4PropList::GetSortedLocalProperties(const char *prefi
 	// return property list without descending into prototype
 	// ignore properties that have been overridden by proplist given in ignore_overridden or any of its prototypes up to and excluding this
 	std::vector< C4String * > result;
-	for (const C4Property *pp = Properties.First(); pp; pp = Properties.Next(pp))
+	const C4Set<C4Property> &table = GetPropertyTable();
+	for (const C4Property *pp = table.First(); pp; pp = table.Next(pp))
 		if (pp->Key != &::Strings.P[P_Prototype])
 			if (!prefix || pp->Key->GetData().BeginsWith(prefix))
 			{
@@ -588,7 +710,8 @@ std::vector< C4String * > C4PropList::GetUnsortedProperties(const char *prefix,
 	const C4PropList *p = this;
 	do
 	{
-		for (const C4Property *pp = p->Properties.First(); pp; pp = p->Properties.Next(pp))
+		const C4Set<C4Property> &table = p->GetPropertyTable();
+		for (const C4Property *pp = table.First(); pp; pp = table.Next(pp))
 			if (pp->Key != &::Strings.P[P_Prototype])
 				if (!prefix || pp->Key->GetData().BeginsWith(prefix))
 					result.push_back(pp->Key);
@@ -725,9 +848,9 @@ unsigned int C4Set<C4Property>::Hash<C4Property>(C4Property const & p)
 
 bool C4PropList::GetPropertyByS(const C4String * k, C4Value *pResult) const
 {
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		*pResult = Properties.Get(k).Value;
+		*pResult = *own;
 		return true;
 	}
 	else if (k == &Strings.P[P_Prototype])
@@ -744,9 +867,9 @@ bool C4PropList::GetPropertyByS(const C4String * k, C4Value *pResult) const
 C4String * C4PropList::GetPropertyStr(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		return Properties.Get(k).Value.getStr();
+		return own->getStr();
 	}
 	if (GetPrototype())
 	{
@@ -758,9 +881,9 @@ C4String * C4PropList::GetPropertyStr(C4PropertyName n) const
 C4ValueArray * C4PropList::GetPropertyArray(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		return Properties.Get(k).Value.getArray();
+		return own->getArray();
 	}
 	if (GetPrototype())
 	{
@@ -769,12 +892,50 @@ C4ValueArray * C4PropList::GetPropertyArray(C4PropertyName n) const
 	return nullptr;
 }
 
+const C4Value *C4PropList::GetPropertyCached(const C4String *k, C4AulInlineCache &cache) const
+{
+	// The receiver has the property itself, in the same slot as the last one
+	const C4Set<C4Property> &table = GetPropertyTable();
+	const C4Property *own = table.GetSlot(cache.Slot);
+	if (own && own->Key == k)
+	{
+		++cache.Hits;
+		return &GetValue(*own);
+	}
+	// Inherited from a known prototype, and no proplist in its chain changed since
+	for (const C4AulInlineCache::Entry &entry : cache.Entries)
+		if (entry.Version == PrototypeVersion && entry.Prototype == GetPrototype())
+		{
+			// Receivers sharing the shape of one without the property don't have it either
+			if ((!Shape || Shape->GetId() != cache.Shape) && table.Has(k)) break;
+			++cache.Hits;
+			return entry.Found;
+		}
+	++cache.Misses;
+	const C4Property &prop = table.Get(k);
+	if (prop)
+	{
+		cache.Slot = table.GetSlotIndex(&prop);
+		return &GetValue(prop);
+	}
+	cache.Shape = Shape ? Shape->GetId() : 0;
+	const C4Value *found = nullptr;
+	for (const C4PropList *p = GetPrototype(); p && !found; p = p->GetPrototype())
+	{
+		p->cached_as_prototype = true;
+		found = p->GetOwnValue(k);
+	}
+	std::copy_backward(cache.Entries, cache.Entries + C4AulInlineCache::Ways - 1, cache.Entries + C4AulInlineCache::Ways);
+	cache.Entries[0] = { GetPrototype(), found, PrototypeVersion };
+	return found;
+}
+
 C4AulFunc * C4PropList::GetFunc(C4String * k) const
 {
 	assert(k);
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		return Properties.Get(k).Value.getFunction();
+		return own->getFunction();
 	}
 	if (GetPrototype())
 	{
@@ -824,9 +985,9 @@ C4Value C4PropList::Call(const char * s, C4AulParSet *Pars, bool fPassErrors)
 C4PropertyName C4PropList::GetPropertyP(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		C4String * v = Properties.Get(k).Value.getStr();
+		C4String * v = own->getStr();
 		if (v >= &Strings.P[0] && v < &Strings.P[P_LAST])
 			return C4PropertyName(v - &Strings.P[0]);
 		return P_LAST;
@@ -841,9 +1002,9 @@ C4PropertyName C4PropList::GetPropertyP(C4PropertyName n) const
 int32_t C4PropList::GetPropertyBool(C4PropertyName n, bool default_val) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		return Properties.Get(k).Value.getBool();
+		return own->getBool();
 	}
 	if (GetPrototype())
 	{
@@ -855,9 +1016,9 @@ int32_t C4PropList::GetPropertyBool(C4PropertyName n, bool default_val) const
 int32_t C4PropList::GetPropertyInt(C4PropertyName n, int32_t default_val) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		return Properties.Get(k).Value.getInt();
+		return own->getInt();
 	}
 	if (GetPrototype())
 	{
@@ -869,9 +1030,9 @@ int32_t C4PropList::GetPropertyInt(C4PropertyName n, int32_t default_val) const
 C4PropList *C4PropList::GetPropertyPropList(C4PropertyName n) const
 {
 	C4String * k = &Strings.P[n];
-	if (Properties.Has(k))
+	if (const C4Value *own = GetOwnValue(k))
 	{
-		return Properties.Get(k).Value.getPropList();
+		return own->getPropList();
 	}
 	if (GetPrototype())
 	{
@@ -889,14 +1050,15 @@ C4ValueArray * C4PropList::GetProperties() const
 	{
 		a = GetPrototype()->GetProperties();
 		i = a->GetSize();
-		a->SetSize(i + Properties.GetSize());
+		a->SetSize(i + GetPropertyTable().GetSize());
 	}
 	else
 	{
-		a = new C4ValueArray(Properties.GetSize());
+		a = new C4ValueArray(GetPropertyTable().GetSize());
 		i = 0;
 	}
-	const C4Property * p = Properties.First();
+	const C4Set<C4Property> &table = GetPropertyTable();
+	const C4Property * p = table.First();
 	while (p)
 	{
 		C4String *newPropertyName = p->Key;
@@ -917,7 +1079,7 @@ C4ValueArray * C4PropList::GetProperties() const
 			(*a)[i++] = C4VString(newPropertyName);
 			assert(((*a)[i - 1].GetType() == C4V_String) && "Proplist key is non-string");
 		}
-		p = Properties.Next(p);
+		p = table.Next(p);
 	}
 	// We might have added less properties than initially intended.
 	if (hasInheritedProperties)
@@ -927,12 +1089,13 @@ C4ValueArray * C4PropList::GetProperties() const
 
 C4String * C4PropList::EnumerateOwnFuncs(C4String * prev) const
 {
-	const C4Property * p = prev ? Properties.Next(&Properties.Get(prev)) : Properties.First();
+	const C4Set<C4Property> &table = GetPropertyTable();
+	const C4Property * p = prev ? table.Next(&table.Get(prev)) : table.First();
 	while (p)
 	{
-		if (p->Value.getFunction())
+		if (GetValue(*p).getFunction())
 			return p->Key;
-		p = Properties.Next(p);
+		p = table.Next(p);
 	}
 	return nullptr;
 }
@@ -947,14 +1110,16 @@ void C4PropList::SetPropertyByS(C4String * k, const C4Value & to)
 			if(it == this)
 				throw C4AulExecError("Trying to create cyclic prototype structure");
 		prototype.SetPropList(newpt);
+		InvalidateInlineCaches();
 	}
-	else if (Properties.Has(k))
+	else if (C4Value *own = GetOwnValue(k))
 	{
-		Properties.Get(k).Value = to;
+		*own = to;
 	}
 	else
 	{
-		Properties.Add(C4Property(k, to));
+		AddProperty(k, to);
+		InvalidateInlineCaches();
 	}
 }
 
@@ -962,8 +1127,65 @@ void C4PropList::ResetProperty(C4String * k)
 {
 	if (k == &Strings.P[P_Prototype])
 		prototype.Set0();
+	else if (GetOwnValue(k))
+		MakeDictionary().Remove(k);
+	InvalidateInlineCaches();
+}
+
+void C4PropList::AddProperty(C4String *k, const C4Value &to)
+{
+	if (Shape && Shape->GetSize() < C4PropListShape::MaxSize)
+	{
+		C4PropListShape *next = Shape->GetChild(k);
+		Shape->DecRef();
+		Shape = next;
+		Values.push_back(to);
+	}
 	else
-		Properties.Remove(k);
+		MakeDictionary().Add(C4Property(k, to));
+}
+
+void C4PropList::ClearProperties()
+{
+	if (Shape && Shape->GetSize())
+	{
+		// The table of a proplist keeps its size when cleared, which decides the order of
+		// properties added later. Only an empty proplist can start over at the root shape.
+		MakeDictionary();
+	}
+	if (Shape)
+	{
+		// values might hold the last reference to proplists which clear this one
+		std::vector<C4Value> old_values;
+		old_values.swap(Values);
+	}
+	else
+		Dictionary->Clear();
+}
+
+void C4PropList::SwapProperties(C4PropList &other)
+{
+	std::swap(Shape, other.Shape);
+	Values.swap(other.Values);
+	Dictionary.swap(other.Dictionary);
+	InvalidateInlineCaches();
+	other.InvalidateInlineCaches();
+}
+
+C4Set<C4Property> &C4PropList::MakeDictionary()
+{
+	if (!Shape) return *Dictionary;
+	// Copying the slot table copies its layout, and with it the order of the properties
+	std::unique_ptr<C4Set<C4Property> > table(new C4Set<C4Property>(Shape->GetSlots()));
+	for (const C4Property *p = table->First(); p; p = table->Next(p))
+		const_cast<C4Property *>(p)->Value = std::move(Values[p->Value._getInt()]);
+	Dictionary = std::move(table);
+	Values.clear();
+	Values.shrink_to_fit();
+	Shape->DecRef();
+	Shape = nullptr;
+	InvalidateInlineCaches();
+	return *Dictionary;
 }
 
 void C4PropList::Iterator::Init()
@@ -976,20 +1198,19 @@ void C4PropList::Iterator::Reserve(size_t additionalAmount)
 	properties->reserve(properties->size() + additionalAmount);
 }
 
-void C4PropList::Iterator::AddProperty(const C4Property * prop)
+void C4PropList::Iterator::AddProperty(C4String *key, const C4Value &value)
 {
-	std::vector<const C4Property*>::size_type i = 0, len = properties->size();
+	std::vector<Property>::size_type i = 0, len = properties->size();
 	for(;i < len; ++i)
 	{
-		const C4Property *oldProperty = (*properties)[i];
-		if (oldProperty->Key == prop->Key)
+		if ((*properties)[i].first == key)
 		{
-			(*properties)[i] = prop;
+			(*properties)[i].second = &value;
 			return;
 		}
 	}
 	// not already in vector?
-	properties->push_back(prop);
+	properties->emplace_back(key, &value);
 }
 
 C4PropList::Iterator C4PropList::begin()
@@ -1002,15 +1223,16 @@ C4PropList::Iterator C4PropList::begin()
 	}
 	else
 	{
-		iter.properties = std::make_shared<std::vector<const C4Property*> >();
+		iter.properties = std::make_shared<std::vector<Iterator::Property> >();
 	}
-	iter.Reserve(Properties.GetSize());
+	const C4Set<C4Property> &table = GetPropertyTable();
+	iter.Reserve(table.GetSize());
 
-	const C4Property * p = Properties.First();
+	const C4Property * p = table.First();
 	while (p)
 	{
-		iter.AddProperty(p);
-		p = Properties.Next(p);
+		iter.AddProperty(p->Key, GetValue(*p));
+		p = table.Next(p);
 	}
 
 	iter.Init();
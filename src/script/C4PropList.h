@@ -63,11 +63,50 @@ inline bool C4Set<C4Property>::Equals(const C4Property &a, const C4Property &b)
 	return a.Key == b.Key;
 }
 
+// Key set shared by all proplists that got the same properties added in the
+// same order, mapping each key to an index into the value vector of such a
+// proplist. The slot table has exactly the layout the property table of such
+// a proplist would have, so iterating over it yields the same order.
+class C4PropListShape
+{
+public:
+	static const unsigned int MaxSize = 32; // proplists with more properties use a table of their own
+
+	static C4PropListShape *GetRoot(); // the empty shape
+	// The shape with one more key. Shared by all proplists adding this key here.
+	// Returns a new reference.
+	C4PropListShape *GetChild(C4String *k);
+	void IncRef() { ++RefCnt; }
+	void DecRef();
+
+	// index of the value of a key, -1 if it isn't part of the shape
+	int32_t GetIndex(const C4String *k) const
+	{ const C4Property &p = Slots.Get(k); return p ? p.Value._getInt() : -1; }
+	unsigned int GetSize() const { return Slots.GetSize(); }
+	const C4Set<C4Property> &GetSlots() const { return Slots; }
+	// unique for the lifetime of the process, unlike the address
+	uint32_t GetId() const { return Id; }
+	static size_t GetCount() { return Count; }
+
+private:
+	C4PropListShape(C4PropListShape *parent, C4String *k);
+	~C4PropListShape();
+	C4Set<C4Property> Slots; // the values are C4VInt indices
+	C4PropListShape *Parent; // referenced
+	C4String *ParentKey; // key added to the parent, owned by Slots
+	std::map<const C4String *, C4PropListShape *> Children; // not referenced
+	unsigned int RefCnt{0};
+	uint32_t Id;
+	static uint32_t NextId;
+	static size_t Count;
+};
+
 class C4PropListNumbered;
+struct C4AulInlineCache;
 class C4PropList
 {
 public:
-	void Clear() { constant = false; Properties.Clear(); prototype.Set0(); }
+	void Clear() { InvalidateInlineCaches(); constant = false; ClearProperties(); prototype.Set0(); }
 	virtual const char *GetName() const;
 	virtual void SetName (const char *NewName = nullptr);
 	virtual void SetOnFire(bool OnFire) { }
@@ -106,6 +145,9 @@ public:
 	{ return GetPropertyByS(&Strings.P[k], pResult); }
 	C4String * GetPropertyStr(C4PropertyName k) const;
 	C4ValueArray * GetPropertyArray(C4PropertyName n) const;
+	// Lookup for script call sites, remembering where the property was found.
+	// Only for keys GetPropertyByS doesn't handle specially. nullptr if not found.
+	const C4Value *GetPropertyCached(const C4String *k, C4AulInlineCache &cache) const;
 	C4AulFunc * GetFunc(C4PropertyName k) const
 	{ return GetFunc(&Strings.P[k]); }
 	C4AulFunc * GetFunc(C4String * k) const;
@@ -119,7 +161,7 @@ public:
 	int32_t GetPropertyBool(C4PropertyName n, bool default_val = false) const;
 	int32_t GetPropertyInt(C4PropertyName k, int32_t default_val = 0) const;
 	C4PropList *GetPropertyPropList(C4PropertyName k) const;
-	bool HasProperty(C4String * k) const { return Properties.Has(k); }
+	bool HasProperty(C4String * k) const { return GetOwnValue(k) != nullptr; }
 	// not allowed on frozen proplists
 	void SetProperty(C4PropertyName k, const C4Value & to)
 	{ SetPropertyByS(&Strings.P[k], to); }
@@ -134,6 +176,13 @@ public:
 	void ThawRecursively();
 	bool IsFrozen() const { return constant; }
 
+	// Changed whenever a proplist that inline caches looked through as a prototype
+	// changes its set of properties or its prototype
+	static uint32_t PrototypeVersion;
+
+	// Whether new proplists start out sharing shapes, or with a property table of their own
+	static bool UseShapes;
+
 	// Freeze this and all proplist in properties and ensure they are static proplists
 	// If a proplist is not static, replace it with a static proplist and replace all instances
 	// Place references to all proplists made static in the given value array
@@ -164,9 +213,37 @@ private:
 	void DelRef(C4Value *pRef);
 	typedef std::unordered_set<C4Value *> RefSet;
 	RefSet Refs;
-	C4Set<C4Property> Properties;
+	// Properties are either stored in a shape shared with other proplists plus the
+	// values of this one, or in a table of their own ("dictionary mode") once the
+	// proplist is modified in ways shapes don't support, like removing properties.
+	C4PropListShape *Shape; // referenced, nullptr in dictionary mode
+	std::vector<C4Value> Values; // by index in Shape
+	std::unique_ptr<C4Set<C4Property> > Dictionary; // only in dictionary mode
 	C4Value prototype;
 	bool constant{false}; // if true, this proplist is not changeable
+	mutable bool cached_as_prototype{false}; // inline caches depend on this proplist
+	void InvalidateInlineCaches() { if (cached_as_prototype) ++PrototypeVersion; }
+	// The own properties in table order. In shape mode, their values are indices into Values.
+	const C4Set<C4Property> &GetPropertyTable() const { return Shape ? Shape->GetSlots() : *Dictionary; }
+	const C4Value &GetValue(const C4Property &entry) const { return Shape ? Values[entry.Value._getInt()] : entry.Value; }
+	C4Value &GetValue(const C4Property &entry) { return Shape ? Values[entry.Value._getInt()] : const_cast<C4Value &>(entry.Value); }
+	const C4Value *GetOwnValue(const C4String *k) const
+	{
+		if (Shape)
+		{
+			int32_t i = Shape->GetIndex(k);
+			return i >= 0 ? &Values[i] : nullptr;
+		}
+		const C4Property &p = Dictionary->Get(k);
+		return p ? &p.Value : nullptr;
+	}
+	C4Value *GetOwnValue(const C4String *k) { return const_cast<C4Value *>(static_cast<const C4PropList *>(this)->GetOwnValue(k)); }
+	void AddProperty(C4String *k, const C4Value &to);
+	void ClearProperties();
+	void SwapProperties(C4PropList &other);
+	// Switch to dictionary mode, keeping the order of the properties
+	C4Set<C4Property> &MakeDictionary();
+	void CompilePropertiesFunc(StdCompiler *pComp, C4ValueNumbers *);
 	friend class C4Value;
 	friend class C4ScriptHost;
 public:
@@ -174,20 +251,28 @@ public:
 
 	class Iterator
 	{
+	public:
+		struct Entry
+		{
+			C4String *Key;
+			const C4Value &Value;
+			const Entry *operator->() const { return this; }
+		};
 	private:
-		std::shared_ptr<std::vector<const C4Property*> > properties;
-		std::vector<const C4Property*>::iterator iter;
+		typedef std::pair<C4String *, const C4Value *> Property;
+		std::shared_ptr<std::vector<Property> > properties;
+		std::vector<Property>::iterator iter;
 		// needed when constructing the iterator
 		// adds a property or overwrites existing property with same name
-		void AddProperty(const C4Property * prop);
+		void AddProperty(C4String *key, const C4Value &value);
 		void Reserve(size_t additionalAmount);
 		// Initializes internal iterator. Needs to be called before actually using the iterator.
 		void Init();
 	public:
 		Iterator() : properties(nullptr) { }
 
-		const C4Property * operator*() const { return *iter; }
-		const C4Property * operator->() const { return *iter; }
+		Entry operator*() const { return { iter->first, *iter->second }; }
+		Entry operator->() const { return **this; }
 		void operator++() { ++iter; };
 		void operator++(int) { operator++(); }
 
@@ -18,6 +18,7 @@
 #include "config/C4Reloc.h"
 #include "control/C4Record.h"
 #include "object/C4Def.h"
+#include "object/C4FindObject.h"
 #include "object/C4ObjectList.h"
 #include "script/C4Aul.h"
 #include "script/C4AulDebug.h"
@@ -55,6 +56,9 @@ const char * C4Config::AtRelativePath(char const*s) {return s;}
 C4AulDebug *C4AulDebug::pDebug;
 void C4AulDebug::DebugStep(C4AulBCC*,C4Value*) {}
 
+void C4FindObjectProfiler::Reset() {}
+void C4FindObjectProfiler::Show() {}
+
 C4Reloc Reloc;
 bool C4Reloc::Open(C4Group&, char const*) const { return false; }
 
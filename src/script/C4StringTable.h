@@ -250,6 +250,9 @@ public:
 			AddInternal(std::move(m));
 		}
 	}
+	// Direct access to table slots, so that callers can remember where an element was found
+	int GetSlotIndex(T const * p) const { return p - Table; }
+	T const * GetSlot(int i) const { return unsigned(i) < Capacity ? &Table[i] : nullptr; }
 	T const * First() const { return Next(Table - 1); }
 	T const * Next(T const * p) const
 	{
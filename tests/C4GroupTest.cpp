@@ -0,0 +1,148 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "c4group/C4Group.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+	const char *TestGroupName = "C4GroupTest.ocg";
+
+	std::string LoadString(C4Group &group, const char *entry_name)
+	{
+		StdStrBuf buffer;
+		if (!group.LoadEntryString(entry_name, &buffer)) return "<missing>";
+		return buffer.getData();
+	}
+}
+
+TEST(C4GroupTest, IndexedFormatRoundTrip)
+{
+	EraseItem(TestGroupName);
+	StdStrBuf alpha("Alpha"), beta, gamma("Gamma"), delta("Delta");
+	for (int i = 0; i < 1000; ++i) beta.AppendFormat("Beta %d\n", i % 10);
+
+	// Create a stream group with a child group and convert it
+	{
+		C4Group group;
+		ASSERT_TRUE(group.Open(TestGroupName, true));
+		ASSERT_TRUE(group.Add("Alpha.txt", alpha));
+		ASSERT_TRUE(group.Add("Beta.txt", beta));
+		C4Group child;
+		ASSERT_TRUE(child.OpenAsChild(&group, "Child.ocg", false, true));
+		ASSERT_TRUE(child.Add("Gamma.txt", gamma));
+		ASSERT_TRUE(child.Close());
+		EXPECT_EQ(C4GF_Stream, group.GetFormat());
+		ASSERT_TRUE(group.SetFormat(C4GF_Indexed));
+		ASSERT_TRUE(group.Close());
+	}
+	EXPECT_TRUE(C4Group_IsIndexedGroupFile(TestGroupName));
+
+	// Random access and modification of a child
+	{
+		C4Group group;
+		ASSERT_TRUE(group.Open(TestGroupName));
+		EXPECT_EQ(C4GF_Indexed, group.GetFormat());
+		EXPECT_EQ(beta.getData(), LoadString(group, "Beta.txt"));
+		EXPECT_EQ("Alpha", LoadString(group, "alpha.TXT"));
+		EXPECT_EQ(beta.getData(), LoadString(group, "B*.txt"));
+		C4Group child;
+		ASSERT_TRUE(child.OpenAsChild(&group, "Child.ocg"));
+		EXPECT_EQ(C4GF_Indexed, child.GetFormat());
+		EXPECT_EQ("Gamma", LoadString(child, "Gamma.txt"));
+		ASSERT_TRUE(child.Add("Delta.txt", delta));
+		ASSERT_TRUE(child.Close());
+		ASSERT_TRUE(group.Close());
+	}
+	{
+		C4Group child;
+		ASSERT_TRUE(child.Open(FormatString("%s%cChild.ocg", TestGroupName, DirectorySeparator).getData()));
+		EXPECT_EQ(C4GF_Indexed, child.GetFormat());
+		EXPECT_EQ("Delta", LoadString(child, "Delta.txt"));
+		EXPECT_EQ("Gamma", LoadString(child, "Gamma.txt"));
+	}
+
+	// Convert back
+	{
+		C4Group group;
+		ASSERT_TRUE(group.Open(TestGroupName));
+		ASSERT_TRUE(group.SetFormat(C4GF_Stream));
+		ASSERT_TRUE(group.Close());
+	}
+	EXPECT_FALSE(C4Group_IsIndexedGroupFile(TestGroupName));
+	{
+		C4Group group, child;
+		ASSERT_TRUE(group.Open(TestGroupName));
+		EXPECT_EQ(C4GF_Stream, group.GetFormat());
+		EXPECT_EQ("Alpha", LoadString(group, "Alpha.txt"));
+		ASSERT_TRUE(child.OpenAsChild(&group, "Child.ocg"));
+		EXPECT_EQ("Gamma", LoadString(child, "Gamma.txt"));
+		EXPECT_EQ("Delta", LoadString(child, "Delta.txt"));
+	}
+	EraseItem(TestGroupName);
+}
+
+TEST(C4GroupTest, LoadEntryView)
+{
+	EraseItem(TestGroupName);
+	StdBuf large;
+	large.New(C4GroupMapThreshold * 2);
+	// Incompressible, so indexed groups store it as is
+	uint32_t seed = 1;
+	for (size_t i = 0; i < large.getSize(); ++i) static_cast<BYTE *>(large.getMData())[i] = BYTE((seed = seed * 1103515245 + 12345) >> 16);
+	StdStrBuf small("Small");
+
+	// Unpacked folder
+	ASSERT_TRUE(CreatePath(TestGroupName));
+	{
+		C4Group group;
+		ASSERT_TRUE(group.Open(TestGroupName));
+		ASSERT_TRUE(group.Add("Large.bin", large));
+		ASSERT_TRUE(group.Add("Small.txt", small));
+		ASSERT_TRUE(group.Close());
+	}
+	ASSERT_TRUE(DirectoryExists(TestGroupName));
+	for (C4GroupFormat format : { C4GF_Stream, C4GF_Indexed })
+	{
+		C4Group group;
+		ASSERT_TRUE(group.Open(TestGroupName));
+		StdBuf view;
+		ASSERT_TRUE(group.LoadEntryView("Large.bin", &view));
+		EXPECT_EQ(large, view);
+#ifdef HAVE_SYS_MMAN_H
+		EXPECT_TRUE(view.isRef());
+#endif
+		ASSERT_TRUE(group.LoadEntryView("S*.txt", &view));
+		EXPECT_EQ(0, std::memcmp(small.getData(), view.getData(), view.getSize()));
+		EXPECT_FALSE(group.LoadEntryView("Missing.bin", &view));
+		ASSERT_TRUE(group.Close());
+		// Pack and check again
+		ASSERT_TRUE(C4Group_PackDirectory(TestGroupName));
+		ASSERT_TRUE(group.Open(TestGroupName));
+		ASSERT_TRUE(group.SetFormat(format));
+		ASSERT_TRUE(group.Close());
+		ASSERT_TRUE(group.Open(TestGroupName));
+		ASSERT_TRUE(group.LoadEntryView("Large.bin", &view));
+		EXPECT_EQ(large, view);
+#ifdef HAVE_SYS_MMAN_H
+		EXPECT_EQ(format == C4GF_Indexed, view.isRef());
+#endif
+		ASSERT_TRUE(group.Close());
+		ASSERT_TRUE(C4Group_UnpackDirectory(TestGroupName));
+	}
+	EraseItem(TestGroupName);
+}
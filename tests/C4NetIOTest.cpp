@@ -17,6 +17,8 @@
 #include "network/C4NetIO.h"
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <functional>
 
 class C4NetIOTest : public ::testing::Test
 {
@@ -106,3 +108,90 @@ TEST_F(C4NetIOTest, TCPBind)
 
 	NetIO.Close();
 }
+
+// Sends packets of mixed sizes between two C4NetIOUDP instances on the loopback
+// interface and checks that they all arrive in order. Prints the throughput and
+// the number of packet buffers that had to be taken from the heap.
+TEST_F(C4NetIOTest, UDPLoopbackStress)
+{
+	static const int Rounds = 2, PacketCnt = 2000, BurstSize = 16;
+	static const size_t Sizes[] = { 8, 100, 400, 1200 }; // the larger ones are fragmented
+	typedef std::chrono::steady_clock clock;
+
+	class Receiver : public C4NetIO::CBClass
+	{
+	public:
+		bool fConn = false;
+		int iReceived = 0, iErrors = 0;
+		bool OnConn(const C4NetIO::addr_t &, const C4NetIO::addr_t &, const C4NetIO::addr_t *, C4NetIO *) override { fConn = true; return true; }
+		void OnPacket(const C4NetIOPacket &rPacket, C4NetIO *) override
+		{
+			// packet number, then its size times the number
+			int iNr = iReceived++;
+			if (rPacket.getSize() != Sizes[iNr % 4] || *getBufPtr<int>(rPacket) != iNr || *getBufPtr<uint8_t>(rPacket, rPacket.getSize() - 1) != uint8_t(iNr))
+				iErrors++;
+		}
+	} CB[2];
+
+	// find two free ports
+	C4NetIOUDP NetIO[2]; uint16_t iPorts[2];
+	for (int i = 0; i < 2; i++)
+	{
+		NetIO[i].SetCallback(&CB[i]);
+		for (iPorts[i] = 41500 + i * 50; iPorts[i] < 41550 + i * 50; iPorts[i]++)
+			if (NetIO[i].Init(iPorts[i]))
+				break;
+		ASSERT_LT(iPorts[i], 41550 + i * 50) << NetIO[i].GetError();
+	}
+	C4NetIO::addr_t addr(StdStrBuf("127.0.0.1"));
+	addr.SetPort(iPorts[1]);
+	ASSERT_TRUE(NetIO[0].Connect(addr));
+	auto pump = [&](clock::duration dur, const std::function<bool()> &done)
+	{
+		auto end = clock::now() + dur;
+		while (!done() && clock::now() < end)
+			for (auto &io : NetIO)
+				io.Execute(0);
+	};
+	pump(std::chrono::seconds(5), [&]() { return CB[0].fConn && CB[1].fConn; });
+	ASSERT_TRUE(CB[0].fConn && CB[1].fConn);
+
+	// The first round fills the buffer pool. Sent packets are kept until the
+	// receiver acknowledges them, which it does once a second, so wait for that
+	// before each measured round.
+	char Buf[1200];
+	int iSent = 0;
+	unsigned int iHeapAllocs = 0;
+	double dTime = 0;
+	for (int round = 0; round <= Rounds; round++)
+	{
+		if (round >= 1)
+			pump(std::chrono::milliseconds(1200), []() { return false; });
+		unsigned int iHeapAllocsBefore = C4NetIOUDP::GetHeapAllocCount();
+		auto start = clock::now();
+		for (int i = 0; i < PacketCnt; i += BurstSize)
+		{
+			for (int j = 0; j < BurstSize; j++, iSent++)
+			{
+				size_t iSize = Sizes[iSent % 4];
+				memset(Buf, uint8_t(iSent), iSize); *reinterpret_cast<int *>(Buf) = iSent;
+				ASSERT_TRUE(NetIO[0].Send(C4NetIOPacket(Buf, iSize, false, addr)));
+			}
+			pump(std::chrono::seconds(5), [&]() { return CB[1].iReceived == iSent; });
+		}
+		if (round >= 1)
+		{
+			dTime += std::chrono::duration<double>(clock::now() - start).count();
+			iHeapAllocs += C4NetIOUDP::GetHeapAllocCount() - iHeapAllocsBefore;
+		}
+	}
+	EXPECT_EQ(iSent, CB[1].iReceived);
+	EXPECT_EQ(0, CB[1].iErrors);
+	// a few allocations are fine, as acknowledgements arrive only once a second
+	EXPECT_LE(iHeapAllocs, unsigned(Rounds * PacketCnt / 100));
+	printf("[ BENCH    ] %d packets: %.0f packets/s, %.4f heap allocations per packet\n", Rounds * PacketCnt,
+		Rounds * PacketCnt / dTime, double(iHeapAllocs) / (Rounds * PacketCnt));
+
+	for (auto &io : NetIO)
+		io.Close();
+}
@@ -0,0 +1,329 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+#include <C4Include.h>
+#include "lib/C4SpatialGrid.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <list>
+#include <random>
+
+namespace
+{
+	struct TestObject
+	{
+		int32_t x, y, wdt, hgt;
+		uint64_t order;
+		uint32_t marker = 0;
+		C4Rect GetRect() const { return C4Rect(x - wdt / 2, y - hgt / 2, wdt, hgt); }
+	};
+
+	typedef C4SpatialGrid<TestObject> TestGrid;
+
+	const int32_t LandscapeWdt = 2000, LandscapeHgt = 1000;
+
+	std::vector<TestObject> MakeObjects(size_t count, std::mt19937 &rng)
+	{
+		std::uniform_int_distribution<int32_t> x(-50, LandscapeWdt + 50), y(-50, LandscapeHgt + 50), size(1, 120);
+		std::vector<TestObject> objects(count);
+		for (size_t i = 0; i < count; ++i)
+			objects[i] = { x(rng), y(rng), size(rng), size(rng), (i + 1) * 16 };
+		return objects;
+	}
+
+	// Objects of an area, each once, in grid order
+	std::vector<TestObject *> CollectShapes(const TestGrid &grid, const TestGrid::Area &area, uint32_t marker)
+	{
+		std::vector<TestObject *> result;
+		grid.ForEachCell(area, [&result, marker](const TestGrid::Cell &cell, int32_t, int32_t)
+		{
+			for (const TestGrid::Entry &entry : cell)
+				if (entry.Obj->marker != marker)
+				{
+					entry.Obj->marker = marker;
+					result.push_back(entry.Obj);
+				}
+		});
+		return result;
+	}
+}
+
+TEST(C4SpatialGridTest, Areas)
+{
+	TestGrid grid;
+	grid.Init(LandscapeWdt, LandscapeHgt, 50);
+	EXPECT_EQ(40, grid.GetWidth());
+	EXPECT_EQ(20, grid.GetHeight());
+	EXPECT_EQ(grid.GetOutIndex(), grid.IndexAt(-1, 0));
+	EXPECT_EQ(grid.GetOutIndex(), grid.IndexAt(0, LandscapeHgt));
+	EXPECT_EQ(41, grid.IndexAt(60, 99));
+
+	// Inside
+	TestGrid::Area area = grid.GetArea(C4Rect(10, 10, 100, 50));
+	EXPECT_EQ(0, area.x0); EXPECT_EQ(0, area.y0); EXPECT_EQ(2, area.x1); EXPECT_EQ(1, area.y1);
+	EXPECT_FALSE(area.Out);
+	EXPECT_EQ(6, area.GetCellCount());
+	// Degenerate rectangles still cover the cell they are in
+	area = grid.GetArea(C4Rect(120, 120, 0, 0));
+	EXPECT_EQ(1, area.GetCellCount());
+	EXPECT_TRUE(area.Contains(2, 2));
+	// Partially outside
+	area = grid.GetArea(C4Rect(-10, 980, 30, 30));
+	EXPECT_TRUE(area.Out);
+	EXPECT_TRUE(area.Contains(-1, -1));
+	EXPECT_TRUE(area.Contains(0, 19));
+	EXPECT_EQ(2, area.GetCellCount());
+	// Completely outside
+	area = grid.GetArea(C4Rect(LandscapeWdt + 100, 100, 20, 20));
+	EXPECT_EQ(1, area.GetCellCount());
+	EXPECT_TRUE(area.Out);
+	EXPECT_FALSE(area.IsNull());
+	// Above or left of the landscape, clipping leaves the corner cell as well
+	area = grid.GetArea(C4Rect(-100, -100, 20, 20));
+	EXPECT_EQ(2, area.GetCellCount());
+	EXPECT_TRUE(area.Contains(0, 0));
+	EXPECT_TRUE(TestGrid::Area().IsNull());
+}
+
+TEST(C4SpatialGridTest, OrderIndependentOfInsertion)
+{
+	std::mt19937 rng(4711);
+	std::vector<TestObject> objects = MakeObjects(300, rng);
+	std::vector<TestObject *> insertion_order;
+	for (TestObject &obj : objects) insertion_order.push_back(&obj);
+
+	std::vector<TestObject *> expected;
+	for (int pass = 0; pass < 3; ++pass)
+	{
+		std::shuffle(insertion_order.begin(), insertion_order.end(), rng);
+		TestGrid grid;
+		grid.Init(LandscapeWdt, LandscapeHgt, 50);
+		for (TestObject *obj : insertion_order)
+			grid.AddToArea(grid.GetArea(obj->GetRect()), obj, obj->order);
+		std::vector<TestObject *> result;
+		grid.Collect(grid.GetArea(C4Rect(-100, -100, LandscapeWdt + 200, LandscapeHgt + 200)), result);
+		// Same result for any insertion order
+		if (pass)
+			EXPECT_EQ(expected, result);
+		expected = result;
+	}
+}
+
+TEST(C4SpatialGridTest, IncrementalUpdates)
+{
+	std::mt19937 rng(1234);
+	std::vector<TestObject> objects = MakeObjects(500, rng);
+	TestGrid grid, shapes;
+	grid.Init(LandscapeWdt, LandscapeHgt, 50);
+	shapes.Init(LandscapeWdt, LandscapeHgt, 50);
+	for (TestObject &obj : objects)
+	{
+		grid.Add(grid.IndexAt(obj.x, obj.y), &obj, obj.order);
+		shapes.AddToArea(shapes.GetArea(obj.GetRect()), &obj, obj.order);
+	}
+
+	std::uniform_int_distribution<int32_t> step(-30, 30), query_pos(-100, LandscapeWdt), query_size(0, 400);
+	uint32_t marker = 0;
+	for (int frame = 0; frame < 20; ++frame)
+	{
+		// Move everything, updating only changed cells
+		for (TestObject &obj : objects)
+		{
+			int32_t old_index = grid.IndexAt(obj.x, obj.y);
+			TestGrid::Area old_area = shapes.GetArea(obj.GetRect());
+			obj.x += step(rng); obj.y += step(rng);
+			int32_t new_index = grid.IndexAt(obj.x, obj.y);
+			if (new_index != old_index)
+			{
+				ASSERT_TRUE(grid.Remove(old_index, &obj, obj.order));
+				grid.Add(new_index, &obj, obj.order);
+			}
+			TestGrid::Area new_area = shapes.GetArea(obj.GetRect());
+			if (new_area != old_area)
+				shapes.MoveArea(old_area, new_area, &obj, obj.order);
+		}
+		// Queries find exactly the objects they should
+		for (int query = 0; query < 50; ++query)
+		{
+			C4Rect rect(query_pos(rng), query_pos(rng) / 2, query_size(rng), query_size(rng));
+			TestGrid::Area area = grid.GetArea(rect);
+			std::vector<TestObject *> found;
+			grid.Collect(area, found);
+			std::vector<TestObject *> found_shapes = CollectShapes(shapes, area, ++marker);
+			for (TestObject &obj : objects)
+			{
+				int32_t index = grid.IndexAt(obj.x, obj.y);
+				bool positioned_inside = index == grid.GetOutIndex() ? area.Out : area.Contains(index % grid.GetWidth(), index / grid.GetWidth());
+				EXPECT_EQ(positioned_inside, std::count(found.begin(), found.end(), &obj) == 1);
+				if (rect.Contains(obj.x, obj.y))
+					EXPECT_TRUE(positioned_inside);
+				C4Rect obj_rect = obj.GetRect();
+				if (obj_rect.Overlap(rect))
+					EXPECT_EQ(1, std::count(found_shapes.begin(), found_shapes.end(), &obj));
+			}
+		}
+	}
+
+	// Renumbering keeps the elements sorted
+	for (TestObject &obj : objects) obj.order = UINT64_MAX - obj.order;
+	grid.UpdateOrder([](const TestObject *obj) { return obj->order; });
+	for (int32_t i = 0; i <= grid.GetOutIndex(); ++i)
+		EXPECT_TRUE(std::is_sorted(grid.GetCell(i).begin(), grid.GetCell(i).end()));
+	size_t total = grid.GetEntryCount() + grid.GetCell(grid.GetOutIndex()).size();
+	EXPECT_EQ(objects.size(), total);
+}
+
+TEST(C4SpatialGridTest, NearestFirst)
+{
+	std::mt19937 rng(815);
+	std::vector<TestObject> objects = MakeObjects(400, rng);
+	TestGrid grid;
+	grid.Init(LandscapeWdt, LandscapeHgt, 50);
+	for (TestObject &obj : objects) grid.Add(grid.IndexAt(obj.x, obj.y), &obj, obj.order);
+	auto distance = [](const TestObject *obj, int32_t x, int32_t y) { return int64_t(obj->x - x) * (obj->x - x) + int64_t(obj->y - y) * (obj->y - y); };
+
+	std::uniform_int_distribution<int32_t> query_x(-300, LandscapeWdt + 300), query_y(-300, LandscapeHgt + 300), query_size(0, 600);
+	for (int query = 0; query < 300; ++query)
+	{
+		int32_t x = query_x(rng), y = query_y(rng), wdt = query_size(rng), hgt = query_size(rng);
+		TestGrid::Area area = query % 2 ? grid.GetFullArea() : grid.GetArea(C4Rect(x - wdt / 2, y - hgt / 2, wdt, hgt));
+		// Nearest object of the area by brute force
+		int64_t expected = INT64_MAX;
+		size_t total = 0;
+		grid.ForEachCell(area, [&](const TestGrid::Cell &cell, int32_t, int32_t)
+		{
+			for (const TestGrid::Entry &entry : cell) expected = std::min(expected, distance(entry.Obj, x, y));
+			total += cell.size();
+		});
+		// Visiting nearest first finds it, and stops early
+		int64_t nearest = INT64_MAX, last_bound = 0;
+		size_t visited = 0;
+		grid.ForEachCellNearestFirst(x, y, area, [&](const TestGrid::Cell &cell, int32_t, int32_t)
+		{
+			for (const TestGrid::Entry &entry : cell) nearest = std::min(nearest, distance(entry.Obj, x, y));
+			visited += cell.size();
+		}, [&](int64_t bound)
+		{
+			EXPECT_GE(bound, last_bound);
+			last_bound = bound;
+			return bound <= nearest;
+		});
+		EXPECT_EQ(expected, nearest);
+		EXPECT_LE(visited, total);
+	}
+}
+
+// Micro-benchmark: moving objects and area searches, compared to the previous
+// layout of one sorted linked list per 50px sector
+TEST(C4SpatialGridBenchmark, MovingObjects)
+{
+	const size_t ObjectCount = 2500;
+	const int Frames = 40, QueriesPerFrame = 500;
+	typedef std::chrono::steady_clock clock;
+
+	std::mt19937 rng(99);
+	const std::vector<TestObject> start_objects = MakeObjects(ObjectCount, rng);
+	std::uniform_int_distribution<int32_t> step(-4, 4), query_x(0, LandscapeWdt), query_y(0, LandscapeHgt);
+	std::vector<C4Rect> queries;
+	for (int i = 0; i < Frames * QueriesPerFrame; ++i)
+		queries.emplace_back(query_x(rng) - 50, query_y(rng) - 50, 100, 100);
+	std::vector<int32_t> steps;
+	for (size_t i = 0; i < Frames * ObjectCount * 2; ++i)
+		steps.push_back(step(rng));
+
+	// Linked lists, sorted by order key on insertion
+	size_t list_found = 0;
+	double list_ms;
+	{
+		std::vector<TestObject> objects = start_objects;
+		TestGrid geometry;
+		geometry.Init(LandscapeWdt, LandscapeHgt, 50);
+		std::vector<std::list<TestObject *>> sectors(geometry.GetOutIndex() + 1);
+		auto insert = [](std::list<TestObject *> &sector, TestObject *obj)
+		{
+			auto it = sector.begin();
+			while (it != sector.end() && (*it)->order < obj->order) ++it;
+			sector.insert(it, obj);
+		};
+		for (TestObject &obj : objects) insert(sectors[geometry.IndexAt(obj.x, obj.y)], &obj);
+		auto start = clock::now();
+		size_t s = 0, q = 0;
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			for (TestObject &obj : objects)
+			{
+				int32_t old_index = geometry.IndexAt(obj.x, obj.y);
+				obj.x += steps[s++]; obj.y += steps[s++];
+				int32_t new_index = geometry.IndexAt(obj.x, obj.y);
+				if (old_index != new_index)
+				{
+					sectors[old_index].remove(&obj);
+					insert(sectors[new_index], &obj);
+				}
+			}
+			for (int i = 0; i < QueriesPerFrame; ++i)
+			{
+				const C4Rect &rect = queries[q++];
+				geometry.ForEachCell(geometry.GetArea(rect), [&sectors, &geometry, &rect, &list_found](const TestGrid::Cell &cell, int32_t, int32_t)
+				{
+					for (TestObject *obj : sectors[&cell - &geometry.GetCell(0)])
+						if (rect.Contains(obj->x, obj->y)) ++list_found;
+				});
+			}
+		}
+		list_ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+	}
+	printf("[ BENCH    ] linked lists, 50px sectors: %.1f ms\n", list_ms);
+
+	for (int32_t cell_size : { 25, 50, 100, 200 })
+	{
+		std::vector<TestObject> objects = start_objects;
+		TestGrid grid;
+		grid.Init(LandscapeWdt, LandscapeHgt, cell_size);
+		for (TestObject &obj : objects) grid.Add(grid.IndexAt(obj.x, obj.y), &obj, obj.order);
+		std::vector<TestObject *> buffer;
+		size_t found = 0;
+		auto start = clock::now();
+		size_t s = 0, q = 0;
+		for (int frame = 0; frame < Frames; ++frame)
+		{
+			for (TestObject &obj : objects)
+			{
+				int32_t old_index = grid.IndexAt(obj.x, obj.y);
+				obj.x += steps[s++]; obj.y += steps[s++];
+				int32_t new_index = grid.IndexAt(obj.x, obj.y);
+				if (old_index != new_index)
+				{
+					grid.Remove(old_index, &obj, obj.order);
+					grid.Add(new_index, &obj, obj.order);
+				}
+			}
+			for (int i = 0; i < QueriesPerFrame; ++i)
+			{
+				const C4Rect &rect = queries[q++];
+				buffer.clear();
+				grid.Collect(grid.GetArea(rect), buffer);
+				for (TestObject *obj : buffer)
+					if (rect.Contains(obj->x, obj->y)) ++found;
+			}
+		}
+		double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+		printf("[ BENCH    ] flat grid, %dpx cells: %.1f ms\n", (int)cell_size, ms);
+		// Same objects found regardless of layout
+		EXPECT_EQ(list_found, found);
+	}
+}
@@ -0,0 +1,234 @@
+/*
+ * OpenClonk, http://www.openclonk.org
+ *
+ * Copyright (c) 2026, The OpenClonk Team and contributors
+ *
+ * Distributed under the terms of the ISC license; see accompanying file
+ * "COPYING" for details.
+ *
+ * "Clonk" is a registered trademark of Matthes Bender, used with permission.
+ * See accompanying file "TRADEMARK" for details.
+ *
+ * To redistribute this file separately, substitute the full license texts
+ * for the above references.
+ */
+
+// Bytecode micro-benchmarks, run with and without superinstructions and inline caches,
+// and proplist memory and lookup times with and without shapes.
+
+#include "C4Include.h"
+#include "AulTest.h"
+
+#include "script/C4Aul.h"
+#include "script/C4AulCompiler.h"
+#include "lib/StdAdaptors.h"
+#include "lib/StdCompiler.h"
+
+#include <algorithm>
+#include <chrono>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace
+{
+	// Bytes currently allocated from the heap, 0 if unknown
+	size_t GetAllocatedBytes()
+	{
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+		return mallinfo2().uordblks;
+#else
+		return 0;
+#endif
+	}
+}
+
+class AulBenchmark : public AulTest
+{
+protected:
+	// Run a script whose Main() loops Iterations times and print the iterations
+	// per second for plain bytecode, with superinstructions, and with inline
+	// caches in addition. All must return the same result.
+	void Measure(const char *name, const std::string &code)
+	{
+		typedef std::chrono::steady_clock clock;
+		std::string script = "static const Iterations = " + std::to_string(Iterations) + ";\n" + code;
+		C4Value results[3];
+		double rates[3];
+		for (int level = 0; level < 3; ++level)
+		{
+			C4AulCompiler::UseSuperinstructions = level >= 1;
+			C4AulCompiler::UseInlineCaches = level >= 2;
+			// best of several runs, to filter out noise
+			rates[level] = 0;
+			for (int run = 0; run < Runs; ++run)
+			{
+				auto start = clock::now();
+				results[level] = RunScript(script);
+				double s = std::chrono::duration<double>(clock::now() - start).count();
+				rates[level] = std::max(rates[level], Iterations / s);
+			}
+		}
+		C4AulCompiler::UseSuperinstructions = C4AulCompiler::UseInlineCaches = true;
+		EXPECT_EQ(results[0], results[1]);
+		EXPECT_EQ(results[0], results[2]);
+		printf("[ BENCH    ] %s: %.0f iterations/s plain, %.0f fused (%+.1f%%), %.0f fused and cached (%+.1f%%)\n", name,
+			rates[0], rates[1], (rates[1] / rates[0] - 1) * 100, rates[2], (rates[2] / rates[0] - 1) * 100);
+	}
+
+	static const int Iterations = 300000, Runs = 3;
+};
+
+TEST_F(AulBenchmark, PropertyAccess)
+{
+	Measure("property access", R"(
+func Main()
+{
+	var p = {x = 1, y = 2}, sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+	{
+		sum += p.x + p.y;
+		p.x = i % 7;
+	}
+	return sum;
+}
+)");
+}
+
+TEST_F(AulBenchmark, IntegerConditions)
+{
+	Measure("integer conditions", R"(
+func Main()
+{
+	var n = 0;
+	for (var i = 0; i < Iterations; ++i)
+	{
+		if (i % 3 == 0) ++n;
+		if (i % 5 != 2) ++n;
+		if (n > 1000) n -= 1000;
+	}
+	return n;
+}
+)");
+}
+
+TEST_F(AulBenchmark, Calls)
+{
+	Measure("calls", R"(
+func Add(a, b, c)
+{
+	return a + b;
+}
+
+static const Getter = {Get = func(a, b) { return a; }};
+
+func Main()
+{
+	var p = Getter, sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum += Add(i % 10, 1) + p->Get(i % 3);
+	return sum;
+}
+)");
+}
+
+TEST_F(AulBenchmark, PrototypeCalls)
+{
+	Measure("prototype calls", R"(
+static const Root = {Get = func() { return this.value; }};
+static const Base = new Root {};
+static const Middle = new Base {};
+static const Derived = new Middle {Scale = func(x) { return x * this->Get(); }};
+
+func Main()
+{
+	var objs = [new Derived {value = 1}, new Derived {value = 2}, new Base {value = 3}], sum = 0;
+	for (var i = 0; i < Iterations; ++i)
+		sum = (sum + objs[i % 2]->Scale(i % 5) + objs[2]->Get()) % 100000;
+	return sum;
+}
+)");
+}
+
+TEST_F(AulBenchmark, Mixed)
+{
+	Measure("mixed", R"(
+func Step(obj)
+{
+	if (obj.speed > 10) obj.speed = 0;
+	obj.x += obj.speed;
+	obj.speed += 1;
+	return obj.x;
+}
+
+func Main()
+{
+	var objs = [], sum = 0;
+	for (var i = 0; i < 10; ++i) objs[i] = {x = i, speed = i};
+	for (var i = 0; i < Iterations / 10; ++i)
+		for (var obj in objs)
+			sum = (sum + Step(obj)) % 100000;
+	return sum;
+}
+)");
+}
+
+TEST_F(AulBenchmark, PropListShapes)
+{
+	// Proplists like the objects of a savegame: a few kinds, each with its own
+	// local variables. Load them from savegame text and read all their locals.
+	static const int Count = 5000, Kinds = 5, Locals = 12, Rounds = 20;
+	typedef std::chrono::steady_clock clock;
+	std::vector<C4RefCntPointer<C4String> > keys;
+	for (int i = 0; i < Kinds * 2 + Locals; ++i)
+		keys.emplace_back(::Strings.RegString(FormatString("Local%d", i).getData()));
+	std::vector<StdStrBuf> savegame;
+	C4PropList::UseShapes = false;
+	for (int i = 0; i < Count; ++i)
+	{
+		C4Value obj = C4VPropList(C4PropList::New());
+		int kind = i % Kinds;
+		for (int j = 0; j < Locals; ++j)
+			obj._getPropList()->SetPropertyByS(keys[kind * 2 + j].Get(), j % 3 ? C4VInt(i + j) : C4VString(keys[j].Get()));
+		C4ValueNumbers numbers;
+		savegame.push_back(DecompileToBuf<StdCompilerINIWrite>(mkNamingAdapt(mkParAdapt(*obj._getPropList(), &numbers), "Object")));
+	}
+	size_t memory[2];
+	double lookup_time[2];
+	int sums[2];
+	for (int shapes = 0; shapes < 2; ++shapes)
+	{
+		C4PropList::UseShapes = !!shapes;
+		size_t shape_count = C4PropListShape::GetCount();
+		size_t before = GetAllocatedBytes();
+		std::vector<C4Value> objs(Count);
+		for (int i = 0; i < Count; ++i)
+		{
+			objs[i] = C4VPropList(C4PropList::New());
+			C4ValueNumbers numbers;
+			CompileFromBuf<StdCompilerINIRead>(mkNamingAdapt(mkParAdapt(*objs[i]._getPropList(), &numbers), "Object"), savegame[i]);
+		}
+		memory[shapes] = GetAllocatedBytes() - before;
+		EXPECT_LE(C4PropListShape::GetCount() - shape_count, size_t(shapes * Kinds * Locals));
+		sums[shapes] = 0;
+		lookup_time[shapes] = 1e30;
+		for (int run = 0; run < 3; ++run)
+		{
+			auto start = clock::now();
+			C4Value v;
+			for (int round = 0; round < Rounds; ++round)
+				for (int i = 0; i < Count; ++i)
+					for (int j = 0; j < Locals; ++j)
+						if (objs[i]._getPropList()->GetPropertyByS(keys[i % Kinds * 2 + j].Get(), &v))
+							sums[shapes] += v.getInt();
+			lookup_time[shapes] = std::min(lookup_time[shapes], std::chrono::duration<double>(clock::now() - start).count());
+		}
+	}
+	C4PropList::UseShapes = true;
+	EXPECT_EQ(sums[0], sums[1]);
+	double lookups = double(Rounds) * Count * Locals;
+	printf("[ BENCH    ] %d proplists: %lu bytes and %.1f ns/lookup with own tables, %lu bytes (%+.1f%%) and %.1f ns/lookup (%+.1f%%) with shapes\n", Count,
+		static_cast<unsigned long>(memory[0]), lookup_time[0] / lookups * 1e9,
+		static_cast<unsigned long>(memory[1]), (double(memory[1]) / memory[0] - 1) * 100,
+		lookup_time[1] / lookups * 1e9, (lookup_time[1] / lookup_time[0] - 1) * 100);
+}
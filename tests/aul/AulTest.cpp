@@ -20,8 +20,11 @@
 #include "AulTest.h"
 #include "ErrorHandler.h"
 
+#include "script/C4AulCompiler.h"
 #include "script/C4ScriptHost.h"
 #include "lib/C4Random.h"
+#include "lib/StdAdaptors.h"
+#include "lib/StdCompiler.h"
 #include "object/C4DefList.h"
 #include "TestLog.h"
 
@@ -285,3 +288,182 @@ TEST_F(AulTest, Conditionals)
 	EXPECT_EQ(C4VInt(1), RunCode("if (true) return 1; else return 2;"));
 	EXPECT_EQ(C4VInt(2), RunCode("if (false) return 1; else return 2;"));
 }
+
+TEST_F(AulTest, Superinstructions)
+{
+	// Fused chunk sequences must behave like the chunks they replace,
+	// including the fallbacks for unexpected operand types
+	auto run_both = [this](const std::string &code)
+	{
+		C4AulCompiler::UseSuperinstructions = false;
+		C4Value plain = RunScript(code);
+		C4AulCompiler::UseSuperinstructions = true;
+		C4Value fused = RunScript(code);
+		EXPECT_EQ(plain, fused) << code;
+		return fused;
+	};
+	EXPECT_EQ(C4VInt(7), run_both("func Main() { var p = {a = 3, b = 4}; return p.a + p.b; }"));
+	EXPECT_EQ(C4VNull, run_both("func Main() { var p = {a = 3}; return p.c; }"));
+	EXPECT_EQ(C4VInt(5), run_both("func Main() { var p = {}; p.a = 5; p.b = p.a; return p.b; }"));
+	EXPECT_EQ(C4VInt(3), run_both("func Main() { var n; for (var i = 0; i < 10; ++i) if (i % 4 == 1) ++n; return n; }"));
+	EXPECT_EQ(C4VInt(4), run_both("func Main() { var n; for (var i = 0; i <= 6; i += 2) if (i != 3) ++n; return n; }"));
+	EXPECT_EQ(C4VInt(2), run_both("func Main() { var n; for (var i = 5; i > 0; --i) if (i >= 4) ++n; return n; }"));
+	// Non-integer left operands take the regular path
+	EXPECT_EQ(C4VInt(1), run_both("func Main() { var x; if (x < 1) return 1; return 2; }"));
+	EXPECT_EQ(C4VInt(2), run_both("func Main() { var x = true; if (x == 1) return 1; return 2; }"));
+	EXPECT_EQ(C4VInt(2), run_both("func Main() { var x = \"a\"; if (x != 0) return 2; return 1; }"));
+	// Calls with omitted parameters
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VNull, C4VNull), run_both(R"(
+func f(a, b, c) { return [a, b, c]; }
+func Main() { return f(1); }
+)"));
+	EXPECT_EQ(C4VArray(C4VInt(2), C4VNull), run_both(R"(
+static const P = {g = func(a, b) { return [a, b]; }};
+func Main() { var p = P; return p->g(2); }
+)"));
+	EXPECT_EQ(C4VNull, run_both("func Main() { var p = {}; return p->~g(2); }"));
+	// Errors are the same, too
+	for (bool fuse : { false, true })
+	{
+		C4AulCompiler::UseSuperinstructions = fuse;
+		EXPECT_THROW(RunCode("var p; return p.a;"), C4AulExecError);
+		EXPECT_THROW(RunCode("var p = 1; p.a = 2; return 1;"), C4AulExecError);
+		EXPECT_THROW(RunCode("var p = {}; p->f(1); return 1;"), C4AulExecError);
+		EXPECT_THROW(RunCode("var x = [1]; if (x < 1) return 1; return 2;"), C4AulExecError);
+	}
+	C4AulCompiler::UseSuperinstructions = true;
+}
+
+TEST_F(AulTest, InlineCaches)
+{
+	// Each access site remembers where it found the property last time,
+	// which must not hide later changes to the receiver or its prototypes
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(2), C4VInt(3), C4VInt(4), C4VNull), RunScript(R"(
+static const Base = {};
+func Get(p) { return p.a; }
+func Main()
+{
+	var proto = new Base {}, obj = new proto {}, r = [];
+	proto.a = 1;
+	r[0] = Get(obj);
+	proto.a = 2;
+	r[1] = Get(obj);
+	obj.a = 3;
+	r[2] = Get(obj);
+	obj = new proto {};
+	obj.Prototype = {a = 4};
+	r[3] = Get(obj);
+	obj.Prototype = nil;
+	r[4] = Get(obj);
+	return r;
+}
+)"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(2), C4VInt(3), C4VInt(1), C4VInt(2), C4VInt(3)), RunScript(R"(
+func Get(p) { return p.a; }
+func Main()
+{
+	var protos = [{a = 1}, {a = 2}, {a = 3}], r = [];
+	for (var i = 0; i < 6; ++i)
+		r[i] = Get(new protos[i % 3] {});
+	return r;
+}
+)"));
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(2), C4VInt(3), C4VNull), RunScript(R"(
+static const One = {f = func() { return 1; }};
+static const Two = {f = func() { return 2; }};
+static const Three = {f = func() { return 3; }};
+func Call(p) { return p->~f(); }
+func Main()
+{
+	var proto = new One {}, obj = new proto {}, r = [];
+	r[0] = Call(obj);
+	proto.Prototype = Two;
+	r[1] = Call(obj);
+	proto.f = Three.f;
+	r[2] = Call(obj);
+	obj.Prototype = nil;
+	r[3] = Call(obj);
+	return r;
+}
+)"));
+}
+
+TEST_F(AulTest, PropListShapes)
+{
+	// Proplists sharing shapes must show their properties in the same order as
+	// ones with a table of their own, to scripts and in savegames
+	const char *script = R"(
+func Main()
+{
+	var r = [], keys = ["x", "y", "Name", "a", "b", "Value", "z", "c"], p;
+	r[0] = {a = 1, b = 2, c = 3};
+	r[1] = {c = 3, b = 2, a = 1};
+	p = {};
+	for (var i = 0; i < 40; ++i) p[Format("k%d", i)] = i;
+	r[2] = p;
+	p = {a = 1, b = 2, c = 3, d = 4};
+	ResetProperty("b", p);
+	p.e = 5;
+	r[3] = p;
+	for (var i = 0; i < 8; ++i)
+	{
+		p = {};
+		for (var j = i; j < i + 3 + i % 5; ++j) p[keys[j % 8]] = j;
+		r[4 + i] = p;
+	}
+	r[12] = new r[0] {z = 3, a = 4};
+	return r;
+}
+)";
+	C4Value results[2];
+	for (int shapes = 0; shapes < 2; ++shapes)
+	{
+		C4PropList::UseShapes = !!shapes;
+		results[shapes] = RunScript(script);
+	}
+	C4PropList::UseShapes = true;
+	C4ValueArray *dictionaries = results[0].getArray(), *shaped = results[1].getArray();
+	ASSERT_TRUE(dictionaries && shaped);
+	ASSERT_EQ(dictionaries->GetSize(), shaped->GetSize());
+	for (int32_t i = 0; i < shaped->GetSize(); ++i)
+	{
+		C4PropList *a = dictionaries->GetItem(i).getPropList(), *b = shaped->GetItem(i).getPropList();
+		ASSERT_TRUE(a && b);
+		EXPECT_EQ(C4VArray(a->GetProperties()), C4VArray(b->GetProperties())) << "proplist " << i;
+		if (a->GetPrototype()) continue;
+		C4ValueNumbers numbers;
+		StdStrBuf text = DecompileToBuf<StdCompilerINIWrite>(mkNamingAdapt(mkParAdapt(*a, &numbers), "PropList"));
+		EXPECT_STREQ(text.getData(), DecompileToBuf<StdCompilerINIWrite>(mkNamingAdapt(mkParAdapt(*b, &numbers), "PropList")).getData());
+		EXPECT_EQ(DecompileToBuf<StdCompilerBinWrite>(mkParAdapt(*a, &numbers)), DecompileToBuf<StdCompilerBinWrite>(mkParAdapt(*b, &numbers)));
+		// Loading must restore the same order, too
+		C4Value loaded[2];
+		for (int shapes = 0; shapes < 2; ++shapes)
+		{
+			C4PropList::UseShapes = !!shapes;
+			loaded[shapes] = C4VPropList(C4PropList::New());
+			CompileFromBuf<StdCompilerINIRead>(mkNamingAdapt(mkParAdapt(*loaded[shapes]._getPropList(), &numbers), "PropList"), text);
+		}
+		C4PropList::UseShapes = true;
+		EXPECT_EQ(*a, *loaded[1]._getPropList());
+		EXPECT_EQ(C4VArray(loaded[0]._getPropList()->GetProperties()), C4VArray(loaded[1]._getPropList()->GetProperties())) << "proplist " << i;
+	}
+
+	// Receivers sharing a shape share inline cache entries, until one gets a property of its own
+	EXPECT_EQ(C4VArray(C4VInt(1), C4VInt(4), C4VInt(1), C4VInt(6), C4VInt(1)), RunScript(R"(
+func Get(p) { return p.a; }
+func Main()
+{
+	var proto = {a = 1}, x = new proto {b = 2}, y = new proto {b = 3}, r = [];
+	r[0] = Get(x);
+	y.a = 4;
+	r[1] = Get(y);
+	r[2] = Get(x);
+	var z = new proto {b = 5};
+	z.a = 6;
+	r[3] = Get(z);
+	ResetProperty("a", z);
+	r[4] = Get(z);
+	return r;
+}
+)"));
+}